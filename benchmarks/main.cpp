@@ -0,0 +1,42 @@
+#include "nuno_bench_harness.hpp"
+#include "nuno_parser_benchmarks.hpp"
+#include "nuno_document_benchmarks.hpp"
+#include "nuno_materialiser_benchmarks.hpp"
+
+#include <iostream>
+
+namespace nuno::benchmarks 
+{
+    std::vector<bench_result> results;    
+    volatile size_t sink = 0;
+}
+
+bool first = true;
+
+void run_benchmarks( std::string suite_name, void(*pf_benchmarks)() )
+{
+    if (!first)
+        std::cout << '\n';
+    else first = false;
+
+    std::cout << suite_name << '\n';
+    std::cout << std::string(suite_name.length(), '=') << '\n';
+    pf_benchmarks();
+}
+
+int main()
+{
+    using namespace nuno::benchmarks;
+
+    #ifdef NUNO_BENCH_PARSER__ 
+        run_benchmarks("Parser", run_parser_benchmarks); 
+    #endif
+
+    #ifdef NUNO_BENCH_DOCUMENT__ 
+        run_benchmarks("Document", run_document_benchmarks); 
+    #endif
+
+    #ifdef NUNO_BENCH_MATERIALISER__ 
+        run_benchmarks("Materialiser", run_materialiser_benchmarks); 
+    #endif
+}
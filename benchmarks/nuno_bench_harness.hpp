@@ -0,0 +1,78 @@
+#ifndef NUNO_BENCH_HARNESS__
+#define NUNO_BENCH_HARNESS__
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace nuno::benchmarks
+{
+
+    struct bench_result
+    {
+        std::string name;
+        double      millis;
+    };
+
+    extern std::vector<bench_result> results;
+
+    // Defeats dead-code elimination of benchmarked work
+    extern volatile size_t sink;
+
+    template<typename F>
+    double time_millis(F && fn)
+    {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::milli>(end - start).count();
+    }
+
+    // Resident set size of the process in bytes; 0 where unsupported
+    inline size_t resident_bytes()
+    {
+    #if defined(__linux__)
+        std::ifstream statm("/proc/self/statm");
+        size_t pages = 0, resident = 0;
+        if (statm >> pages >> resident)
+            return resident * 4096;
+    #endif
+        return 0;
+    }
+
+    // A benchmark is a function returning its measured time in
+    // milliseconds. Setup work is expected to happen outside the
+    // timed region.
+    #define RUN_BENCH(fn)                                  \
+        do                                                 \
+        {                                                  \
+            double ms = fn();                              \
+            results.push_back({ #fn, ms });                \
+            std::cout << "[bench] " << std::left           \
+                      << std::setw(48) << #fn              \
+                      << std::right << std::fixed          \
+                      << std::setprecision(3)              \
+                      << std::setw(12) << ms << " ms\n";   \
+        } while (0)
+
+    #define BENCH_NOTE(msg)                                \
+        do                                                 \
+        {                                                  \
+            std::cout << "        " << msg << '\n';        \
+        } while (0)
+
+    #define BENCH_SUBCAT(msg)                                               \
+        do                                                                  \
+        {                                                                   \
+            std::string str(msg);                                           \
+            std::transform(str.begin(), str.end(), str.begin(), ::toupper); \
+            std::cout << "-------" << str << "--------------\n";            \
+        }                                                                   \
+        while (0)
+}
+
+#endif
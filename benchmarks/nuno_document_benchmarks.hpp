@@ -0,0 +1,667 @@
+#ifndef NUNO_BENCH_DOCUMENT__
+#define NUNO_BENCH_DOCUMENT__
+
+#include "nuno_bench_harness.hpp"
+#include "../include/nuno.hpp"
+#include "../include/nuno_query.hpp"
+#include "../include/nuno_editor.hpp"
+#include "../include/nuno_serializer.hpp"
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+
+namespace nuno::benchmarks
+{
+//------------------------------------------
+// FIXTURES
+//------------------------------------------
+
+    // Generates a document of `categories` top-level categories, each
+    // owning a single table of `rows_per_table` rows.
+    inline std::string make_table_document(size_t categories, size_t rows_per_table)
+    {
+        std::string src;
+        src.reserve(categories * rows_per_table * 32);
+
+        for (size_t c = 0; c < categories; ++c)
+        {
+            src += "cat" + std::to_string(c) + ":\n";
+            src += "  # name  value:int  weight:float\n";
+            for (size_t r = 0; r < rows_per_table; ++r)
+            {
+                src += "    item" + std::to_string(r);
+                src += "  " + std::to_string(r * 7);
+                src += "  " + std::to_string(r) + ".5\n";
+            }
+            src += "/\n";
+        }
+
+        return src;
+    }
+
+//------------------------------------------
+// ID RESOLUTION
+//------------------------------------------
+
+    // Resolves every row by ID and walks to its owning category and
+    // table; 100k rows across 1000 tables.
+    inline double resolve_row_owner_and_table_100k()
+    {
+        auto ctx = load(make_table_document(1000, 100));
+        auto & doc = ctx.document;
+
+        return time_millis([&]
+        {
+            size_t acc = 0;
+            for (auto const & tbl : doc.tables())
+            {
+                for (auto rid : tbl.rows())
+                {
+                    auto row = doc.row(rid);
+                    acc += row->owner().id().val;
+                    acc += row->table().id().val;
+                }
+            }
+            sink = acc;
+        });
+    }
+
+    // Resolves key, category and column views by ID in a document
+    // with many entities of each kind.
+    inline double resolve_entities_by_id()
+    {
+        std::string src;
+        for (size_t c = 0; c < 2000; ++c)
+        {
+            src += "cat" + std::to_string(c) + ":\n";
+            for (size_t k = 0; k < 10; ++k)
+                src += "  key" + std::to_string(k) + " = " + std::to_string(k) + "\n";
+            src += "  # a  b  c\n";
+            src += "    1  2  3\n";
+            src += "/\n";
+        }
+
+        auto ctx = load(src);
+        auto & doc = ctx.document;
+
+        return time_millis([&]
+        {
+            size_t acc = 0;
+            for (auto const & cat : doc.categories())
+            {
+                for (auto kid : cat.keys())
+                    acc += doc.key(kid)->owner().id().val;
+
+                for (auto tid : cat.tables())
+                    for (auto cid : doc.table(tid)->columns())
+                        acc += doc.column(cid)->index();
+            }
+            sink = acc;
+        });
+    }
+
+//------------------------------------------
+// NAME LOOKUP
+//------------------------------------------
+
+    // 2000 tables sharing the same 40 column names
+    inline std::string const & wide_tables_2k()
+    {
+        static const std::string src = []
+        {
+            std::string src;
+            for (size_t c = 0; c < 2000; ++c)
+            {
+                src += "cat" + std::to_string(c) + ":\n";
+                src += "  #";
+                for (size_t k = 0; k < 40; ++k)
+                    src += "  column_name_" + std::to_string(k);
+                src += "\n   ";
+                for (size_t k = 0; k < 40; ++k)
+                    src += "  " + std::to_string(k);
+                src += "\n/cat" + std::to_string(c) + "\n";
+            }
+            return src;
+        }();
+        return src;
+    }
+
+    // Resolves every column of every table by its name
+    inline double column_lookup_by_name_2k_tables()
+    {
+        auto ctx = load(wide_tables_2k());
+        auto & doc = ctx.document;
+
+        std::vector<std::string> names;
+        for (size_t k = 0; k < 40; ++k)
+            names.push_back("column_name_" + std::to_string(k));
+
+        return time_millis([&]
+        {
+            size_t acc = 0;
+            for (auto const & tbl : doc.tables())
+                for (auto const & name : names)
+                    acc += *tbl.column_index(name);
+            sink = acc;
+        });
+    }
+
+    // The same lookups with the names interned up front
+    inline double column_lookup_by_symbol_2k_tables()
+    {
+        auto ctx = load(wide_tables_2k());
+        auto & doc = ctx.document;
+
+        std::vector<symbol> names;
+        for (size_t k = 0; k < 40; ++k)
+            names.push_back(*doc.find_symbol("column_name_" + std::to_string(k)));
+
+        return time_millis([&]
+        {
+            size_t acc = 0;
+            for (auto const & tbl : doc.tables())
+                for (auto name : names)
+                    acc += *tbl.column_index(name);
+            sink = acc;
+        });
+    }
+
+    // Resolves category.key paths through 2000 categories
+    inline double dotpath_resolution_2k_categories()
+    {
+        std::string src;
+        for (size_t c = 0; c < 2000; ++c)
+            src += "cat" + std::to_string(c) + ":\n  key = " + std::to_string(c) + "\n/cat" + std::to_string(c) + "\n";
+
+        auto ctx = load(src);
+        auto & doc = ctx.document;
+
+        std::vector<std::string> names;
+        for (size_t c = 0; c < 2000; ++c)
+            names.push_back("cat" + std::to_string(c));
+
+        return time_millis([&]
+        {
+            size_t acc = 0;
+            for (size_t rep = 0; rep < 10; ++rep)
+                for (auto const & name : names)
+                    acc += doc.root()->child(name)->key("key")->id().val;
+            sink = acc;
+        });
+    }
+
+    inline std::string const & table_200k_rows()
+    {
+        static const std::string src = make_table_document(1, 200'000);
+        return src;
+    }
+
+    // Enumerates every row of a 200k-row table with its ordinal
+    inline double row_ordinals_200k()
+    {
+        auto ctx = load(table_200k_rows());
+        auto tbl = ctx.document.tables().front();
+
+        return time_millis([&]
+        {
+            size_t acc = 0;
+            for (auto r : tbl.row_views())
+                acc += r.index();
+            sink = acc;
+        });
+    }
+
+    // Resolves 1000 rows by name in a 200k-row table through queries
+    inline double query_row_by_name_200k()
+    {
+        auto ctx = load(table_200k_rows());
+        auto & doc = ctx.document;
+
+        std::vector<std::string> names;
+        for (size_t r = 0; r < 200'000; r += 200)
+            names.push_back("item" + std::to_string(r));
+
+        return time_millis([&]
+        {
+            size_t acc = 0;
+            for (auto const & name : names)
+                acc += query(doc, "cat0").table(0).row(name).locations().size();
+            sink = acc;
+        });
+    }
+
+//------------------------------------------
+// TABLE STORAGE
+//------------------------------------------
+
+    inline std::string const & table_1m_rows()
+    {
+        static const std::string src = make_table_document(1, 1'000'000);
+        return src;
+    }
+
+    // Materialises a 1M-cell table and reports the resident memory
+    // held by the document, without the parser data
+    inline double load_1m_cells()
+    {
+        static const std::string src = make_table_document(1, 333'334);
+
+        size_t before = resident_bytes();
+        doc_context ctx;
+        double ms = time_millis([&]
+        {
+            ctx = load(src, materialiser_options{ .own_parser_data = false });
+        });
+        size_t after = resident_bytes();
+
+        std::ostringstream note;
+        note << "RSS +" << (after - before) / (1u << 20) << " MB, "
+             << sizeof(typed_value) << " B per typed_value";
+        BENCH_NOTE(note.str());
+        return ms;
+    }
+
+    // Imports 1M rows of four typed columns into an empty table, one
+    // append_row call per row or one append_rows call, optionally into
+    // a columnar table
+    inline double import_1m_rows(bool bulk, table_layout layout = table_layout::rows)
+    {
+        auto doc = create_document();
+        editor ed(doc);
+        auto tid = ed.append_table(doc.root()->id(), std::vector<std::pair<std::string, std::optional<value_type>>>
+        {
+            { "id", value_type::integer }, { "name", value_type::string },
+            { "price", value_type::floating_point }, { "stock", value_type::integer }
+        });
+        ed.set_table_layout(tid, layout);
+
+        std::vector<std::vector<value>> rows(1'000'000);
+        for (size_t r = 0; r < rows.size(); ++r)
+            rows[r] = { int64_t(r), std::string("item ") + std::to_string(r % 1000), double(r % 97) + 0.99, int64_t(r % 13) };
+
+        double ms = time_millis([&]
+        {
+            if (bulk)
+                ed.append_rows(tid, rows);
+            else
+                for (auto & row : rows)
+                    ed.append_row(tid, std::move(row));
+        });
+
+        sink = doc.row_count();
+        return ms;
+    }
+
+    inline double import_1m_rows_one_by_one() { return import_1m_rows(false); }
+    inline double import_1m_rows_bulk()       { return import_1m_rows(true); }
+    inline double import_1m_rows_bulk_columnar() { return import_1m_rows(true, table_layout::columnar); }
+
+    // Erases every tenth row of a 500k-row table, then compacts
+    inline double erase_50k_of_500k_rows()
+    {
+        auto doc = create_document();
+        editor ed(doc);
+        auto tid = ed.append_table(doc.root()->id(), std::vector<std::string>{ "name", "value" });
+
+        std::vector<std::vector<value>> rows(500'000);
+        for (size_t r = 0; r < rows.size(); ++r)
+            rows[r] = { std::string("row ") + std::to_string(r), int64_t(r) };
+        auto first = ed.append_rows(tid, rows);
+
+        double compact_ms = 0;
+        double ms = time_millis([&]
+        {
+            for (size_t r = 0; r < rows.size(); r += 10)
+                ed.erase_row(row_id{first.val + r});
+            compact_ms = time_millis([&] { doc.compact(); });
+        });
+
+        std::ostringstream note;
+        note << compact_ms << " ms of it compacting";
+        BENCH_NOTE(note.str());
+
+        sink = doc.row_count();
+        return ms;
+    }
+
+    // Sums the integer column of a 1M-row table through row views
+    inline double sum_column_row_layout_1m()
+    {
+        auto ctx = load(table_1m_rows());
+        auto tbl = ctx.document.tables().front();
+
+        return time_millis([&]
+        {
+            int64_t acc = 0;
+            for (auto rid : tbl.rows())
+                if (auto const * v = std::get_if<int64_t>(&ctx.document.row(rid)->cells()[1].val))
+                    acc += *v;
+            sink = static_cast<size_t>(acc);
+        });
+    }
+
+    // The same sum over the packed column of a columnar table
+    inline double sum_column_columnar_1m()
+    {
+        auto ctx = load(table_1m_rows(), materialiser_options{ .columnar_min_rows = 1 });
+        auto tbl = ctx.document.tables().front();
+
+        return time_millis([&]
+        {
+            auto const & col = tbl.column_storage()->columns[1];
+            auto values = col.integers();
+
+            // Exception rows hold a zero placeholder
+            int64_t acc = 0;
+            for (auto v : values)
+                acc += v;
+            sink = static_cast<size_t>(acc);
+        });
+    }
+
+//------------------------------------------
+// VIEW ITERATION
+//------------------------------------------
+
+    // Counts the cells of a 1M-row document through the
+    // vector-returning rows() accessor
+    inline double iterate_rows_vector_1m()
+    {
+        auto ctx = load(table_1m_rows());
+
+        return time_millis([&]
+        {
+            size_t acc = 0;
+            for (auto const & r : ctx.document.rows())
+                acc += r.cells().size();
+            sink = acc;
+        });
+    }
+
+    // The same count through the allocation-free rows_range()
+    inline double iterate_rows_range_1m()
+    {
+        auto ctx = load(table_1m_rows());
+
+        return time_millis([&]
+        {
+            size_t acc = 0;
+            for (auto r : ctx.document.rows_range())
+                acc += r.cells().size();
+            sink = acc;
+        });
+    }
+
+    // Row views of one table, resolved from its row ID list
+    inline double iterate_table_row_views_1m()
+    {
+        auto ctx = load(table_1m_rows());
+        auto tbl = ctx.document.tables().front();
+
+        return time_millis([&]
+        {
+            size_t acc = 0;
+            for (auto r : tbl.row_views())
+                acc += r.cells().size();
+            sink = acc;
+        });
+    }
+
+//------------------------------------------
+// CONTAMINATION
+//------------------------------------------
+
+    // Fixes 10k contaminated rows one by one in a nested table; each
+    // fix clears a source and re-evaluates the ancestors
+    inline double clear_10k_contaminated_rows()
+    {
+        std::string src = "outer:\n    :inner\n        # name  value:int\n";
+        for (size_t r = 0; r < 10'000; ++r)
+            src += "          item" + std::to_string(r) + "  x\n";
+        src += "/outer\n";
+
+        auto ctx = load(src);
+        auto & doc = ctx.document;
+        editor ed(doc);
+
+        auto tbl  = doc.tables().front();
+        auto col  = tbl.columns()[1];
+        std::vector<row_id> rows(tbl.rows().begin(), tbl.rows().end());
+
+        double ms = time_millis([&]
+        {
+            for (auto rid : rows)
+                ed.set_cell_value(rid, col, int64_t(1));
+        });
+
+        sink = doc.has_contamination_sources();
+        return ms;
+    }
+
+    // 500k cell edits that alternately break and fix the rows of a
+    // table nested six categories deep
+    inline double edit_500k_cells(bool batched)
+    {
+        std::string src = "c0:\n";
+        for (int d = 1; d < 6; ++d)
+            src += std::string(d * 4, ' ') + ":c" + std::to_string(d) + "\n";
+        src += std::string(24, ' ') + "# name  value:int\n";
+        for (size_t r = 0; r < 1'000; ++r)
+            src += std::string(26, ' ') + "item" + std::to_string(r) + "  1\n";
+        src += "/c0\n";
+
+        auto ctx = load(src);
+        auto & doc = ctx.document;
+        editor ed(doc);
+
+        auto tbl = doc.tables().front();
+        auto col = tbl.columns()[1];
+        std::vector<row_id> rows(tbl.rows().begin(), tbl.rows().end());
+
+        double ms = time_millis([&]
+        {
+            std::optional<editor::batch> b;
+            if (batched)
+                b.emplace(ed.begin_batch());
+
+            for (size_t i = 0; i < 500'000; ++i)
+            {
+                if ((i / rows.size()) % 2) ed.set_cell_value(rows[i % rows.size()], col, int64_t(1));
+                else                       ed.set_cell_value(rows[i % rows.size()], col, std::string("x"));
+            }
+        });
+
+        sink = doc.has_contamination_sources();
+        return ms;
+    }
+
+    inline double edit_500k_cells_unbatched() { return edit_500k_cells(false); }
+    inline double edit_500k_cells_batched()   { return edit_500k_cells(true); }
+
+//------------------------------------------
+// HISTORY
+//------------------------------------------
+
+    // Undoes, then redoes, 10k journalled cell edits of a 200k-row
+    // table; each step restores one row, not the table
+    inline double undo_10k_cell_edits_200k_rows()
+    {
+        auto doc = create_document();
+        editor ed(doc);
+        auto tid = ed.append_table(doc.root()->id(), std::vector<std::pair<std::string, std::optional<value_type>>>{
+            { "name", std::nullopt }, { "value", value_type::integer } });
+
+        std::vector<std::vector<value>> rows(200'000);
+        for (size_t r = 0; r < rows.size(); ++r)
+            rows[r] = { std::string("row ") + std::to_string(r), int64_t(r) };
+        auto first = ed.append_rows(tid, rows);
+        auto col = doc.table(tid)->columns()[1];
+
+        ed.enable_history();
+        double edit_ms = time_millis([&]
+        {
+            for (size_t i = 0; i < 10'000; ++i)
+                ed.set_cell_value(row_id{first.val + i * 20}, col, i % 2 ? value{int64_t(1)} : value{std::string("x")});
+        });
+
+        double ms = time_millis([&] { while (ed.undo()) {} });
+        double redo_ms = time_millis([&] { while (ed.redo()) {} });
+
+        std::ostringstream note;
+        note << "editing " << edit_ms << " ms, redoing " << redo_ms << " ms";
+        BENCH_NOTE(note.str());
+
+        sink = doc.has_contamination_sources();
+        return ms;
+    }
+
+//------------------------------------------
+// Serialization
+//------------------------------------------
+
+    // Times a save over a buffer allocated up front, so the timing is
+    // of the serializer rather than of the stream growing
+    inline double time_save(document const & doc, bool verbatim)
+    {
+        serializer_options opts;
+        opts.verbatim_regions = verbatim;
+        std::ostringstream out(std::string(32u << 20, ' '));
+
+        double ms = time_millis([&] { serializer(doc, opts).write(out); });
+        sink = static_cast<size_t>(out.tellp());
+        return ms;
+    }
+
+    // Saves a 30 MB document as loaded; it is copied in one write
+    inline double save_30mb_unedited()
+    {
+        auto ctx = load(make_table_document(500, 2'500));
+
+        double by_line_ms = time_save(ctx.document, false);
+        double ms = time_save(ctx.document, true);
+
+        std::ostringstream note;
+        note << "line by line " << by_line_ms << " ms";
+        BENCH_NOTE(note.str());
+
+        return ms;
+    }
+
+    // Saves a 30 MB document after editing a single cell; only the
+    // edited table is regenerated, the rest is copied from source
+    inline double save_30mb_after_one_edit()
+    {
+        auto ctx = load(make_table_document(500, 2'500));
+        auto & doc = ctx.document;
+        editor ed(doc);
+
+        auto tbl = doc.tables()[250];
+        ed.set_cell_value(tbl.rows()[1'000], tbl.columns()[1], int64_t(42));
+
+        double by_line_ms = time_save(doc, false);
+        double ms = time_save(doc, true);
+
+        std::ostringstream note;
+        note << "line by line " << by_line_ms << " ms";
+        BENCH_NOTE(note.str());
+
+        return ms;
+    }
+
+    // Serializes a generated table of 1M rows, which has no source to
+    // copy and is written value by value
+    inline double serialize_1m_generated_rows()
+    {
+        auto doc = create_document();
+        editor ed(doc);
+        auto tid = ed.append_table(doc.root()->id(), std::vector<std::pair<std::string, std::optional<value_type>>>{
+            { "name", std::nullopt }, { "value", value_type::integer }, { "weight", value_type::floating_point } });
+
+        std::vector<std::vector<value>> rows(1'000'000);
+        for (size_t r = 0; r < rows.size(); ++r)
+            rows[r] = { std::string("item") + std::to_string(r), int64_t(r * 7), double(r) / 16 };
+        ed.append_rows(tid, rows);
+
+        std::string text;
+        double ms = time_millis([&] { text = serialize_to_string(doc); });
+        sink = text.size();
+
+        double stream_ms = time_millis([&]
+        {
+            std::ostringstream out;
+            serializer(doc).write(out);
+            sink = static_cast<size_t>(out.tellp());
+        });
+
+        std::ostringstream note;
+        note << text.size() / (1u << 20) << " MB, " << text.size() / 1e6 / (ms / 1e3) << " MB/s; to a stream " << stream_ms << " ms";
+        BENCH_NOTE(note.str());
+
+        return ms;
+    }
+
+    // Serializes 20k generated keys of one category, each of which
+    // infers its indentation from its siblings
+    inline double serialize_20k_generated_keys()
+    {
+        auto doc = create_document();
+        editor ed(doc);
+        auto cat = ed.append_category(doc.root()->id(), "settings");
+        for (int64_t i = 0; i < 20'000; ++i)
+            ed.append_key(cat, "key" + std::to_string(i), i);
+
+        std::string text;
+        double ms = time_millis([&] { text = serialize_to_string(doc); });
+        sink = text.size();
+        return ms;
+    }
+
+//------------------------------------------
+// Runner
+//------------------------------------------
+
+    inline void run_document_benchmarks()
+    {
+        BENCH_SUBCAT("ID resolution");
+        RUN_BENCH(resolve_row_owner_and_table_100k);
+        RUN_BENCH(resolve_entities_by_id);
+
+        BENCH_SUBCAT("Name lookup");
+        RUN_BENCH(column_lookup_by_name_2k_tables);
+        RUN_BENCH(column_lookup_by_symbol_2k_tables);
+        RUN_BENCH(dotpath_resolution_2k_categories);
+        RUN_BENCH(row_ordinals_200k);
+        RUN_BENCH(query_row_by_name_200k);
+
+        BENCH_SUBCAT("Table storage");
+        RUN_BENCH(load_1m_cells);
+        RUN_BENCH(sum_column_row_layout_1m);
+        RUN_BENCH(sum_column_columnar_1m);
+        RUN_BENCH(import_1m_rows_one_by_one);
+        RUN_BENCH(import_1m_rows_bulk);
+        RUN_BENCH(import_1m_rows_bulk_columnar);
+        RUN_BENCH(erase_50k_of_500k_rows);
+
+        BENCH_SUBCAT("Contamination");
+        RUN_BENCH(clear_10k_contaminated_rows);
+        RUN_BENCH(edit_500k_cells_unbatched);
+        RUN_BENCH(edit_500k_cells_batched);
+
+        BENCH_SUBCAT("History");
+        RUN_BENCH(undo_10k_cell_edits_200k_rows);
+
+        BENCH_SUBCAT("Serialization");
+        RUN_BENCH(save_30mb_unedited);
+        RUN_BENCH(save_30mb_after_one_edit);
+        RUN_BENCH(serialize_1m_generated_rows);
+        RUN_BENCH(serialize_20k_generated_keys);
+
+        BENCH_SUBCAT("View iteration");
+        RUN_BENCH(iterate_rows_vector_1m);
+        RUN_BENCH(iterate_rows_range_1m);
+        RUN_BENCH(iterate_table_row_views_1m);
+    }
+}
+
+#endif
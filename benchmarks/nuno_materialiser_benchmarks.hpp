@@ -0,0 +1,175 @@
+#ifndef NUNO_BENCH_MATERIALISER__
+#define NUNO_BENCH_MATERIALISER__
+
+#include "nuno_bench_harness.hpp"
+#include "../include/nuno.hpp"
+
+#include <cstdlib>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace nuno::benchmarks
+{
+//------------------------------------------
+// FIXTURES
+//------------------------------------------
+
+    // A million literals as they appear in numeric-heavy tables: mostly
+    // integers and reals, with some booleans and words. The literals are
+    // views into one buffer, without NUL terminators between them.
+    struct literal_set
+    {
+        std::string text;
+        std::vector<std::string_view> literals;
+    };
+
+    inline literal_set const & mixed_literals_1m()
+    {
+        static const literal_set set = []
+        {
+            literal_set s;
+            std::vector<std::pair<size_t, size_t>> spans;
+
+            for (size_t i = 0; i < 1'000'000; ++i)
+            {
+                size_t begin = s.text.size();
+                switch (i % 8)
+                {
+                    case 0: case 1: case 2: s.text += std::to_string(i * 7919 % 100000); break;
+                    case 3: s.text += "-" + std::to_string(i % 977); break;
+                    case 4: case 5: s.text += std::to_string(i % 1000) + "." + std::to_string(i % 97); break;
+                    case 6: s.text += (i % 16 < 8) ? "true" : "false"; break;
+                    case 7: s.text += "item" + std::to_string(i % 100); break;
+                }
+                spans.emplace_back(begin, s.text.size() - begin);
+            }
+
+            for (auto [b, n] : spans)
+                s.literals.push_back(std::string_view(s.text).substr(b, n));
+            return s;
+        }();
+        return set;
+    }
+
+    // A CST of about `events` events: categories of keys, a comment and
+    // a table of numeric rows, in the proportions of a typical export
+    inline parse_context const & mixed_cst(size_t events)
+    {
+        static std::unordered_map<size_t, parse_context> cache;
+
+        auto [it, inserted] = cache.try_emplace(events);
+        if (!inserted)
+            return it->second;
+
+        std::string src;
+        size_t n = 0;
+        for (size_t c = 0; n < events; ++c)
+        {
+            src += "// Category " + std::to_string(c) + "\n";
+            src += "cat" + std::to_string(c) + ":\n";
+            src += "    name = entry " + std::to_string(c) + "\n";
+            src += "    count:int = " + std::to_string(c) + "\n";
+            src += "    ratio = 0." + std::to_string(c % 100) + "\n";
+            src += "    # id:int  label  price:float  stock:int\n";
+            for (size_t r = 0; r < 32; ++r)
+                src += "      " + std::to_string(r) + "  item  " + std::to_string(r % 97) + ".5  " + std::to_string(r % 13) + "\n";
+            src += "/\n";
+            n += 38;
+        }
+
+        it->second = parse(std::move(src));
+        return it->second;
+    }
+
+    inline double materialise_events(size_t events)
+    {
+        auto const & cst = mixed_cst(events);
+
+        double ms = time_millis([&]
+        {
+            auto doc = materialise(cst);
+            sink = doc.document.row_count();
+        });
+
+        std::ostringstream note;
+        note << cst.document.events.size() << " events, " 
+             << ms * 1e6 / static_cast<double>(cst.document.events.size()) << " ns/event";
+        BENCH_NOTE(note.str());
+        return ms;
+    }
+
+    inline double materialise_1k_events()   { return materialise_events(1'000); }
+    inline double materialise_10k_events()  { return materialise_events(10'000); }
+    inline double materialise_100k_events() { return materialise_events(100'000); }
+    inline double materialise_1m_events()   { return materialise_events(1'000'000); }
+
+//------------------------------------------
+// LITERAL CLASSIFICATION
+//------------------------------------------
+
+    inline double classify_1m_literals()
+    {
+        auto const & set = mixed_literals_1m();
+
+        return time_millis([&]
+        {
+            size_t acc = 0;
+            for (auto lit : set.literals)
+                acc += static_cast<size_t>(classify_literal(lit).kind);
+            sink = acc;
+        });
+    }
+
+    // The map lookup and strtol/strtod on a terminated copy that the
+    // materialiser used before the literal classifier, for reference
+    inline double strtol_strtod_1m_literals()
+    {
+        auto const & set = mixed_literals_1m();
+        static const std::unordered_map<std::string_view, bool> booleans = { {"true", true}, {"false", false} };
+
+        return time_millis([&]
+        {
+            size_t acc = 0;
+            for (auto lit : set.literals)
+            {
+                if (booleans.find(lit) != booleans.end())
+                {
+                    acc += 0;
+                    continue;
+                }
+
+                const std::string copy(lit);
+                char * end = nullptr;
+                std::strtol(copy.c_str(), &end, 10);
+                if (end == copy.c_str() + copy.size())
+                {
+                    acc += 1;
+                    continue;
+                }
+
+                std::strtod(copy.c_str(), &end);
+                acc += (end == copy.c_str() + copy.size()) ? 2 : 3;
+            }
+            sink = acc;
+        });
+    }
+
+//------------------------------------------
+
+    inline void run_materialiser_benchmarks()
+    {
+        BENCH_SUBCAT("Materialisation scaling");
+        RUN_BENCH(materialise_1k_events);
+        RUN_BENCH(materialise_10k_events);
+        RUN_BENCH(materialise_100k_events);
+        RUN_BENCH(materialise_1m_events);
+
+        BENCH_SUBCAT("Literal classification");
+        RUN_BENCH(classify_1m_literals);
+        RUN_BENCH(strtol_strtod_1m_literals);
+    }
+}
+
+#endif
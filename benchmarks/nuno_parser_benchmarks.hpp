@@ -0,0 +1,231 @@
+#ifndef NUNO_BENCH_PARSER__
+#define NUNO_BENCH_PARSER__
+
+#include "nuno_bench_harness.hpp"
+#include "../include/nuno_parser.hpp"
+#include "../include/nuno_scanner.hpp"
+
+#include <sstream>
+#include <string>
+
+namespace nuno::benchmarks
+{
+//------------------------------------------
+// FIXTURES
+//------------------------------------------
+
+    // Generates roughly `bytes` of representative source: comments,
+    // typed and tacit keys, and tables with mixed cell types.
+    inline std::string make_mixed_document(size_t bytes)
+    {
+        std::string src;
+        src.reserve(bytes + 4096);
+
+        for (size_t c = 0; src.size() < bytes; ++c)
+        {
+            src += "// Section " + std::to_string(c) + "\n";
+            src += "section" + std::to_string(c) + ":\n";
+            src += "    name = entry number " + std::to_string(c) + "\n";
+            src += "    weight:float = " + std::to_string(c) + ".25\n";
+            src += "    tags:str[] = alpha|beta|gamma\n";
+            src += "    :details\n";
+            src += "        # id:int  label  ratio:float  flags:str[]\n";
+            for (size_t r = 0; r < 32; ++r)
+            {
+                src += "          " + std::to_string(r);
+                src += "  item " + std::to_string(r);
+                src += "  0." + std::to_string(r);
+                src += "  a|b\n";
+            }
+            src += "    /\n";
+            src += "\n";
+            src += "/\n";
+        }
+
+        return src;
+    }
+
+    // A single wide table of `rows` item rows
+    inline std::string make_item_table(size_t rows)
+    {
+        std::string src;
+        src.reserve(rows * 64);
+
+        src += "items:\n";
+        src += "    # id:int  name  category  price:float  stock:int  tags:str[]\n";
+        for (size_t r = 0; r < rows; ++r)
+        {
+            src += "      " + std::to_string(r);
+            src += "  Item number " + std::to_string(r % 1000);
+            src += "  misc  " + std::to_string(r % 97) + ".99";
+            src += "  " + std::to_string(r % 13);
+            src += "  red|green\n";
+        }
+        src += "/\n";
+
+        return src;
+    }
+
+    inline double gb_per_second(size_t bytes, double ms)
+    {
+        return (static_cast<double>(bytes) / 1e9) / (ms / 1e3);
+    }
+
+    inline std::string const & mixed_100mb()
+    {
+        static const std::string src = make_mixed_document(100u << 20);
+        return src;
+    }
+
+//------------------------------------------
+// LINE SCANNING
+//------------------------------------------
+
+    // The structural scanner alone over 100 MB
+    inline double structural_scan_100mb()
+    {
+        auto const & src = mixed_100mb();
+
+        double ms = time_millis([&]
+        {
+            detail::structural_scanner scanner(src);
+            std::vector<detail::line_info> lines;
+            size_t acc = 0;
+            while (scanner.next_batch(lines))
+                for (auto const & li : lines)
+                    acc += li.first + li.equals;
+            sink = acc;
+        });
+
+        std::ostringstream note;
+        note << gb_per_second(src.size(), ms) << " GB/s";
+        BENCH_NOTE(note.str());
+        return ms;
+    }
+
+    // The equivalent per-line find/trim/starts_with pass the parser
+    // used before the structural scanner, for reference
+    inline double per_line_find_scan_100mb()
+    {
+        auto const & src = mixed_100mb();
+        std::string_view input = src;
+
+        double ms = time_millis([&]
+        {
+            size_t acc = 0;
+            size_t start = 0;
+            while (start < input.size())
+            {
+                size_t end = input.find('\n', start);
+                auto line = input.substr(start, end == std::string_view::npos ? std::string_view::npos : end - start);
+                if (!line.empty() && line.back() == '\r')
+                    line.remove_suffix(1);
+
+                auto trimmed = detail::trim_sv(line);
+                acc += trimmed.starts_with("//") + trimmed.starts_with(":") + trimmed.starts_with("/")
+                     + trimmed.ends_with(":") + trimmed.starts_with("#");
+                acc += trimmed.find('=') + line.find(':');
+
+                if (end == std::string_view::npos)
+                    break;
+                start = end + 1;
+            }
+            sink = acc;
+        });
+
+        std::ostringstream note;
+        note << gb_per_second(src.size(), ms) << " GB/s";
+        BENCH_NOTE(note.str());
+        return ms;
+    }
+
+//------------------------------------------
+// PARSING
+//------------------------------------------
+
+    inline double parse_100mb()
+    {
+        auto const & src = mixed_100mb();
+
+        double ms = time_millis([&]
+        {
+            auto ctx = parse(std::string_view(src), { .borrow_source = true });
+            sink = ctx.document.events.size();
+        });
+
+        std::ostringstream note;
+        note << gb_per_second(src.size(), ms) << " GB/s";
+        BENCH_NOTE(note.str());
+        return ms;
+    }
+
+    inline double parallel_parse_100mb()
+    {
+        auto const & src = mixed_100mb();
+
+        double ms = time_millis([&]
+        {
+            auto ctx = parallel_parse(std::string_view(src), { .borrow_source = true });
+            sink = ctx.document.events.size();
+        });
+
+        std::ostringstream note;
+        note << gb_per_second(src.size(), ms) << " GB/s on " << std::thread::hardware_concurrency() << " threads";
+        BENCH_NOTE(note.str());
+        return ms;
+    }
+
+    // The same input reported to a handler, without building a CST
+    inline double handler_scan_100mb()
+    {
+        auto const & src = mixed_100mb();
+
+        struct counting_handler : parse_handler
+        {
+            size_t keys = 0, cells = 0;
+            void on_key(std::string_view, std::optional<std::string_view>, std::string_view) override { ++keys; }
+            void on_row(std::span<const std::string_view> row) override { cells += row.size(); }
+        };
+
+        double ms = time_millis([&]
+        {
+            counting_handler h;
+            parse(std::string_view(src), h);
+            sink = h.keys + h.cells;
+        });
+
+        std::ostringstream note;
+        note << gb_per_second(src.size(), ms) << " GB/s";
+        BENCH_NOTE(note.str());
+        return ms;
+    }
+
+    // Parses a 1M-row item table; dominated by cell splitting
+    inline double parse_1m_row_table()
+    {
+        static const std::string src = make_item_table(1'000'000);
+
+        return time_millis([&]
+        {
+            auto ctx = parse(std::string_view(src), { .borrow_source = true });
+            sink = ctx.document.cells.size();
+        });
+    }
+
+//------------------------------------------
+
+    inline void run_parser_benchmarks()
+    {
+        BENCH_SUBCAT("Line scanning");
+        RUN_BENCH(structural_scan_100mb);
+        RUN_BENCH(per_line_find_scan_100mb);
+
+        BENCH_SUBCAT("Parsing");
+        RUN_BENCH(parse_100mb);
+        RUN_BENCH(parallel_parse_100mb);
+        RUN_BENCH(handler_scan_100mb);
+        RUN_BENCH(parse_1m_row_table);
+    }
+}
+
+#endif
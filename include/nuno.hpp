@@ -63,34 +63,52 @@ namespace nuno
     inline semantic_error_kind get_material_error(any_error const & e) { return std::get<error<semantic_error_kind>>(e).kind; }
 
 
-    inline doc_context load( std::string_view src, parser_options popt, materialiser_options mopt )
-    {
-        doc_context out{};
-
-        auto parse_ctx = parse(src, popt);
-        material_context mat_ctx = 
-            mopt.own_parser_data
-                ? materialise(std::move(parse_ctx), mopt)
-                :  materialise(parse_ctx, mopt);
-        out.document = std::move(mat_ctx.document);
+    // Loads a document from a file. The file is memory mapped and parsed in
+    // place; the mapping is kept alive by the document's source context.
+    doc_context load_file( std::filesystem::path const & path, parser_options popt = {}, materialiser_options mopt = {} );
 
-        out.errors.reserve(parse_ctx.errors.size() + mat_ctx.errors.size());
-
-        for (auto const & pe : parse_ctx.errors)
+    namespace detail
+    {
+        inline doc_context materialise_parsed( parse_context & parse_ctx, materialiser_options mopt )
         {
-            error<any_error> err;
-            err.kind = pe;
-            out.errors.push_back(err);
+            doc_context out{};
+
+            material_context mat_ctx = 
+                mopt.own_parser_data
+                    ? materialise(std::move(parse_ctx), mopt)
+                    :  materialise(parse_ctx, mopt);
+            out.document = std::move(mat_ctx.document);
+
+            out.errors.reserve(parse_ctx.errors.size() + mat_ctx.errors.size());
+
+            for (auto const & pe : parse_ctx.errors)
+            {
+                error<any_error> err;
+                err.kind = pe;
+                out.errors.push_back(err);
+            }
+
+            for (auto const & se : mat_ctx.errors)
+            {
+                error<any_error> err;
+                err.kind = se;
+                out.errors.push_back(err);
+            }
+
+            return out;
         }
+    }
 
-        for (auto const & se : mat_ctx.errors)
-        {
-            error<any_error> err;
-            err.kind = se;
-            out.errors.push_back(err);
-        }
+    inline doc_context load( std::string_view src, parser_options popt, materialiser_options mopt )
+    {
+        auto parse_ctx = parse(src, popt);
+        return detail::materialise_parsed(parse_ctx, mopt);
+    }
 
-        return out;
+    inline doc_context load_file( std::filesystem::path const & path, parser_options popt, materialiser_options mopt )
+    {
+        auto parse_ctx = parse_file(path, popt);
+        return detail::materialise_parsed(parse_ctx, mopt);
     }
 
     inline doc_context load( std::string_view src, parser_options opt )
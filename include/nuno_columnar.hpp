@@ -0,0 +1,369 @@
+// nuno_columnar.hpp - A Readable Format (NUNO) - Columnar table storage
+// Version 0.3.0
+// Copyright 2025 Mikael Ueno A
+// Licenced as-is under the MIT licence.
+
+#ifndef NUNO_COLUMNAR_HPP
+#define NUNO_COLUMNAR_HPP
+
+#include "nuno_core.hpp"
+
+#include <cassert>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+
+namespace nuno
+{
+//========================================================================
+// Columnar cell storage
+// ---------------------------
+// An alternative layout for table cells: one contiguous array per
+// column instead of one typed_value vector per row. Scans over a
+// column touch only that column's values, and the per-cell metadata
+// (type, ascription, origin, authorship) is stored once per column.
+//
+// A column packs every cell that has the same metadata and held type
+// as its first packable cell (its prototype); only the semantic state
+// varies per packed cell and is kept as a bitmap. Cells that do not
+// conform (arrays, unresolved values, edited or differently typed
+// cells) are stored whole as exceptions. Packed arrays keep a slot for
+// exception rows so values stay addressable by row ordinal.
+//
+// Storage is built from row-oriented cells. The editor appends rows to
+// it and retypes its columns in place; other cell and column edits
+// return the table to row layout first.
+//========================================================================
+
+    enum class table_layout
+    {
+        rows,       // Cells are stored per row (the default)
+        columnar    // Cells are stored per column in a column_store
+    };
+
+    namespace detail
+    {
+        // A growable bitmap over 64 bit words
+        class dense_bitset
+        {
+        public:
+            size_t size() const noexcept { return size_; }
+            bool empty() const noexcept { return size_ == 0; }
+
+            bool test(size_t i) const noexcept { return (words_[i >> 6] >> (i & 63)) & 1u; }
+
+            void set(size_t i, bool v = true) noexcept
+            {
+                uint64_t bit = uint64_t{1} << (i & 63);
+                if (v) words_[i >> 6] |= bit;
+                else   words_[i >> 6] &= ~bit;
+            }
+
+            void push_back(bool v)
+            {
+                if ((size_ & 63) == 0)
+                    words_.push_back(0);
+                ++size_;
+                set(size_ - 1, v);
+            }
+
+            void resize(size_t n, bool v = false)
+            {
+                if (v)
+                {
+                    while (size_ < n)
+                        push_back(true);
+                    return;
+                }
+
+                // Bits past size_ are kept clear, so growing with zeros
+                // only adds words
+                if (n > size_)
+                {
+                    words_.resize((n + 63) >> 6, 0);
+                    size_ = n;
+                }
+            }
+
+            // Bounds-checked test; bits past the end read as clear
+            bool contains(size_t i) const noexcept { return i < size_ && test(i); }
+
+            bool any() const noexcept
+            {
+                for (auto w : words_)
+                    if (w) return true;
+                return false;
+            }
+
+        private:
+            std::vector<uint64_t> words_;
+            size_t                size_ {0};
+        };
+    }
+
+    // The parts of a column that a change of column type rewrites: the
+    // prototype, the semantic state of packed cells and the exception
+    // cells. The packing and the packed values are left as they are.
+    struct column_metadata
+    {
+        typed_value                             prototype;
+        detail::dense_bitset                    invalid;
+        std::unordered_map<size_t, typed_value> exceptions;
+    };
+
+    class cell_column
+    {
+    public:
+        // Appends the cell of the next row
+        void push_back(typed_value const & cell);
+
+        size_t size() const noexcept { return size_; }
+
+        // The held type of packed cells, unresolved when nothing is packed
+        value_type packed_type() const noexcept { return packed_; }
+
+        // The metadata shared by packed cells. Its value is empty.
+        typed_value const & prototype() const noexcept { return proto_; }
+        typed_value       & prototype()       noexcept { return proto_; }
+
+        bool is_packed(size_t row) const noexcept { return !is_exception_.test(row); }
+
+        // Semantic state of a packed cell
+        bool is_invalid(size_t row) const noexcept { return invalid_.test(row); }
+        void set_invalid(size_t row, bool v) noexcept { invalid_.set(row, v); }
+
+        // Packed values by row ordinal. Exception rows hold a placeholder.
+        std::span<const int64_t> integers() const noexcept { return ints_; }
+        std::span<const double>  reals()    const noexcept { return reals_; }
+        bool             boolean(size_t row) const noexcept { return bools_.test(row); }
+        std::string_view string(size_t row)  const noexcept
+        {
+            return std::string_view(arena_).substr(offsets_[row], offsets_[row + 1] - offsets_[row]);
+        }
+
+        // Cells stored whole, by row ordinal
+        std::unordered_map<size_t, typed_value> const & exceptions() const noexcept { return exceptions_; }
+        std::unordered_map<size_t, typed_value>       & exceptions()       noexcept { return exceptions_; }
+
+        // Decodes the cell at a row ordinal
+        typed_value at(size_t row) const;
+
+        // Decodes the cell at a row ordinal into out, reusing the string
+        // storage out already holds
+        void read(size_t row, typed_value & out) const;
+
+        // Calls fn(row, v) for each packed cell in row order, v being the
+        // packed int64_t, double, bool or std::string_view. The packed
+        // arrays are read front to back and no cell is decoded.
+        template<typename F>
+        void for_each_packed(F && fn) const;
+
+        // Journalling a change of column type
+        column_metadata metadata() const { return { proto_, invalid_, exceptions_ }; }
+
+        // Exchanges the metadata with m. Rows pushed since m was taken
+        // keep their own, so the bitmaps stay aligned with the rows.
+        void swap_metadata(column_metadata & m);
+
+    private:
+        bool conforms(typed_value const & cell) const noexcept;
+        void push_placeholder();
+        void push_value(value const & v);
+
+        value_type     packed_ {value_type::unresolved};
+        typed_value    proto_;
+        size_t         size_   {0};
+
+        std::vector<int64_t>  ints_;
+        std::vector<double>   reals_;
+        detail::dense_bitset  bools_;
+        std::vector<uint64_t> offsets_ {0};
+        std::string           arena_;
+
+        detail::dense_bitset  invalid_;
+        detail::dense_bitset  is_exception_;
+        std::unordered_map<size_t, typed_value> exceptions_;
+    };
+
+    // The cells of one table, stored per column
+    struct column_store
+    {
+        std::vector<cell_column> columns;
+        size_t                   row_count {0};
+    };
+
+//========================================================================
+// cell_column implementation
+//========================================================================
+
+    inline bool cell_column::conforms(typed_value const & cell) const noexcept
+    {
+        return cell.held_type()   == packed_
+            && cell.type          == proto_.type
+            && cell.type_source   == proto_.type_source
+            && cell.origin        == proto_.origin
+            && cell.contamination == proto_.contamination
+            && cell.creation      == proto_.creation
+            && cell.is_edited     == proto_.is_edited;
+    }
+
+    inline void cell_column::push_placeholder()
+    {
+        switch (packed_)
+        {
+            case value_type::integer:        ints_.push_back(0); break;
+            case value_type::floating_point: reals_.push_back(0); break;
+            case value_type::boolean:        bools_.push_back(false); break;
+            case value_type::string:         offsets_.push_back(arena_.size()); break;
+            default: break;
+        }
+    }
+
+    inline void cell_column::push_value(value const & v)
+    {
+        switch (packed_)
+        {
+            case value_type::integer:        ints_.push_back(std::get<int64_t>(v)); break;
+            case value_type::floating_point: reals_.push_back(std::get<double>(v)); break;
+            case value_type::boolean:        bools_.push_back(std::get<bool>(v)); break;
+            case value_type::string:
+                arena_ += std::get<std::string>(v);
+                offsets_.push_back(arena_.size());
+                break;
+            default: assert(false && "Unpackable value type");
+        }
+    }
+
+    inline void cell_column::push_back(typed_value const & cell)
+    {
+        size_t row = size_++;
+
+        if (packed_ == value_type::unresolved)
+        {
+            auto held = cell.held_type();
+            bool packable = held == value_type::string || held == value_type::integer
+                         || held == value_type::floating_point || held == value_type::boolean;
+            if (packable)
+            {
+                // First packable cell: it becomes the prototype and earlier
+                // exception rows receive their placeholders
+                packed_ = held;
+                proto_  = cell;
+                proto_.val = std::monostate{};
+                proto_.semantic = semantic_state::valid;
+                for (size_t i = 0; i < row; ++i)
+                    push_placeholder();
+            }
+        }
+
+        if (packed_ != value_type::unresolved && conforms(cell))
+        {
+            push_value(cell.val);
+            invalid_.push_back(cell.semantic == semantic_state::invalid);
+            is_exception_.push_back(false);
+            return;
+        }
+
+        push_placeholder();
+        invalid_.push_back(false);
+        is_exception_.push_back(true);
+        exceptions_.emplace(row, cell);
+    }
+
+    inline typed_value cell_column::at(size_t row) const
+    {
+        if (!is_packed(row))
+            return exceptions_.at(row);
+
+        typed_value tv = proto_;
+        tv.semantic = invalid_.test(row) ? semantic_state::invalid : semantic_state::valid;
+        switch (packed_)
+        {
+            case value_type::integer:        tv.val = ints_[row]; break;
+            case value_type::floating_point: tv.val = reals_[row]; break;
+            case value_type::boolean:        tv.val = bools_.test(row); break;
+            case value_type::string:         tv.val = std::string(string(row)); break;
+            default: break;
+        }
+        return tv;
+    }
+
+    inline void cell_column::read(size_t row, typed_value & out) const
+    {
+        if (!is_packed(row))
+        {
+            out = exceptions_.at(row);
+            return;
+        }
+
+        out.type          = proto_.type;
+        out.type_source   = proto_.type_source;
+        out.origin        = proto_.origin;
+        out.contamination = proto_.contamination;
+        out.creation      = proto_.creation;
+        out.is_edited     = proto_.is_edited;
+        out.semantic      = invalid_.test(row) ? semantic_state::invalid : semantic_state::valid;
+        switch (packed_)
+        {
+            case value_type::integer:        out.val = ints_[row]; break;
+            case value_type::floating_point: out.val = reals_[row]; break;
+            case value_type::boolean:        out.val = bools_.test(row); break;
+            case value_type::string:
+                if (auto * s = std::get_if<std::string>(&out.val))
+                    s->assign(string(row));
+                else
+                    out.val = std::string(string(row));
+                break;
+            default: break;
+        }
+    }
+
+    template<typename F>
+    void cell_column::for_each_packed(F && fn) const
+    {
+        switch (packed_)
+        {
+            case value_type::integer:
+                for (size_t r = 0; r < size_; ++r)
+                    if (is_packed(r)) fn(r, ints_[r]);
+                break;
+            case value_type::floating_point:
+                for (size_t r = 0; r < size_; ++r)
+                    if (is_packed(r)) fn(r, reals_[r]);
+                break;
+            case value_type::boolean:
+                for (size_t r = 0; r < size_; ++r)
+                    if (is_packed(r)) fn(r, bools_.test(r));
+                break;
+            case value_type::string:
+                for (size_t r = 0; r < size_; ++r)
+                    if (is_packed(r)) fn(r, string(r));
+                break;
+            default: break;
+        }
+    }
+
+    inline void cell_column::swap_metadata(column_metadata & m)
+    {
+        std::swap(proto_, m.prototype);
+        std::swap(invalid_, m.invalid);
+        std::swap(exceptions_, m.exceptions);
+
+        size_t taken = invalid_.size();
+        for (size_t r = taken; r < m.invalid.size(); ++r)
+            invalid_.push_back(m.invalid.test(r));
+
+        for (auto it = m.exceptions.begin(); it != m.exceptions.end(); )
+        {
+            if (it->first >= taken)
+            {
+                exceptions_.insert(std::move(*it));
+                it = m.exceptions.erase(it);
+            }
+            else
+                ++it;
+        }
+    }
+}
+
+#endif
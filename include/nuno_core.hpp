@@ -10,8 +10,11 @@
 #include <array>
 #include <cstdint>
 #include <optional>
+#include <ostream>
 #include <string>
 #include <string_view>
+#include <unordered_map>
+#include <unordered_set>
 #include <variant>
 #include <vector>
 
@@ -81,6 +84,129 @@ namespace nuno
     using comment_id    = id<comment_tag>;
     using paragraph_id  = id<paragraph_tag>;
 
+//========================================================================
+// Symbols
+// ---------------------------
+// Names of categories, keys and columns are interned in a table owned
+// by their document, so each distinct name is stored once. A symbol is
+// a handle to an interned name: symbols from the same table are equal
+// exactly when their names are, which makes name comparison a pointer
+// comparison. Symbols stay valid for the lifetime of their table.
+//========================================================================
+
+    class symbol
+    {
+    public:
+        symbol() noexcept = default;
+
+        std::string const & str() const noexcept { static const std::string none; return str_ ? *str_ : none; }
+        bool empty() const noexcept { return str_ == nullptr; }
+
+        bool operator==(symbol const &) const noexcept = default;
+        friend bool operator==(symbol const & lhs, std::string_view rhs) noexcept { return lhs.str() == rhs; }
+        friend std::ostream & operator<<(std::ostream & os, symbol const & s) { return os << s.str(); }
+
+        struct hash
+        {
+            size_t operator()(symbol s) const noexcept { return std::hash<std::string const *>{}(s.str_); }
+        };
+
+    private:
+        friend class symbol_table;
+        explicit symbol(std::string const * str) noexcept : str_(str) {}
+
+        std::string const * str_ {nullptr};
+    };
+
+    class symbol_table
+    {
+    public:
+        // Returns the symbol of a name, adding the name if it is new.
+        // The empty name is the empty symbol.
+        symbol intern(std::string_view name)
+        {
+            if (name.empty())
+                return {};
+            auto it = strings_.find(name);
+            if (it == strings_.end())
+                it = strings_.emplace(name).first;
+            return symbol{ &*it };
+        }
+
+        // Returns the symbol of a name only if it has been interned
+        std::optional<symbol> find(std::string_view name) const
+        {
+            if (name.empty())
+                return symbol{};
+            auto it = strings_.find(name);
+            if (it == strings_.end())
+                return std::nullopt;
+            return symbol{ &*it };
+        }
+
+        size_t size() const noexcept { return strings_.size(); }
+
+    private:
+        struct name_hash
+        {
+            using is_transparent = void;
+            size_t operator()(std::string_view s) const noexcept { return std::hash<std::string_view>{}(s); }
+        };
+
+        // Node-based, so interned strings keep their address
+        std::unordered_set<std::string, name_hash, std::equal_to<>> strings_;
+    };
+
+    // Symbol to ID index that tolerates duplicate names. A unique name
+    // resolves directly; a name held by several entries is reported as
+    // ambiguous and left to the caller to resolve by order.
+    template<typename Id>
+    class name_index
+    {
+    public:
+        enum class match { none, unique, ambiguous };
+
+        void add(symbol name, Id id)
+        {
+            auto [it, inserted] = entries_.try_emplace(name, entry{ id, 1 });
+            if (!inserted)
+            {
+                ++it->second.count;
+                it->second.id = invalid_id<typename Id::tag_type>();
+            }
+        }
+
+        // A name that was ambiguous stays so until its last entry is removed
+        void remove(symbol name)
+        {
+            auto it = entries_.find(name);
+            if (it != entries_.end() && --it->second.count == 0)
+                entries_.erase(it);
+        }
+
+        match find(symbol name, Id & id) const
+        {
+            auto it = entries_.find(name);
+            if (it == entries_.end())
+                return match::none;
+            if (!it->second.id.valid())
+                return match::ambiguous;
+            id = it->second.id;
+            return match::unique;
+        }
+
+        void clear() noexcept { entries_.clear(); }
+
+    private:
+        struct entry
+        {
+            Id     id;
+            size_t count;
+        };
+
+        std::unordered_map<symbol, entry, symbol::hash> entries_;
+    };
+
 //========================================================================
 // Values
 //
@@ -102,7 +228,7 @@ namespace nuno
         contaminated
     };
 
-    enum class value_type
+    enum class value_type : uint8_t
     {
         unresolved,
         string,
@@ -128,13 +254,13 @@ namespace nuno
         5, // floating_point_array -> std::vector<typed_value>
     };
 
-    enum class type_ascription
+    enum class type_ascription : uint8_t
     {
         tacit,    // implicit, not defined in source
         declared  // explicitly defined in source
     };
 
-    enum class value_locus
+    enum class value_locus : uint8_t
     {
         key_value,      // declared via key = value
         table_cell,     // declared inside a table row
@@ -142,7 +268,7 @@ namespace nuno
         predicate,      // created as the comparator in a query predicate
     };
 
-    enum class creation_state
+    enum class creation_state : uint8_t
     {
         authored,   // defined in an authored source (created from parser/CST)
         generated   // created after the document (programmatically generated)
@@ -159,6 +285,8 @@ namespace nuno
         std::vector<typed_value>
     >;
 
+    // The metadata enums are one byte each so that together they fit in
+    // the alignment padding after val (48 byte cells with libstdc++).
     struct typed_value
     {
         value               val;
@@ -239,22 +367,20 @@ namespace nuno
         category_id parent;    // npos for root
     };
 
-    struct column
+    // Columns name themselves with a std::string in the CST and with
+    // a symbol in the document
+    template<typename Name>
+    struct basic_column
     {
         column_id       id;
-        std::string     name;
+        Name            name;
         value_type      type;
         type_ascription type_source;
         std::optional<std::string> declared_type;
         semantic_state  semantic = semantic_state::valid;
     };
 
-    struct table_row
-    {
-        row_id id;
-        category_id  owning_category;
-        std::vector<typed_value> cells;
-    };
+    using column = basic_column<std::string>;
 
     struct table
     {
@@ -342,11 +468,10 @@ namespace nuno
             return s.substr(start, end - start + 1);
         }
         
-        inline std::string to_lower(const std::string& s)
+        inline std::string to_lower(std::string s)
         {
-            std::string result = s;
-            std::transform(result.begin(), result.end(), result.begin(), ::tolower);
-            return result;
+            std::transform(s.begin(), s.end(), s.begin(), ::tolower);
+            return s;
         }
 
         inline std::optional<value_type>
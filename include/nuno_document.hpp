@@ -7,7 +7,9 @@
 #define NUNO_DOCUMENT_HPP
 
 #include "nuno_parser.hpp"
+#include "nuno_columnar.hpp"
 
+#include <bit>
 #include <cassert>
 #include <functional>
 #include <iterator>
@@ -16,6 +18,7 @@
 #include <ranges>
 #include <span>
 #include <unordered_set>
+#include <utility>
 
 namespace nuno
 {
@@ -96,6 +99,7 @@ namespace nuno
         size_t category_count() const noexcept;
         std::optional<category_view> root() const noexcept;
         std::optional<category_view> category(std::string_view name) const noexcept;
+        std::optional<category_view> category(symbol name) const noexcept;
         std::optional<category_view> category(category_id id) const noexcept;
         std::vector<category_view>   categories() const noexcept;
 
@@ -123,20 +127,45 @@ namespace nuno
         std::optional<table_row_view> row(row_id id) const noexcept;
         std::vector<table_row_view>   rows() const noexcept;
 
+        // Erased rows are tombstoned, and skipped by reads until purged.
+        // The editor purges them once they make up half of the rows of
+        // the document or of a table. Purges all tombstones now.
+        void compact();
+
     //------------------------------------------------------------------------
     // Key access
     //------------------------------------------------------------------------
 
         size_t key_count() const noexcept;
         std::optional<key_view> key(std::string_view name) const noexcept;
+        std::optional<key_view> key(symbol name) const noexcept;
         std::optional<key_view> key(key_id id) const noexcept;
         std::vector<key_view>   keys() const noexcept;
 
+    //------------------------------------------------------------------------
+    // Names
+    //------------------------------------------------------------------------
+
+        // Category, key and column names are interned per document.
+        // Lookups by a pre-interned symbol skip hashing the name.
+        symbol intern(std::string_view name) { return symbols_.intern(name); }
+        std::optional<symbol> find_symbol(std::string_view name) const { return symbols_.find(name); }
+
         size_t comment_count() const noexcept;
         size_t paragraph_count() const noexcept;
 
         category_id create_root();
 
+    //------------------------------------------------------------------------
+    // Source
+    //------------------------------------------------------------------------
+
+        // Whether the document serializes to its source text unchanged:
+        // it holds the source it was loaded from, no editor has changed
+        // it since, and the source has no lines serialization rewrites
+        // (CRLF line endings, a missing final newline, dropped lines)
+        bool is_verbatim_source() const noexcept;
+
     //------------------------------------------------------------------------
     // Contamination management
     //------------------------------------------------------------------------
@@ -160,7 +189,7 @@ namespace nuno
 
         bool has_contamination_sources() const
         {
-            return !contaminated_source_keys_.empty() || !contaminated_source_rows_.empty();
+            return contaminated_source_keys_.any() || contaminated_source_rows_.any();
         }
 
     //------------------------------------------------------------------------
@@ -194,6 +223,15 @@ namespace nuno
         struct comment_node;
         struct paragraph_node;  
 
+        // A byte range [begin, end) of the source text that serializes
+        // verbatim, and the number of categories it leaves open
+        struct source_extent
+        {
+            size_t begin {0};
+            size_t end   {0};
+            size_t opens {0};
+        };
+
     //------------------------------------------------------------------------
     // Types for source order tracking
     //------------------------------------------------------------------------
@@ -229,6 +267,36 @@ namespace nuno
         template<typename Tag>
         using view_for_t = typename view_for<Tag>::type;
 
+    //------------------------------------------------------------------------
+    // Lazy view ranges
+    //------------------------------------------------------------------------
+
+        // A random-access range of views, each built on dereference.
+        // Elem is either a node type, iterating node storage, or an ID
+        // type, iterating an ID list. Unlike categories(), tables(),
+        // etc. these never allocate. Like views, they are invalidated
+        // by edits to the document.
+        template<typename View, typename Elem>
+        class view_range;
+
+        // The rows of row storage or of a row list, skipping erased rows
+        // not yet compacted (see compact()), so it is bidirectional.
+        // Value is a row view or a row ID. size() is constant time, and
+        // so is indexing while there is no erased row to skip.
+        template<typename Value, typename Elem>
+        class live_rows;
+
+        // The cells of a row: row layout cells in place, or the cells of
+        // a columnar row decoded into storage the range owns, so reads
+        // from several threads at once share no cache
+        class cell_range;
+
+        view_range<category_view, category_node> categories_range() const noexcept;
+        view_range<table_view, table_node>       tables_range() const noexcept;
+        view_range<column_view, column_node>     columns_range() const noexcept;
+        live_rows<table_row_view, row_node>      rows_range() const noexcept;
+        view_range<key_view, key_node>           keys_range() const noexcept;
+
     private:
 
         // Used by materialiser and editor
@@ -270,9 +338,9 @@ namespace nuno
         {
             using NodeT = typename document::node_for<T>::type;
 
-            auto find_id = [id_](std::vector<NodeT> & nodes) -> NodeT *
+            auto find_id = [this, id_](std::vector<NodeT> & nodes) -> NodeT *
             {
-                if (auto it = std::ranges::find_if(nodes, [id_](auto& item){return item._id() == id_;}); it != nodes.end())
+                if (auto it = find_node_by_id(nodes, id_); it != nodes.end())
                     return &*it;
                 return nullptr;
             };
@@ -286,11 +354,207 @@ namespace nuno
             else if constexpr (std::is_same_v<T, paragraph_tag>)    { return find_id(paragraphs_); }
             else static_assert(false, "Illegal ID");
         };        
+
+        // Dense ID to storage slot index.
+        // IDs are monotonic and never reused, so a flat vector keyed
+        // by ID value resolves any ID to its position in the node
+        // storage in constant time. One index exists per node vector;
+        // all insertions and erasures must go through insert_node()
+        // and erase_node() to keep them synchronised.
+        //----------------------------------------------------------
+        struct slot_index
+        {
+            std::vector<size_t> slots;
+
+            size_t find(size_t id) const noexcept 
+            { 
+                return id < slots.size() ? slots[id] : npos(); 
+            }
+
+            void assign(size_t id, size_t slot)
+            {
+                if (id >= slots.size())
+                    slots.resize(id + 1, npos());
+                slots[id] = slot;
+            }
+
+            void remove(size_t id) noexcept
+            {
+                if (id < slots.size())
+                    slots[id] = npos();
+            }
+        };
+
+        // Row ordinals and first-cell names of one table, kept current
+        // by the edits that list, erase or rename its rows, so reads
+        // never build it. Rows are indexed by their position in the row
+        // list, erased rows included; a bit per position marks the
+        // erased ones and a Fenwick tree over the words of bits turns a
+        // position into an ordinal in logarithmic time. Names are kept
+        // as hashes, chained by bucket and compared in full only by the
+        // lookups. Appended rows are chained a batch at a time, so the
+        // scattered bucket writes of a bulk append overlap; lookups scan
+        // the batch still waiting.
+        //----------------------------------------------------------
+        struct row_lookup
+        {
+            static constexpr size_t link_batch = 64;
+
+            std::vector<size_t>   hashes;           // position to the hash of its name
+            std::vector<size_t>   next_named;       // position to the next live one in its bucket
+            std::vector<size_t>   buckets;          // a power of two of chain heads, once any row is chained
+            std::vector<uint64_t> erased_bits;      // a bit per position with no live row
+            std::vector<size_t>   erased_tree;      // 1-based over erased_bits; built once a row is erased
+            size_t                erased {0};
+            size_t                linked {0};       // positions from here on wait to be chained
+
+            bool   erased_at(size_t pos) const noexcept { return erased_bits[pos / 64] >> (pos % 64) & 1; }
+            size_t ordinal(size_t pos) const noexcept { return erased ? pos - erased_before(pos) : pos; }
+            size_t erased_before(size_t pos) const noexcept;
+
+            template<typename F>
+            void for_each_named(size_t hash, F && fn) const;
+
+            void reserve(size_t count);
+            void push(size_t hash, bool is_erased);
+            void pop();
+            void insert(size_t pos, size_t hash, bool is_erased);
+            void erase(size_t pos);
+            void set_erased(size_t pos, bool is_erased);
+            void link(size_t pos) noexcept;
+            void unlink(size_t pos) noexcept;
+            void link_pending();
+            void rehash();
+            void rebuild_erased();
+            size_t erased_words_before(size_t word) const noexcept;
+        };
+
+        // Keep the row lookup of a table current. index_rows rebuilds it
+        // whole, index_listed_row follows an ID inserted into the row list
+        // at pos and unindex_listed_row one about to be erased from it;
+        // index_name and unindex_name follow the rows themselves, and
+        // rename_listed_row a change to the first cell of one.
+        void index_rows(table_node & t);
+        void index_listed_row(table_node & t, size_t pos);
+        void unindex_listed_row(table_node & t, size_t pos);
+        void rename_listed_row(row_node const & r);
+        size_t row_hash(row_node const & r) const;
+        std::string row_name(row_node const & r) const;
+        row_node const * listed_row(table_node const & t, size_t pos) const noexcept;
+
+        slot_index category_slots_;
+        slot_index table_slots_;
+        slot_index column_slots_;
+        slot_index row_slots_;
+        slot_index key_slots_;
+        slot_index comment_slots_;
+        slot_index paragraph_slots_;
+
+        template<typename T>
+        slot_index & slots_for() noexcept;
+
+        template<typename T>
+        slot_index const & slots_for() const noexcept { return const_cast<document*>(this)->slots_for<T>(); }
+
+        template<typename T>
+        std::vector<T> & nodes() noexcept;
+
+        template<typename T>
+        std::vector<T> const & nodes() const noexcept { return const_cast<document*>(this)->nodes<T>(); }
+
+        // Appends a node to its storage and registers its slot
+        template<typename T>
+        T & insert_node(std::vector<T> & cont, T node);
+
+        // Removes a node from its storage; the slots of all trailing
+        // nodes are shifted with it
+        template<typename T>
+        bool erase_node(std::vector<T> & cont, typename T::id_type id);
+
+        // Removes all nodes matching pred in one pass
+        template<typename T, typename Pred>
+        size_t erase_nodes_if(std::vector<T> & cont, Pred pred);
+
+        // Re-registers the slots of cont[from..end)
+        template<typename T>
+        void reindex(std::vector<T> const & cont, size_t from = 0);
+
+        // Put a node back into its storage at its place in ID order, or
+        // take one out, as an editor undoing or redoing an edit does.
+        // Names are indexed and slots kept; contamination sources and
+        // counts are left to the caller, which restores them whole. A
+        // row is taken out as a tombstone and put back into its own.
+        template<typename T>
+        T & place_node(std::vector<T> & cont, T node);
+
+        template<typename T>
+        T take_node(std::vector<T> & cont, typename T::id_type id);
+
+        // Erases a row in constant time. Its slot is released at once,
+        // so the ID no longer resolves, but its node stays in rows_ as
+        // a tombstone and its ID in the row lists of its table until
+        // they are purged. Purging moves nodes and list entries only,
+        // and never changes an ID. A caller that has already removed
+        // the ID from the row lists passes listed = false.
+        bool erase_row_node(row_id id, bool listed = true);
+
+        // Purge the tombstones of rows_, or of the row lists of a table.
+        // Reads skip tombstones instead, so only edits purge.
+        void compact_rows() noexcept;
+        void purge_erased_rows(table_node & t);
+        bool is_erased(row_id id) const noexcept { return row_slots_.find(id.val) == npos(); }
+
+        // Purges rows_, and the row lists of t if given, once tombstones
+        // make up half of them, so erasing stays amortised constant time
+        void compact_sparse(table_node * t);
+
+        // Source extents. A category or table whose lines are authored,
+        // unedited and consecutive in the source is recorded as one byte
+        // range, which the serializer copies whole. Mapped once by the
+        // materialiser; an edit drops the extents of the table and the
+        // categories enclosing it (mark_dirty). The root has an extent
+        // only while the document is unedited, so that is cheap to ask.
+        void map_source_extents();
+        void mark_dirty(table_id id);
+        void mark_dirty(category_id id);
+
+        std::optional<source_extent> map_extent(category_node & c, std::string_view src);
+        std::optional<source_extent> map_extent(table_node & t, std::string_view src);
+        void map_items(std::vector<source_item_ref> const & items, std::string_view src,
+                       char const *& at, size_t & opens);
+        void follow_line(std::optional<size_t> event, std::string_view src,
+                         char const *& at, bool row = false) const;
+
+        // Maintain the name indices as named nodes enter and leave storage
+        template<typename T>
+        void index_name(T const & node);
+
+        template<typename T>
+        void unindex_name(T const & node);
+
+        // Maintain the contamination counts as nodes enter and leave
+        // storage. Erasing a source unregisters it; the flags of its
+        // ancestors are re-evaluated by the caller once the erase is
+        // complete (try_clear_table/category_contamination).
+        template<typename T>
+        void track_contamination(T const & node);
+
+        template<typename T>
+        void untrack_contamination(T const & node);
         
         // The source CST document from the parser
         //----------------------------------------------------------
         std::unique_ptr<parse_context> source_context_;
 
+        // Interned category, key and column names
+        //----------------------------------------------------------
+        symbol_table symbols_;
+
+        // Document-wide name indices for category(name) and key(name).
+        // Per-scope indices live in the category and table nodes.
+        name_index<category_id> category_names_;
+        name_index<key_id>      key_names_;
+
         
         // The storage structures for the document data populated
         // by the materialiser or editor
@@ -298,11 +562,14 @@ namespace nuno
         std::vector<category_node>   categories_;
         std::vector<table_node>      tables_;
         std::vector<column_node>     columns_;
-        std::vector<row_node>        rows_;
+        std::vector<row_node>        rows_;    // may hold tombstones, see erase_row_node()
         std::vector<key_node>        keys_;
         std::vector<comment_node>    comments_;
         std::vector<paragraph_node>  paragraphs_;
 
+        // Tombstones in rows_, purged by compact_rows()
+        size_t erased_rows_ {0};
+
         // These collect contamination sources. Only data positions 
         // (keys and rows) are sources of contamination. Categories
         // and tables will propagate contaminiation but will never
@@ -313,8 +580,9 @@ namespace nuno
         //
         // A document is clean if these containers are empty
         // contaminated if there is at lease one record in either. 
-        std::unordered_set<size_t>  contaminated_source_keys_;
-        std::unordered_set<size_t>  contaminated_source_rows_;
+        // Both are indexed by ID value.
+        detail::dense_bitset  contaminated_source_keys_;
+        detail::dense_bitset  contaminated_source_rows_;
 
         // These imperatively set the clean state. Prefer
         // the request_clear_contamination method to allow 
@@ -322,9 +590,63 @@ namespace nuno
         void clear_key_contamination(key_id id);
         void clear_row_contamination(row_id id);        
 
+        // Whether a key or row is clean and request_clear_fn permits
+        // clearing it
+        bool may_clear_contamination(clearable_node node);
+
+        // Marking and clearing set the flags of the key or row, then
+        // add it to or remove it from the sources. Registering raises
+        // the counts and flags of its ancestors; unregistering lowers
+        // the counts only, leaving the ancestors to be re-evaluated.
+        void register_source(key_node const & k);
+        void register_source(row_node const & r);
+        void unregister_source(key_node const & k);
+        void unregister_source(row_node const & r);
+
         bool row_is_valid(document::row_node const& r);
         bool table_is_valid(document::table_node const& t);
 
+        // Snapshots, for rolling back editor batches. A snapshot holds
+        // the node storage with its indices and contamination sources.
+        // The source CST is never edited and is not copied; symbols and
+        // IDs handed out after the snapshot stay reserved on restore.
+        //----------------------------------------------------------
+        struct snapshot;
+
+        snapshot take_snapshot() const;
+        void restore(snapshot && s);
+
+        // Columnar tables
+        //----------------------------------------------------------
+
+        // Moves the cells of a table into a column_store. Tables with
+        // rows whose arity differs from the columns stay row-oriented.
+        bool make_columnar(table_node & t);
+
+        // Moves the cells of a columnar table back into its rows and
+        // returns the store they came from
+        std::unique_ptr<column_store> make_row_oriented(table_node & t);
+
+        // Puts back the store a table left for row layout. The cells of
+        // its rows must still be the ones the store holds for them.
+        void restore_columnar(table_node & t, std::unique_ptr<column_store> store);
+
+        // The cells of a row: row layout cells in place, columnar ones
+        // decoded into scratch, reusing the storage it holds from
+        // earlier rows
+        std::span<const typed_value> row_cells(row_node const & r, std::vector<typed_value> & scratch) const;
+
+        // Visits the cells of a row in order, decoding a columnar row
+        // one cell at a time. fn returns false to stop the visit.
+        template<typename F>
+        bool for_each_cell(row_node const & r, F && fn) const;
+
+        // Visits a single cell; returns false if the row has no such cell
+        template<typename F>
+        bool visit_cell(row_node const & r, size_t index, F && fn) const;
+
+        column_store const * store_of(row_node const & r) const noexcept;
+
         template<typename T>
         typename std::vector<T>::iterator 
         find_node_by_id(std::vector<T> & cont, typename T::id_type id) noexcept;
@@ -335,7 +657,7 @@ namespace nuno
 
         template<typename T>
         typename std::vector<T>::const_iterator 
-        find_node_by_name(std::vector<T> const & cont, std::string_view name) const noexcept;
+        find_node_by_name(std::vector<T> const & cont, symbol name) const noexcept;
 
         template<typename T>
         std::optional<typename node_to_view<T>::view_type>
@@ -346,7 +668,13 @@ namespace nuno
         bool table_is_clean(const table_node& t) const;
         bool category_is_clean(const category_node& c) const;
         void propagate_contamination_up_category_chain(category_id id);
+        void try_clear_table_contamination(table_id id);
         void try_clear_category_contamination(category_id id);
+
+        // Set the derived flag of a table or category, keeping the
+        // contaminated_children count of its owner in step
+        void set_contamination(table_node & t, contamination_state state);
+        void set_contamination(category_node & c, contamination_state state);
     };
 
 
@@ -383,19 +711,28 @@ namespace nuno
         {
             typedef category_id id_type;
             id_type _id() const noexcept { return id; }
-            std::string_view _name() const noexcept { return name; }
+            symbol _name() const noexcept { return name; }
             
             category_id                  id;
-            std::string                  name;
+            symbol                       name;
             category_id                  parent;
             std::vector<category_id>     children;
             std::vector<table_id>        tables;
             std::vector<key_id>          keys;
             std::vector<source_item_ref> ordered_items;
+            name_index<category_id>      child_names;
+            name_index<key_id>           key_names;
+
+            // Contamination counts, kept by the document so a clear
+            // re-evaluates each ancestor in constant time
+            size_t                       contaminated_keys {0};      // direct keys that are sources
+            size_t                       contaminated_children {0};  // direct tables and subcategories flagged contaminated
 
             // Authorship metadata, instead of source_event_index:
             std::optional<size_t>        source_event_index_open;   // Category open event
             std::optional<size_t>        source_event_index_close;  // Category close event (if explicit)
+
+            std::optional<source_extent> extent;    // open line and items, while untouched
         };
 
         struct document::table_node : document::node<>
@@ -407,18 +744,40 @@ namespace nuno
             table_id                     id;
             category_id                  owner;
             std::vector<column_id>       columns;
-            std::vector<row_id>    rows;          // semantic collection (all rows)
+            // The row lists may hold the IDs of erased rows until purged
+            // by purge_erased_rows(); reads skip them
+            std::vector<row_id>          rows;          // semantic collection (all rows)
             std::vector<source_item_ref> ordered_items; // authored order (rows + comments + paragraphs + subcategories)
+            size_t                       erased_rows {0};
+
+            std::unique_ptr<column_store> store;  // cell storage when the table is columnar
+            name_index<column_id>        column_names;
+            row_lookup                   lookup;
+            size_t                       contaminated_rows {0};      // rows that are contamination sources
+            std::optional<source_extent> extent;    // header and items, while untouched
+
+            table_node() = default;
+            table_node(table_node &&) = default;
+            table_node & operator=(table_node &&) = default;
+
+            // Copies the column store too, for snapshots
+            table_node(table_node const & o)
+                : node<>(o), id(o.id), owner(o.owner), columns(o.columns), rows(o.rows)
+                , ordered_items(o.ordered_items), erased_rows(o.erased_rows)
+                , store(o.store ? std::make_unique<column_store>(*o.store) : nullptr)
+                , column_names(o.column_names), lookup(o.lookup), contaminated_rows(o.contaminated_rows)
+                , extent(o.extent)
+            {}
         };
 
         struct document::column_node : document::node<true, false>
         {
             typedef column_id id_type;
             id_type _id() const noexcept { return col.id; }
-            std::string_view _name() const noexcept { return col.name; }
+            symbol _name() const noexcept { return col.name; }
             value_type _type() const noexcept { return col.type; }
             
-            struct column   col;
+            basic_column<symbol> col;
             table_id        table;
             category_id     owner;
         };
@@ -437,17 +796,22 @@ namespace nuno
             row_id             id;
             table_id                 table;
             category_id              owner;
+
+            // Owned cells in row layout; empty in columnar layout, where
+            // the cells live in the table's column_store
             std::vector<typed_value> cells;
+            size_t                   store_index {0};       // row ordinal in the column_store
+            size_t                   listed_at {npos()};    // position in the row list, see row_lookup
         };
 
         struct document::key_node : document::node<>
         {
             typedef key_id id_type;
             id_type _id() const noexcept { return id; }
-            std::string_view _name() const noexcept { return name; }
+            symbol _name() const noexcept { return name; }
             
             key_id               id;
-            std::string          name;
+            symbol               name;
             category_id          owner;
             value_type           type;
             type_ascription      type_source;
@@ -474,6 +838,28 @@ namespace nuno
             category_id  owner {invalid_id<category_tag>()} ;
         };    
 
+        struct document::snapshot
+        {
+            name_index<category_id> category_names;
+            name_index<key_id>      key_names;
+
+            std::vector<category_node>   categories;
+            std::vector<table_node>      tables;
+            std::vector<column_node>     columns;
+            std::vector<row_node>        rows;
+            std::vector<key_node>        keys;
+            std::vector<comment_node>    comments;
+            std::vector<paragraph_node>  paragraphs;
+
+            slot_index category_slots, table_slots, column_slots, row_slots;
+            slot_index key_slots, comment_slots, paragraph_slots;
+
+            detail::dense_bitset contaminated_source_keys;
+            detail::dense_bitset contaminated_source_rows;
+
+            size_t erased_rows;
+        };
+
 //========================================================================
 // Views
 //========================================================================
@@ -484,16 +870,22 @@ namespace nuno
         const category_node* node;
 
         category_id id() const noexcept { return node->id; }
-        std::string_view name() const noexcept { return node->name; }
+        std::string_view name() const noexcept { return node->name.str(); }
         bool is_root() const noexcept { return node->parent == invalid_id<category_tag>(); }
 
         std::span<const category_id> children() const noexcept { return node->children; }
         std::span<const table_id> tables() const noexcept { return node->tables; }
         std::span<const key_id> keys() const noexcept { return node->keys;}
 
+        view_range<category_view, category_id> child_views() const noexcept;
+        view_range<table_view, table_id>       table_views() const noexcept;
+        view_range<key_view, key_id>           key_views() const noexcept;
+
         std::optional<category_view> parent() const noexcept;
         std::optional<category_view> child(std::string_view name) const noexcept;
+        std::optional<category_view> child(symbol name) const noexcept;
         std::optional<key_view> key(std::string_view name) const noexcept;
+        std::optional<key_view> key(symbol name) const noexcept;
 
         size_t children_count() const noexcept { return node->children.size(); }
         size_t tables_count() const noexcept { return node->tables.size(); }
@@ -512,20 +904,31 @@ namespace nuno
         category_view owner() const noexcept;
 
         std::span<const column_id> columns() const noexcept { return node->columns; }
-        std::span<const row_id> rows() const noexcept { return node->rows; }
+        live_rows<row_id, row_id>            rows() const noexcept;
+
+        view_range<column_view, column_id>   column_views() const noexcept;
+        live_rows<table_row_view, row_id>    row_views() const noexcept;
 
         size_t column_count() const noexcept { return node->columns.size(); }
-        size_t row_count() const noexcept { return node->rows.size(); }
+        size_t row_count() const noexcept { return node->rows.size() - node->erased_rows; }
 
         std::optional<column_view> column( column_id id ) const noexcept;
         std::optional<column_view> column( std::string_view name ) const noexcept;
+        std::optional<column_view> column( symbol name ) const noexcept;
 
         std::optional<size_t> column_index(std::string_view name) const noexcept;        
+        std::optional<size_t> column_index(symbol name) const noexcept;        
         std::optional<size_t> column_index(column_id id) const noexcept;        
 
         std::optional<size_t> row_index(std::string_view name) const noexcept;        
         std::optional<size_t> row_index(row_id id) const noexcept;        
 
+        // Ordinals of all rows with the given name, in row order
+        std::vector<size_t> row_indices(std::string_view name) const;
+
+        table_layout layout() const noexcept { return node->store ? table_layout::columnar : table_layout::rows; }
+        const column_store* column_storage() const noexcept { return node->store.get(); }
+
         bool is_locally_valid() const noexcept { return node->semantic == semantic_state::valid; }
         bool is_contaminated() const noexcept { return node->contamination == contamination_state::contaminated; }
     };
@@ -536,7 +939,7 @@ namespace nuno
         const column_node* node;
 
         column_id id() const noexcept { return node->col.id; }
-        std::string_view name() const noexcept { return node->col.name; }
+        std::string_view name() const noexcept { return node->col.name.str(); }
         value_type type() const noexcept { return node->col.type; }
 
         table_view table() const noexcept;
@@ -552,8 +955,18 @@ namespace nuno
         const row_node* node;
 
         row_id id() const noexcept { return node->id; }
-        std::string name() const noexcept { return node->_name(); }
-        std::span<const typed_value> cells() const noexcept { return node->cells; }
+        std::string name() const noexcept;
+        // The cells of a columnar row are decoded, into the range or
+        // into scratch, whose storage is reused from row to row
+        cell_range cells() const;
+        std::span<const typed_value> cells(std::vector<typed_value> & scratch) const { return doc->row_cells(*node, scratch); }
+
+        // Ordinal of the row in the column_storage() of a columnar table
+        size_t storage_index() const noexcept { return node->store_index; }
+
+        // Reads a cell without decoding the rest of a columnar row
+        template<typename F>
+        bool visit_cell(size_t index, F && fn) const { return doc->visit_cell(*node, index, std::forward<F>(fn)); }
 
         table_view table() const noexcept;
         category_view owner() const noexcept;
@@ -569,7 +982,7 @@ namespace nuno
         const key_node* node;
 
         key_id id() const noexcept { return node->id; }
-        const std::string& name() const noexcept { return node->name; }
+        const std::string& name() const noexcept { return node->name.str(); }
         const typed_value& value() const noexcept { return node->value; }
         
         category_view owner() const noexcept;
@@ -583,167 +996,929 @@ namespace nuno
 
 
 //========================================================================
-// document member implementations
+// View ranges
 //========================================================================
 
-    inline category_id document::create_root()
+    template<typename View, typename Elem>
+    class document::view_range : public std::ranges::view_interface<document::view_range<View, Elem>>
     {
-        if (categories_.empty())
+        using node_type = std::remove_cvref_t<std::remove_pointer_t<decltype(View::node)>>;
+        static constexpr bool over_ids = !std::is_same_v<Elem, node_type>;
+
+    public:
+        class iterator
         {
-            category_node root;
-            root.id     = category_id{0};
-            root.name   = detail::ROOT_CATEGORY_NAME.data();
-            root.parent = invalid_id<category_tag>();
+        public:
+            using iterator_concept  = std::random_access_iterator_tag;
+            using iterator_category = std::input_iterator_tag;
+            using value_type        = View;
+            using difference_type   = std::ptrdiff_t;
 
-            categories_.push_back(std::move(root));
-        }
-        assert (categories_.front().id == category_id{0});        
-        return category_id{0};
-    }    
+            iterator() = default;
+            iterator(document const * doc, Elem const * pos) noexcept : doc_(doc), pos_(pos) {}
 
-    inline category_id document::create_category( std::string_view name, category_id parent )
+            View operator*() const noexcept
+            {
+                if constexpr (over_ids)
+                {
+                    size_t slot = doc_->slots_for<node_type>().find(pos_->val);
+                    assert(slot != npos() && "ID list refers to a missing node");
+                    return View{ doc_, &doc_->nodes<node_type>()[slot] };
+                }
+                else
+                    return View{ doc_, pos_ };
+            }
+
+            View operator[](difference_type n) const noexcept { return *(*this + n); }
+
+            iterator & operator++() noexcept { ++pos_; return *this; }
+            iterator   operator++(int) noexcept { auto it = *this; ++pos_; return it; }
+            iterator & operator--() noexcept { --pos_; return *this; }
+            iterator   operator--(int) noexcept { auto it = *this; --pos_; return it; }
+
+            iterator & operator+=(difference_type n) noexcept { pos_ += n; return *this; }
+            iterator & operator-=(difference_type n) noexcept { pos_ -= n; return *this; }
+
+            friend iterator operator+(iterator it, difference_type n) noexcept { return it += n; }
+            friend iterator operator+(difference_type n, iterator it) noexcept { return it += n; }
+            friend iterator operator-(iterator it, difference_type n) noexcept { return it -= n; }
+            friend difference_type operator-(iterator const & a, iterator const & b) noexcept { return a.pos_ - b.pos_; }
+
+            bool operator==(iterator const & rhs) const noexcept { return pos_ == rhs.pos_; }
+            auto operator<=>(iterator const & rhs) const noexcept { return pos_ <=> rhs.pos_; }
+
+        private:
+            document const * doc_ {nullptr};
+            Elem const *     pos_ {nullptr};
+        };
+
+        view_range() = default;
+        view_range(document const * doc, std::span<const Elem> elems) noexcept : doc_(doc), elems_(elems) {}
+
+        iterator begin() const noexcept { return { doc_, elems_.data() }; }
+        iterator end()   const noexcept { return { doc_, elems_.data() + elems_.size() }; }
+        size_t   size()  const noexcept { return elems_.size(); }
+
+    private:
+        document const *      doc_ {nullptr};
+        std::span<const Elem> elems_;
+    };
+
+    template<typename Value, typename Elem>
+    class document::live_rows : public std::ranges::view_interface<document::live_rows<Value, Elem>>
     {
-        if (auto pcat = get_node(parent))
+        static row_id id_of(Elem const & e) noexcept
         {
-            if (auto dup = category(name))
-                if (dup->parent()->id() == parent)
-                    return invalid_id<category_tag>();
+            if constexpr (std::is_same_v<Elem, row_node>) return e.id;
+            else                                           return e;
+        }
 
-            auto id = create_category_id();
-            category_node node;
-            node.id     = id;
-            node.name   = std::string(name);
-            node.parent = parent;
+    public:
+        class iterator
+        {
+        public:
+            using iterator_concept  = std::bidirectional_iterator_tag;
+            using iterator_category = std::input_iterator_tag;
+            using value_type        = Value;
+            using difference_type   = std::ptrdiff_t;
+
+            iterator() = default;
+            iterator(document const * doc, Elem const * pos, Elem const * first, Elem const * last) noexcept
+                : doc_(doc), pos_(pos), first_(first), last_(last)
+            {
+                while (pos_ != last_ && erased()) ++pos_;
+            }
+
+            Value operator*() const noexcept
+            {
+                if constexpr (std::is_same_v<Value, row_id>)
+                    return *pos_;
+                else if constexpr (std::is_same_v<Elem, row_node>)
+                    return Value{ doc_, pos_ };
+                else
+                {
+                    size_t slot = doc_->row_slots_.find(pos_->val);
+                    assert(slot != npos() && "Row list refers to a missing row");
+                    return Value{ doc_, &doc_->rows_[slot] };
+                }
+            }
+
+            iterator & operator++() noexcept
+            {
+                do ++pos_; while (pos_ != last_ && erased());
+                return *this;
+            }
+            iterator & operator--() noexcept
+            {
+                do --pos_; while (pos_ != first_ && erased());
+                return *this;
+            }
+            iterator operator++(int) noexcept { auto it = *this; ++*this; return it; }
+            iterator operator--(int) noexcept { auto it = *this; --*this; return it; }
 
-            categories_.push_back(std::move(node));
+            bool operator==(iterator const & rhs) const noexcept { return pos_ == rhs.pos_; }
 
-            auto it = std::ranges::find_if(categories_, [parent](category_node const & cn){return cn.id == parent;});
-            if (it != categories_.end())
-                it->children.push_back(id);
+        private:
+            bool erased() const noexcept { return doc_->is_erased(id_of(*pos_)); }
 
-            return id;            
+            document const * doc_   {nullptr};
+            Elem const *     pos_   {nullptr};
+            Elem const *     first_ {nullptr};
+            Elem const *     last_  {nullptr};
+        };
+
+        live_rows() = default;
+        live_rows(document const * doc, std::span<const Elem> elems, size_t erased) noexcept
+            : doc_(doc), elems_(elems), erased_(erased) {}
+
+        iterator begin() const noexcept { return { doc_, elems_.data(), elems_.data(), elems_.data() + elems_.size() }; }
+        iterator end()   const noexcept { auto last = elems_.data() + elems_.size(); return { doc_, last, elems_.data(), last }; }
+        size_t   size()  const noexcept { return elems_.size() - erased_; }
+
+        // Linear while there are erased rows to skip
+        Value operator[](size_t n) const noexcept
+        {
+            if (erased_ == 0)
+            {
+                auto const * pos = elems_.data() + n;
+                return *iterator{ doc_, pos, pos, pos + 1 };
+            }
+            return *std::ranges::next(begin(), static_cast<std::ptrdiff_t>(n));
         }
 
-        return invalid_id<category_tag>();
-    }
+    private:
+        document const *      doc_ {nullptr};
+        std::span<const Elem> elems_;
+        size_t                erased_ {0};
+    };
 
-    inline category_id document::create_category( category_id id, std::string_view name, category_id parent )
+    class document::cell_range
     {
-        // Only root have the ID 0 or an invalid parent ID. Either of
-        // these being explicitly set is interpreted as an attempt to
-        // create the root category.
-        if (id == category_id{0} || parent == invalid_id<category_tag>())
-        {
-            if (categories_.empty())
-                return create_root();
+    public:
+        using value_type = typed_value;
+        using iterator   = std::span<const typed_value>::iterator;
 
-            return invalid_id<category_tag>();
+        cell_range() = default;
+        cell_range(document const & doc, row_node const & r) : cells_(doc.row_cells(r, decoded_)) {}
+
+        // A copy refers to its own decoded cells
+        cell_range(cell_range const & o)
+            : decoded_(o.decoded_), cells_(o.owns_cells() ? std::span<const typed_value>(decoded_) : o.cells_) {}
+        cell_range(cell_range && o) noexcept
+            : decoded_(std::move(o.decoded_)), cells_(std::exchange(o.cells_, {})) {}
+
+        cell_range & operator=(cell_range o) noexcept
+        {
+            decoded_.swap(o.decoded_);
+            std::swap(cells_, o.cells_);
+            return *this;
         }
 
-        category_node node;
-        node.id     = id;
-        node.name   = std::string(name);
-        node.parent = parent;
+        iterator begin() const noexcept { return cells_.begin(); }
+        iterator end()   const noexcept { return cells_.end(); }
+        size_t   size()  const noexcept { return cells_.size(); }
+        bool     empty() const noexcept { return cells_.empty(); }
 
-        categories_.push_back(std::move(node));
+        typed_value const & operator[](size_t n) const noexcept { return cells_[n]; }
+        typed_value const & front() const noexcept { return cells_.front(); }
+        typed_value const & back()  const noexcept { return cells_.back(); }
+        typed_value const * data()  const noexcept { return cells_.data(); }
 
-        auto it = std::ranges::find_if(categories_, [parent](category_node const & cn){return cn.id == parent;});
-        if (it != categories_.end())
-            it->children.push_back(id);
+        operator std::span<const typed_value>() const noexcept { return cells_; }
 
-        return id;
+    private:
+        bool owns_cells() const noexcept { return !decoded_.empty() && cells_.data() == decoded_.data(); }
+
+        std::vector<typed_value>     decoded_;
+        std::span<const typed_value> cells_;
+    };
+
+    inline document::view_range<document::category_view, document::category_node> document::categories_range() const noexcept { return { this, categories_ }; }
+    inline document::view_range<document::table_view, document::table_node>       document::tables_range()     const noexcept { return { this, tables_ }; }
+    inline document::view_range<document::column_view, document::column_node>     document::columns_range()    const noexcept { return { this, columns_ }; }
+    inline document::live_rows<document::table_row_view, document::row_node>      document::rows_range()       const noexcept { return { this, rows_, erased_rows_ }; }
+    inline document::view_range<document::key_view, document::key_node>           document::keys_range()       const noexcept { return { this, keys_ }; }
+
+    inline document::view_range<document::category_view, category_id> document::category_view::child_views()  const noexcept { return { doc, node->children }; }
+    inline document::view_range<document::table_view, table_id>       document::category_view::table_views()  const noexcept { return { doc, node->tables }; }
+    inline document::view_range<document::key_view, key_id>           document::category_view::key_views()    const noexcept { return { doc, node->keys }; }
+    inline document::view_range<document::column_view, column_id>     document::table_view::column_views()    const noexcept { return { doc, node->columns }; }
+    inline document::live_rows<document::table_row_view, row_id>      document::table_view::row_views()       const noexcept { return { doc, node->rows, node->erased_rows }; }
+    inline document::live_rows<row_id, row_id>                        document::table_view::rows()            const noexcept { return { doc, node->rows, node->erased_rows }; }
+
+//========================================================================
+// document member implementations
+//========================================================================
+
+    template<typename T>
+    document::slot_index & document::slots_for() noexcept
+    {
+        if constexpr      (std::is_same_v<T, category_node>)  { return category_slots_; }
+        else if constexpr (std::is_same_v<T, table_node>)     { return table_slots_; }
+        else if constexpr (std::is_same_v<T, column_node>)    { return column_slots_; }
+        else if constexpr (std::is_same_v<T, row_node>)       { return row_slots_; }
+        else if constexpr (std::is_same_v<T, key_node>)       { return key_slots_; }
+        else if constexpr (std::is_same_v<T, comment_node>)   { return comment_slots_; }
+        else if constexpr (std::is_same_v<T, paragraph_node>) { return paragraph_slots_; }
+        else static_assert(false, "Illegal node type");
     }
 
-    inline comment_id document::create_comment(std::string text)
+    template<typename T>
+    std::vector<T> & document::nodes() noexcept
     {
-        comment_id cid{comments_.size()};
-        comments_.push_back({.id = cid, .text = text});
-        return cid;
+        if constexpr      (std::is_same_v<T, category_node>)  { return categories_; }
+        else if constexpr (std::is_same_v<T, table_node>)     { return tables_; }
+        else if constexpr (std::is_same_v<T, column_node>)    { return columns_; }
+        else if constexpr (std::is_same_v<T, row_node>)       { return rows_; }
+        else if constexpr (std::is_same_v<T, key_node>)       { return keys_; }
+        else if constexpr (std::is_same_v<T, comment_node>)   { return comments_; }
+        else if constexpr (std::is_same_v<T, paragraph_node>) { return paragraphs_; }
+        else static_assert(false, "Illegal node type");
     }
 
-    inline paragraph_id document::create_paragraph(std::string text)
+    template<typename T>
+    T & document::insert_node(std::vector<T> & cont, T node)
     {
-        paragraph_id pid{paragraphs_.size()};
-        paragraphs_.push_back({.id = pid, .text = text});
-        return pid;
+        slots_for<T>().assign(node._id().val, cont.size());
+        cont.push_back(std::move(node));
+        index_name(cont.back());
+        track_contamination(cont.back());
+        return cont.back();
     }
 
-    inline void document::mark_key_contaminated(key_id id)
+    template<typename T>
+    bool document::erase_node(std::vector<T> & cont, typename T::id_type id)
     {
-        if (contaminated_source_keys_.contains(static_cast<size_t>(id)))
-            return;
+        auto & index = slots_for<T>();
+        size_t slot = index.find(id.val);
+        if (slot >= cont.size())
+            return false;
 
-        auto* kn = get_node(id);
-        if (!kn) return;
-        
-        // Mark key and value as contaminated
-        kn->contamination = contamination_state::contaminated;
-        kn->value.contamination = contamination_state::contaminated;
-        
-        // Register as source
-        contaminated_source_keys_.insert(static_cast<size_t>(id));
-        
-        // Propagate flags upward (but don't register containers)
-        if (kn->owner != invalid_id<category_tag>())
+        unindex_name(cont[slot]);
+        untrack_contamination(cont[slot]);
+        cont.erase(cont.begin() + slot);
+        index.remove(id.val);
+        reindex(cont, slot);
+        return true;
+    }
+
+    template<typename T, typename Pred>
+    size_t document::erase_nodes_if(std::vector<T> & cont, Pred pred)
+    {
+        auto first = std::ranges::find_if(cont, pred);
+        if (first == cont.end())
+            return 0;
+
+        size_t from = static_cast<size_t>(first - cont.begin());
+        auto & index = slots_for<T>();
+        for (auto it = first; it != cont.end(); ++it)
         {
-            auto* cat = get_node(kn->owner);
-            if (cat)
+            if (pred(*it))
             {
-                cat->contamination = contamination_state::contaminated;
-                propagate_contamination_up_category_chain(kn->owner);
+                unindex_name(*it);
+                untrack_contamination(*it);
+                index.remove(it->_id().val);
             }
         }
+
+        size_t erased = std::erase_if(cont, pred);
+        reindex(cont, from);
+        return erased;
     }
 
-    inline void document::mark_row_contaminated(row_id id)
+    template<typename T>
+    void document::reindex(std::vector<T> const & cont, size_t from)
     {
-        auto* rn = get_node(id);
-        if (!rn) return;
-        
-        // Mark row as contaminated
-        rn->contamination = contamination_state::contaminated;
-        
-        // Register as source
-        contaminated_source_rows_.insert(static_cast<size_t>(id));
-        
-        // Propagate to table
-        auto* tbl = get_node(rn->table);
-        if (tbl)
+        auto & index = slots_for<T>();
+        for (size_t i = from; i < cont.size(); ++i)
+            index.assign(cont[i]._id().val, i);
+    }
+
+    template<typename T>
+    T & document::place_node(std::vector<T> & cont, T node)
+    {
+        auto id = node._id();
+        auto & index = slots_for<T>();
+        size_t pos = static_cast<size_t>(std::ranges::lower_bound(cont, id.val, {}, [](T const & n) { return n._id().val; }) - cont.begin());
+
+        if constexpr (std::is_same_v<T, row_node>)
         {
-            tbl->contamination = contamination_state::contaminated;
-            
-            // Propagate to owning category
-            auto* cat = get_node(tbl->owner);
-            if (cat)
+            if (pos < cont.size() && cont[pos].id == id)
             {
-                cat->contamination = contamination_state::contaminated;
-                propagate_contamination_up_category_chain(tbl->owner);
+                cont[pos] = std::move(node);
+                index.assign(id.val, pos);
+                --erased_rows_;
+            }
+            else
+            {
+                // Tombstones have no slot to shift
+                cont.insert(cont.begin() + pos, std::move(node));
+                index.assign(id.val, pos);
+                for (size_t i = pos + 1; i < cont.size(); ++i)
+                    if (!is_erased(cont[i].id))
+                        index.assign(cont[i].id.val, i);
             }
         }
+        else
+        {
+            cont.insert(cont.begin() + pos, std::move(node));
+            reindex(cont, pos);
+        }
+
+        index_name(cont[pos]);
+        return cont[pos];
     }
 
-    inline void document::propagate_contamination_up_category_chain(category_id id)
+    template<typename T>
+    T document::take_node(std::vector<T> & cont, typename T::id_type id)
     {
-        auto* cat = get_node(id);
-        if (!cat) return;
-
-        auto parent_id = cat->parent;
-        if (parent_id == invalid_id<category_tag>())
-            return;
+        auto & index = slots_for<T>();
+        size_t slot = index.find(id.val);
 
-        auto* parent = get_node(parent_id);
-        if (!parent) return;
+        unindex_name(cont[slot]);
+        T node = std::move(cont[slot]);
+        index.remove(id.val);
 
-        if (parent->contamination == contamination_state::contaminated)
-            return;
-
-        parent->contamination = contamination_state::contaminated;
-        propagate_contamination_up_category_chain(parent_id);
+        if constexpr (std::is_same_v<T, row_node>)
+        {
+            cont[slot].id = id;
+            ++erased_rows_;
+        }
+        else
+        {
+            cont.erase(cont.begin() + slot);
+            reindex(cont, slot);
+        }
+        return node;
     }
 
-    inline bool document::key_is_clean(const key_node& k) const
+    inline bool document::erase_row_node(row_id id, bool listed)
     {
-        if (k.semantic != semantic_state::valid)
+        size_t slot = row_slots_.find(id.val);
+        if (slot >= rows_.size())
+            return false;
+
+        auto & rn = rows_[slot];
+        unindex_name(rn);
+        untrack_contamination(rn);
+        row_slots_.remove(id.val);
+        std::vector<typed_value>().swap(rn.cells);
+        ++erased_rows_;
+
+        if (listed)
+            if (auto * tbl = get_node(rn.table))
+                ++tbl->erased_rows;
+
+        return true;
+    }
+
+    inline void document::compact_rows() noexcept
+    {
+        if (erased_rows_ == 0)
+            return;
+
+        auto first = std::ranges::find_if(rows_, [this](row_node const & r) { return is_erased(r.id); });
+        size_t from = static_cast<size_t>(first - rows_.begin());
+
+        std::erase_if(rows_, [this](row_node const & r) { return is_erased(r.id); });
+        for (size_t i = from; i < rows_.size(); ++i)
+            row_slots_.assign(rows_[i].id.val, i);
+
+        erased_rows_ = 0;
+    }
+
+    inline void document::purge_erased_rows(table_node & t)
+    {
+        if (t.erased_rows == 0)
+            return;
+
+        // The name hashes move down with their rows; every row left is live
+        auto & lookup = t.lookup;
+        size_t kept = 0;
+        for (size_t pos = 0; pos < t.rows.size(); ++pos)
+        {
+            size_t slot = row_slots_.find(t.rows[pos].val);
+            if (slot >= rows_.size())
+                continue;
+
+            rows_[slot].listed_at = kept;
+            lookup.hashes[kept] = lookup.hashes[pos];
+            t.rows[kept++] = t.rows[pos];
+        }
+
+        t.rows.resize(kept);
+        std::erase_if(t.ordered_items, [this](source_item_ref const & item)
+        {
+            auto * rid = std::get_if<row_id>(&item.id);
+            return rid && is_erased(*rid);
+        });
+
+        lookup.hashes.resize(kept);
+        lookup.next_named.resize(kept);
+        lookup.erased_bits.assign((kept + 63) / 64, 0);
+        lookup.rehash();
+        lookup.rebuild_erased();
+        t.erased_rows = 0;
+    }
+
+    inline void document::compact_sparse(table_node * t)
+    {
+        if (t && t->erased_rows * 2 > t->rows.size())
+            purge_erased_rows(*t);
+        if (erased_rows_ * 2 > rows_.size())
+            compact_rows();
+    }
+
+    inline void document::compact()
+    {
+        for (auto & t : tables_)
+            purge_erased_rows(t);
+        compact_rows();
+    }
+
+    inline bool document::is_verbatim_source() const noexcept
+    {
+        return source_context_ && !categories_.empty() && categories_.front().extent.has_value();
+    }
+
+    inline void document::map_source_extents()
+    {
+        if (!source_context_ || !source_context_->document.source || categories_.empty())
+            return;
+
+        // Streamed sources have no complete text to copy from
+        std::string_view src = source_context_->document.source->text;
+        if (src.empty())
+            return;
+
+        // The extent of the root, from the first byte, is the whole
+        // document while it is unedited
+        auto & root = categories_.front();
+        char const * at = src.data();
+        size_t opens = 0;
+        map_items(root.ordered_items, src, at, opens);
+
+        root.extent.reset();
+        if (at)
+            root.extent = source_extent{0, size_t(at - src.data()), opens};
+    }
+
+    inline std::optional<document::source_extent>
+    document::map_extent(category_node & c, std::string_view src)
+    {
+        char const * at = nullptr;
+        if (c.creation == creation_state::authored && !c.is_edited && c.source_event_index_open)
+            at = source_context_->document.events[*c.source_event_index_open].text.data();
+
+        char const * begin = at;
+        size_t opens = 1;
+        follow_line(c.source_event_index_open, src, at);
+        map_items(c.ordered_items, src, at, opens);
+
+        c.extent.reset();
+        if (at)
+            c.extent = source_extent{size_t(begin - src.data()), size_t(at - src.data()), opens};
+        return c.extent;
+    }
+
+    inline std::optional<document::source_extent>
+    document::map_extent(table_node & t, std::string_view src)
+    {
+        char const * at = nullptr;
+        if (t.creation == creation_state::authored && !t.is_edited && t.source_event_index)
+            at = source_context_->document.events[*t.source_event_index].text.data();
+
+        char const * begin = at;
+        size_t opens = 0;
+        follow_line(t.source_event_index, src, at);
+        map_items(t.ordered_items, src, at, opens);
+
+        t.extent.reset();
+        if (at)
+            t.extent = source_extent{size_t(begin - src.data()), size_t(at - src.data()), 0};
+        return t.extent;
+    }
+
+    inline void document::map_items(std::vector<source_item_ref> const & items, std::string_view src,
+                                    char const *& at, size_t & opens)
+    {
+        // Nested regions are mapped whether or not this one maps
+        auto region = [&](auto & node)
+        {
+            auto ext = map_extent(node, src);
+            if (!at || !ext || at != src.data() + ext->begin)
+            {
+                at = nullptr;
+                return;
+            }
+            at     = src.data() + ext->end;
+            opens += ext->opens;
+        };
+
+        auto line = [&](auto const * node, bool row = false)
+        {
+            if (!node || node->creation != creation_state::authored || node->is_edited)
+                at = nullptr;
+            else
+                follow_line(node->source_event_index, src, at, row);
+        };
+
+        for (auto const & item : items)
+        {
+            std::visit([&](auto const & id)
+            {
+                using T = std::decay_t<decltype(id)>;
+
+                if constexpr (std::is_same_v<T, category_close_marker>)
+                {
+                    auto const * c = get_node(id.which);
+                    if (!c || c->creation != creation_state::authored || c->is_edited || opens == 0)
+                        at = nullptr;
+                    else
+                        follow_line(c->source_event_index_close, src, at);
+                    --opens;
+                }
+                else if constexpr (std::is_same_v<T, category_id> || std::is_same_v<T, table_id>)
+                {
+                    if (auto * node = get_node(id))
+                        region(*node);
+                    else
+                        at = nullptr;
+                }
+                else
+                    line(get_node(id), std::is_same_v<T, row_id>);
+            }, item.id);
+        }
+    }
+
+    inline void document::follow_line(std::optional<size_t> event, std::string_view src,
+                                      char const *& at, bool row) const
+    {
+        // A line follows when its text starts where the previous line
+        // ended and is itself ended by a newline, as replay writes it
+        if (!at || !event)
+        {
+            at = nullptr;
+            return;
+        }
+
+        auto text = source_context_->document.events[*event].text;
+        char const * end = text.data() + text.size();
+
+        // Synthesised text lives outside the source and never follows
+        bool inside = std::less_equal<>{}(src.data(), text.data())
+                   && std::less_equal<>{}(end, src.data() + src.size());
+
+        if (!inside || text.data() != at)
+            at = nullptr;
+        else if (row && !text.empty() && text.back() == '\n')
+            at = end;
+        else if (end < src.data() + src.size() && *end == '\n')
+            at = end + 1;
+        else
+            at = nullptr;
+    }
+
+    inline void document::mark_dirty(table_id id)
+    {
+        auto * t = get_node(id);
+        if (!t) return;
+
+        t->extent.reset();
+        mark_dirty(t->owner);
+    }
+
+    inline void document::mark_dirty(category_id id)
+    {
+        // Up to the root: an undo may have restored the extent of an
+        // ancestor above one already dropped
+        for (auto * c = get_node(id); c; c = get_node(c->parent))
+            c->extent.reset();
+    }
+
+    template<typename T>
+    void document::index_name(T const & node)
+    {
+        if constexpr (std::is_same_v<T, category_node>)
+        {
+            category_names_.add(node.name, node.id);
+            if (auto* parent = get_node(node.parent))
+                parent->child_names.add(node.name, node.id);
+        }
+        else if constexpr (std::is_same_v<T, key_node>)
+        {
+            key_names_.add(node.name, node.id);
+            if (auto* owner = get_node(node.owner))
+                owner->key_names.add(node.name, node.id);
+        }
+        else if constexpr (std::is_same_v<T, column_node>)
+        {
+            // Tables are inserted after their initial columns; those are
+            // indexed with the table below
+            if (auto* tbl = get_node(node.table))
+                tbl->column_names.add(node.col.name, node.col.id);
+        }
+        else if constexpr (std::is_same_v<T, table_node>)
+        {
+            auto & tbl = *get_node(node.id);
+            tbl.column_names.clear();
+            for (auto cid : tbl.columns)
+                if (auto* col = get_node(cid))
+                    tbl.column_names.add(col->col.name, cid);
+        }
+        else if constexpr (std::is_same_v<T, row_node>)
+        {
+            // A row not yet listed is indexed when its table lists it
+            auto * tbl = get_node(node.table);
+            size_t pos = node.listed_at;
+            if (tbl && pos < tbl->rows.size() && tbl->rows[pos] == node.id && tbl->lookup.erased_at(pos))
+            {
+                tbl->lookup.hashes[pos] = row_hash(node);
+                tbl->lookup.set_erased(pos, false);
+                tbl->lookup.link(pos);
+            }
+        }
+    }
+
+    template<typename T>
+    void document::unindex_name(T const & node)
+    {
+        if constexpr (std::is_same_v<T, category_node>)
+        {
+            category_names_.remove(node.name);
+            if (auto* parent = get_node(node.parent))
+                parent->child_names.remove(node.name);
+        }
+        else if constexpr (std::is_same_v<T, key_node>)
+        {
+            key_names_.remove(node.name);
+            if (auto* owner = get_node(node.owner))
+                owner->key_names.remove(node.name);
+        }
+        else if constexpr (std::is_same_v<T, column_node>)
+        {
+            if (auto* tbl = get_node(node.table))
+                tbl->column_names.remove(node.col.name);
+        }
+        else if constexpr (std::is_same_v<T, row_node>)
+        {
+            auto * tbl = get_node(node.table);
+            size_t pos = node.listed_at;
+            if (tbl && pos < tbl->rows.size() && tbl->rows[pos] == node.id && !tbl->lookup.erased_at(pos))
+            {
+                tbl->lookup.unlink(pos);
+                tbl->lookup.set_erased(pos, true);
+            }
+        }
+    }
+
+    template<typename T>
+    void document::track_contamination(T const & node)
+    {
+        if constexpr (std::is_same_v<T, category_node>)
+        {
+            if (node.contamination == contamination_state::contaminated)
+                if (auto* parent = get_node(node.parent))
+                    ++parent->contaminated_children;
+        }
+        else if constexpr (std::is_same_v<T, table_node>)
+        {
+            if (node.contamination == contamination_state::contaminated)
+                if (auto* owner = get_node(node.owner))
+                    ++owner->contaminated_children;
+        }
+    }
+
+    template<typename T>
+    void document::untrack_contamination(T const & node)
+    {
+        if constexpr (std::is_same_v<T, category_node>)
+        {
+            if (node.contamination == contamination_state::contaminated)
+                if (auto* parent = get_node(node.parent))
+                    --parent->contaminated_children;
+        }
+        else if constexpr (std::is_same_v<T, table_node>)
+        {
+            if (node.contamination == contamination_state::contaminated)
+                if (auto* owner = get_node(node.owner))
+                    --owner->contaminated_children;
+        }
+        else if constexpr (std::is_same_v<T, key_node> || std::is_same_v<T, row_node>)
+        {
+            unregister_source(node);
+        }
+    }
+
+    inline category_id document::create_root()
+    {
+        if (categories_.empty())
+        {
+            category_node root;
+            root.id     = category_id{0};
+            root.name   = symbols_.intern(detail::ROOT_CATEGORY_NAME);
+            root.parent = invalid_id<category_tag>();
+
+            insert_node(categories_, std::move(root));
+        }
+        assert (categories_.front().id == category_id{0});        
+        return category_id{0};
+    }    
+
+    inline category_id document::create_category( std::string_view name, category_id parent )
+    {
+        if (auto pcat = get_node(parent))
+        {
+            if (auto dup = category(name))
+                if (dup->parent()->id() == parent)
+                    return invalid_id<category_tag>();
+
+            auto id = create_category_id();
+            category_node node;
+            node.id     = id;
+            node.name   = symbols_.intern(name);
+            node.parent = parent;
+
+            insert_node(categories_, std::move(node));
+
+            // Re-acquire parent; the insertion may have reallocated
+            if (auto pnode = get_node(parent))
+                pnode->children.push_back(id);
+
+            return id;            
+        }
+
+        return invalid_id<category_tag>();
+    }
+
+    inline category_id document::create_category( category_id id, std::string_view name, category_id parent )
+    {
+        // Only root have the ID 0 or an invalid parent ID. Either of
+        // these being explicitly set is interpreted as an attempt to
+        // create the root category.
+        if (id == category_id{0} || parent == invalid_id<category_tag>())
+        {
+            if (categories_.empty())
+                return create_root();
+
+            return invalid_id<category_tag>();
+        }
+
+        category_node node;
+        node.id     = id;
+        node.name   = symbols_.intern(name);
+        node.parent = parent;
+
+        insert_node(categories_, std::move(node));
+
+        if (auto pnode = get_node(parent))
+            pnode->children.push_back(id);
+
+        return id;
+    }
+
+    inline comment_id document::create_comment(std::string text)
+    {
+        comment_id cid{comments_.size()};
+        insert_node(comments_, comment_node{.id = cid, .text = text});
+        return cid;
+    }
+
+    inline paragraph_id document::create_paragraph(std::string text)
+    {
+        paragraph_id pid{paragraphs_.size()};
+        insert_node(paragraphs_, paragraph_node{.id = pid, .text = text});
+        return pid;
+    }
+
+    inline void document::mark_key_contaminated(key_id id)
+    {
+        if (contaminated_source_keys_.contains(id.val))
+            return;
+
+        auto* kn = get_node(id);
+        if (!kn) return;
+        
+        // Mark key and value as contaminated
+        kn->contamination = contamination_state::contaminated;
+        kn->value.contamination = contamination_state::contaminated;
+        
+        register_source(*kn);
+    }
+
+    inline void document::register_source(key_node const & k)
+    {
+        contaminated_source_keys_.resize(k.id.val + 1);
+        contaminated_source_keys_.set(k.id.val);
+        
+        // Propagate flags upward (but don't register containers)
+        if (auto* cat = get_node(k.owner))
+        {
+            ++cat->contaminated_keys;
+            set_contamination(*cat, contamination_state::contaminated);
+            propagate_contamination_up_category_chain(k.owner);
+        }
+    }
+
+    inline void document::unregister_source(key_node const & k)
+    {
+        if (!contaminated_source_keys_.contains(k.id.val))
+            return;
+
+        contaminated_source_keys_.set(k.id.val, false);
+        if (auto* cat = get_node(k.owner))
+            --cat->contaminated_keys;
+    }
+
+    inline void document::mark_row_contaminated(row_id id)
+    {
+        auto* rn = get_node(id);
+        if (!rn) return;
+        
+        // Mark row as contaminated
+        rn->contamination = contamination_state::contaminated;
+        
+        if (!contaminated_source_rows_.contains(id.val))
+            register_source(*rn);
+    }
+
+    inline void document::register_source(row_node const & r)
+    {
+        contaminated_source_rows_.resize(r.id.val + 1);
+        contaminated_source_rows_.set(r.id.val);
+        
+        // Propagate to table
+        auto* tbl = get_node(r.table);
+        if (tbl)
+        {
+            ++tbl->contaminated_rows;
+            set_contamination(*tbl, contamination_state::contaminated);
+            
+            // Propagate to owning category
+            auto* cat = get_node(tbl->owner);
+            if (cat)
+            {
+                set_contamination(*cat, contamination_state::contaminated);
+                propagate_contamination_up_category_chain(tbl->owner);
+            }
+        }
+    }
+
+    inline void document::unregister_source(row_node const & r)
+    {
+        if (!contaminated_source_rows_.contains(r.id.val))
+            return;
+
+        contaminated_source_rows_.set(r.id.val, false);
+        if (auto* tbl = get_node(r.table))
+            --tbl->contaminated_rows;
+    }
+
+    inline void document::propagate_contamination_up_category_chain(category_id id)
+    {
+        auto* cat = get_node(id);
+        while (cat && cat->parent != invalid_id<category_tag>())
+        {
+            auto* parent = get_node(cat->parent);
+            if (!parent) return;
+
+            if (parent->contamination == contamination_state::contaminated)
+                return;
+
+            set_contamination(*parent, contamination_state::contaminated);
+            cat = parent;
+        }
+    }
+
+    inline void document::set_contamination(table_node & t, contamination_state state)
+    {
+        if (t.contamination == state)
+            return;
+
+        t.contamination = state;
+        if (auto* owner = get_node(t.owner))
+        {
+            if (state == contamination_state::contaminated) ++owner->contaminated_children;
+            else                                            --owner->contaminated_children;
+        }
+    }
+
+    inline void document::set_contamination(category_node & c, contamination_state state)
+    {
+        if (c.contamination == state)
+            return;
+
+        c.contamination = state;
+        if (auto* parent = get_node(c.parent))
+        {
+            if (state == contamination_state::contaminated) ++parent->contaminated_children;
+            else                                            --parent->contaminated_children;
+        }
+    }
+
+    inline bool document::key_is_clean(const key_node& k) const
+    {
+        if (k.semantic != semantic_state::valid)
             return false;
 
         if (k.value.contamination == contamination_state::contaminated)
@@ -772,7 +1947,7 @@ namespace nuno
         if (r.semantic != semantic_state::valid)
             return false;
         
-        for (auto& cell : r.cells)
+        return for_each_cell(r, [](typed_value const & cell)
         {
             if (cell.semantic == semantic_state::invalid ||
                 cell.contamination == contamination_state::contaminated)
@@ -789,9 +1964,8 @@ namespace nuno
                         return false;
                 }
             }
-        }
-        
-        return true;
+            return true;
+        });
     }
 
     inline bool document::table_is_clean(const table_node& t) const
@@ -799,6 +1973,10 @@ namespace nuno
         if (t.semantic != semantic_state::valid)
             return false;
         
+        // Rows are counted as they become or stop being sources
+        if (t.contaminated_rows != 0)
+            return false;
+
         // Check all columns
         for (auto col_id : t.columns)
         {
@@ -807,14 +1985,6 @@ namespace nuno
                 return false;
         }
         
-        // Check all rows
-        for (auto row_id : t.rows)
-        {
-            auto it = find_node_by_id(rows_, row_id);
-            if (it != rows_.end() && !row_is_clean(*it))
-                return false;
-        }
-        
         return true;
     }
 
@@ -823,35 +1993,29 @@ namespace nuno
         if (c.semantic != semantic_state::valid)
             return false;
         
-        // Check all keys
-        for (auto kid : c.keys)
-        {
-            auto it = find_node_by_id(keys_, kid);
-            if (it != keys_.end() && !key_is_clean(*it))
-                return false;
-        }
-        
-        // Check all tables
-        for (auto tid : c.tables)
-        {
-            auto it = find_node_by_id(tables_, tid);
-            if (it != tables_.end() && !table_is_clean(*it))
-                return false;
-        }
+        // Source keys, contaminated tables and contaminated
+        // subcategories are all counted on the category
+        return c.contaminated_keys == 0 && c.contaminated_children == 0;
+    }
+
+    inline bool document::request_clear_contamination(clearable_node node)
+    {
+        if (!may_clear_contamination(node))
+            return false;
         
-        // Check all subcategories
-        for (auto cid : c.children)
+        std::visit([this](auto id) 
         {
-            auto it = find_node_by_id(categories_, cid);
-            if (it != categories_.end() && 
-                it->contamination == contamination_state::contaminated)
-                return false;
-        }
+            using T = decltype(id);
+            if constexpr (std::is_same_v<T, key_id>)
+                clear_key_contamination(id);
+            else
+                clear_row_contamination(id);
+        }, node);
         
         return true;
     }
 
-    inline bool document::request_clear_contamination(clearable_node node)
+    inline bool document::may_clear_contamination(clearable_node node)
     {
         // Step 1: Validate node is actually clean
         bool is_clean = std::visit([this](auto id) -> bool 
@@ -873,20 +2037,7 @@ namespace nuno
             return false;
         
         // Step 2: Ask permission
-        if (!request_clear_fn(node))
-            return false;
-        
-        // Step 3: Perform clearing
-        std::visit([this](auto id) 
-        {
-            using T = decltype(id);
-            if constexpr (std::is_same_v<T, key_id>)
-                clear_key_contamination(id);
-            else
-                clear_row_contamination(id);
-        }, node);
-        
-        return true;
+        return request_clear_fn(node);
     }
 
     inline void document::clear_key_contamination(key_id id)
@@ -902,12 +2053,10 @@ namespace nuno
         kn->contamination = contamination_state::clean;
         kn->value.contamination = contamination_state::clean;
         
-        // Unregister as source
-        contaminated_source_keys_.erase(static_cast<size_t>(id));
+        unregister_source(*kn);
         
         // Try to clear parent category
-        if (kn->owner != invalid_id<category_tag>())
-            try_clear_category_contamination(kn->owner);
+        try_clear_category_contamination(kn->owner);
     }
 
     inline void document::clear_row_contamination(row_id id)
@@ -919,31 +2068,26 @@ namespace nuno
             return;
         
         rn->contamination = contamination_state::clean;
-        contaminated_source_rows_.erase(static_cast<size_t>(id));
         
-        auto* tbl = get_node(rn->table);
-        if (!tbl) return;
+        unregister_source(*rn);
+        try_clear_table_contamination(rn->table);
+    }
 
-        if (table_is_clean(*tbl))
-        {
-            tbl->contamination = contamination_state::clean;
-            try_clear_category_contamination(tbl->owner);
-        }
+    inline void document::try_clear_table_contamination(table_id id)
+    {
+        auto* tbl = get_node(id);
+        if (!tbl || !table_is_clean(*tbl))
+            return;
+
+        set_contamination(*tbl, contamination_state::clean);
+        try_clear_category_contamination(tbl->owner);
     }
 
     inline void document::try_clear_category_contamination(category_id id)
     {
-        auto* cat = get_node(id);
-        if (!cat) return;
-        
-        if (!category_is_clean(*cat))
-            return;
-        
-        cat->contamination = contamination_state::clean;
-        
-        // Continue up to parent
-        if (cat->parent != invalid_id<category_tag>())
-            try_clear_category_contamination(cat->parent);
+        // Walk up while each category becomes clean
+        for (auto* cat = get_node(id); cat && category_is_clean(*cat); cat = get_node(cat->parent))
+            set_contamination(*cat, contamination_state::clean);
     }
 
     inline std::optional<document::category_view>
@@ -958,7 +2102,7 @@ namespace nuno
     size_t document::category_count() const noexcept { return categories_.size(); }
     size_t document::table_count() const noexcept { return tables_.size(); }
     size_t document::column_count() const noexcept { return columns_.size(); }
-    size_t document::row_count() const noexcept { return rows_.size(); }
+    size_t document::row_count() const noexcept { return rows_.size() - erased_rows_; }
     size_t document::key_count() const noexcept { return keys_.size(); }
     size_t document::comment_count() const noexcept { return comments_.size(); }
     size_t document::paragraph_count() const noexcept { return paragraphs_.size(); }
@@ -983,32 +2127,75 @@ namespace nuno
 
     template<typename T>
     typename std::vector<T>::const_iterator
-    document::find_node_by_name(std::vector<T> const & cont, std::string_view name) const noexcept
+    document::find_node_by_name(std::vector<T> const & cont, symbol name) const noexcept
     {
-        return std::ranges::find_if(cont, [&name](auto const & node) {
+        return std::ranges::find_if(cont, [name](auto const & node) {
             return node._name() == name;
         });
     }
 
     std::optional<document::category_view> document::category(std::string_view name) const noexcept
     {
-        return to_view(categories_, find_node_by_name(categories_, name));
+        auto sym = symbols_.find(name);
+        if (!sym)
+            return std::nullopt;
+        return category(*sym);
     }
 
     std::optional<document::key_view> document::key(std::string_view name) const noexcept
     {
+        auto sym = symbols_.find(name);
+        if (!sym)
+            return std::nullopt;
+        return key(*sym);
+    }
+
+    inline std::optional<document::category_view> document::category(symbol name) const noexcept
+    {
+        category_id id;
+        auto found = category_names_.find(name, id);
+        if (found == name_index<category_id>::match::unique)
+            return category(id);
+        if (found == name_index<category_id>::match::none)
+            return std::nullopt;
+        return to_view(categories_, find_node_by_name(categories_, name));
+    }
+
+    inline std::optional<document::key_view> document::key(symbol name) const noexcept
+    {
+        key_id id;
+        auto found = key_names_.find(name, id);
+        if (found == name_index<key_id>::match::unique)
+            return key(id);
+        if (found == name_index<key_id>::match::none)
+            return std::nullopt;
         return to_view(keys_, find_node_by_name(keys_, name));
     }
 
     std::optional<size_t> document::table_view::column_index(std::string_view name) const noexcept
     {
+        auto sym = doc->symbols_.find(name);
+        if (!sym)
+            return std::nullopt;
+        return column_index(*sym);
+    }
+
+    inline std::optional<size_t> document::table_view::column_index(symbol name) const noexcept
+    {
+        column_id id;
+        auto found = node->column_names.find(name, id);
+        if (found == name_index<column_id>::match::unique)
+            return column_index(id);
+        if (found == name_index<column_id>::match::none)
+            return std::nullopt;
+
         auto & cols = node->columns;
 
         auto it = std::ranges::find_if(cols, [&](column_id col_id)
         {
             auto c = doc->column(col_id);
             if (c.has_value())
-                return c->name() == name;
+                return c->node->col.name == name;
             return false;
         });
 
@@ -1029,43 +2216,372 @@ namespace nuno
 
     std::optional<size_t> document::table_view::row_index(std::string_view name) const noexcept
     {
-        size_t i = 0;
-        for (auto const & rid : rows())
+        // Chains are in no particular order; the first listed row wins
+        auto const & lookup = node->lookup;
+        size_t first = npos();
+        lookup.for_each_named(std::hash<std::string_view>{}(name), [&](size_t pos)
         {
-            auto r = doc->row(rid);
-            if (r.has_value() && r->name() == name) return i;
-            ++i;
-        }
+            if (pos < first && doc->row_name(*doc->listed_row(*node, pos)) == name)
+                first = pos;
+        });
+
+        if (first != npos())
+            return lookup.ordinal(first);
         return std::nullopt;
     }
 
     std::optional<size_t> document::table_view::row_index(row_id id) const noexcept
     {
-        size_t i = 0;
-        for (auto const & rid : rows())
+        size_t slot = doc->row_slots_.find(id.val);
+        if (slot >= doc->rows_.size())
+            return std::nullopt;
+
+        size_t pos = doc->rows_[slot].listed_at;
+        if (pos < node->rows.size() && node->rows[pos] == id)
+            return node->lookup.ordinal(pos);
+        return std::nullopt;
+    }
+
+    inline std::vector<size_t> document::table_view::row_indices(std::string_view name) const
+    {
+        std::vector<size_t> out;
+        auto const & lookup = node->lookup;
+        lookup.for_each_named(std::hash<std::string_view>{}(name), [&](size_t pos)
+        {
+            if (doc->row_name(*doc->listed_row(*node, pos)) == name)
+                out.push_back(lookup.ordinal(pos));
+        });
+
+        std::ranges::sort(out);
+        return out;
+    }
+
+    inline size_t document::row_lookup::erased_words_before(size_t word) const noexcept
+    {
+        size_t count = 0;
+        for (size_t i = word; i > 0; i &= i - 1)
+            count += erased_tree[i];
+        return count;
+    }
+
+    inline size_t document::row_lookup::erased_before(size_t pos) const noexcept
+    {
+        uint64_t below = erased_bits[pos / 64] & ((uint64_t(1) << pos % 64) - 1);
+        return erased_words_before(pos / 64) + std::popcount(below);
+    }
+
+    template<typename F>
+    void document::row_lookup::for_each_named(size_t hash, F && fn) const
+    {
+        if (!buckets.empty())
+            for (size_t pos = buckets[hash & (buckets.size() - 1)]; pos != npos(); pos = next_named[pos])
+                if (hashes[pos] == hash)
+                    fn(pos);
+
+        for (size_t pos = linked; pos < hashes.size(); ++pos)
+            if (hashes[pos] == hash && !erased_at(pos))
+                fn(pos);
+    }
+
+    inline void document::row_lookup::reserve(size_t count)
+    {
+        hashes.reserve(count);
+        next_named.reserve(count);
+        erased_bits.reserve((count + 63) / 64);
+    }
+
+    inline void document::row_lookup::push(size_t hash, bool is_erased)
+    {
+        size_t pos = hashes.size();
+        hashes.push_back(hash);
+        next_named.push_back(npos());
+
+        if (pos % 64 == 0)
         {
-            if (rid == id) return i;
-            ++i;
+            erased_bits.push_back(0);
+
+            // The new node of the tree covers its word and the ones below it
+            if (size_t i = erased_bits.size(); !erased_tree.empty())
+                erased_tree.push_back(erased_words_before(i - 1) - erased_words_before(i & (i - 1)));
+        }
+
+        if (is_erased)
+            set_erased(pos, true);
+        if (hashes.size() - linked >= link_batch)
+            link_pending();
+    }
+
+    inline void document::row_lookup::pop()
+    {
+        size_t pos = hashes.size() - 1;
+        if (erased_at(pos))
+            set_erased(pos, false);
+        else
+            unlink(pos);
+
+        // No other node of the tree covers the last word
+        hashes.pop_back();
+        next_named.pop_back();
+        if (pos % 64 == 0)
+        {
+            erased_bits.pop_back();
+            if (!erased_tree.empty())
+                erased_tree.pop_back();
+        }
+        linked = std::min(linked, pos);
+    }
+
+    inline void document::row_lookup::insert(size_t pos, size_t hash, bool is_erased)
+    {
+        link_pending();
+
+        auto shift = [pos](size_t & i) { if (i != npos() && i >= pos) ++i; };
+        std::ranges::for_each(buckets, shift);
+        std::ranges::for_each(next_named, shift);
+        hashes.insert(hashes.begin() + pos, hash);
+        next_named.insert(next_named.begin() + pos, npos());
+
+        // Carry the top bit of each word into the next one
+        if (hashes.size() % 64 == 1)
+            erased_bits.push_back(0);
+        for (size_t w = erased_bits.size() - 1; w > pos / 64; --w)
+            erased_bits[w] = erased_bits[w] << 1 | erased_bits[w - 1] >> 63;
+
+        uint64_t & word = erased_bits[pos / 64];
+        uint64_t below = word & ((uint64_t(1) << pos % 64) - 1);
+        word = (word & ~below) << 1 | below | uint64_t(is_erased) << pos % 64;
+
+        linked = hashes.size();
+        rebuild_erased();
+        if (!is_erased)
+            link(pos);
+    }
+
+    inline void document::row_lookup::erase(size_t pos)
+    {
+        link_pending();
+        if (!erased_at(pos))
+            unlink(pos);
+
+        auto shift = [pos](size_t & i) { if (i != npos() && i > pos) --i; };
+        std::ranges::for_each(buckets, shift);
+        std::ranges::for_each(next_named, shift);
+        hashes.erase(hashes.begin() + pos);
+        next_named.erase(next_named.begin() + pos);
+
+        // Carry the bottom bit of each word into the one before it
+        uint64_t & word = erased_bits[pos / 64];
+        uint64_t mask = (uint64_t(1) << pos % 64) - 1;
+        word = (word >> 1 & ~mask) | (word & mask);
+        for (size_t w = pos / 64 + 1; w < erased_bits.size(); ++w)
+        {
+            erased_bits[w - 1] |= erased_bits[w] << 63;
+            erased_bits[w] >>= 1;
+        }
+        if (hashes.size() % 64 == 0)
+            erased_bits.pop_back();
+
+        linked = hashes.size();
+        rebuild_erased();
+    }
+
+    inline void document::row_lookup::set_erased(size_t pos, bool is_erased)
+    {
+        uint64_t bit = uint64_t(1) << pos % 64;
+        if (bool(erased_bits[pos / 64] & bit) == is_erased)
+            return;
+
+        erased_bits[pos / 64] ^= bit;
+        if (erased_tree.empty())
+            return rebuild_erased();
+
+        is_erased ? ++erased : --erased;
+        for (size_t i = pos / 64 + 1; i < erased_tree.size(); i += i & (~i + 1))
+            is_erased ? ++erased_tree[i] : --erased_tree[i];
+    }
+
+    inline void document::row_lookup::link(size_t pos) noexcept
+    {
+        // A position still waiting is chained with its batch
+        if (pos >= linked)
+            return;
+
+        auto & head = buckets[hashes[pos] & (buckets.size() - 1)];
+        next_named[pos] = std::exchange(head, pos);
+    }
+
+    inline void document::row_lookup::unlink(size_t pos) noexcept
+    {
+        if (pos >= linked)
+            return;
+
+        size_t * at = &buckets[hashes[pos] & (buckets.size() - 1)];
+        while (*at != pos)
+            at = &next_named[*at];
+        *at = std::exchange(next_named[pos], npos());
+    }
+
+    inline void document::row_lookup::link_pending()
+    {
+        if (buckets.size() < hashes.size())
+            return rehash();
+
+        for (size_t pos = linked; pos < hashes.size(); ++pos)
+            if (!erased_at(pos))
+                next_named[pos] = std::exchange(buckets[hashes[pos] & (buckets.size() - 1)], pos);
+        linked = hashes.size();
+    }
+
+    inline void document::row_lookup::rehash()
+    {
+        buckets.assign(std::bit_ceil(std::max<size_t>(hashes.size(), 8)), npos());
+        for (size_t pos = 0; pos < hashes.size(); ++pos)
+            next_named[pos] = erased_at(pos) ? npos()
+                            : std::exchange(buckets[hashes[pos] & (buckets.size() - 1)], pos);
+        linked = hashes.size();
+    }
+
+    inline void document::row_lookup::rebuild_erased()
+    {
+        erased = 0;
+        for (auto word : erased_bits)
+            erased += std::popcount(word);
+
+        erased_tree.clear();
+        if (erased == 0)
+            return;
+
+        size_t count = erased_bits.size();
+        erased_tree.assign(count + 1, 0);
+        for (size_t i = 1; i <= count; ++i)
+        {
+            erased_tree[i] += std::popcount(erased_bits[i - 1]);
+            if (size_t up = i + (i & (~i + 1)); up <= count)
+                erased_tree[up] += erased_tree[i];
+        }
+    }
+
+    inline size_t document::row_hash(row_node const & r) const
+    {
+        std::hash<std::string_view> hasher;
+        size_t hash = hasher({});
+        visit_cell(r, 0, [&](typed_value const & cell)
+        {
+            if (auto * text = std::get_if<std::string>(&cell.val))
+                hash = hasher(*text);
+            else
+                hash = hasher(cell.value_to_string());
+        });
+        return hash;
+    }
+
+    inline std::string document::row_name(row_node const & r) const
+    {
+        std::string name;
+        visit_cell(r, 0, [&name](typed_value const & cell) { name = cell.value_to_string(); });
+        return name;
+    }
+
+    inline document::row_node const * document::listed_row(table_node const & t, size_t pos) const noexcept
+    {
+        size_t slot = row_slots_.find(t.rows[pos].val);
+        return slot < rows_.size() ? &rows_[slot] : nullptr;
+    }
+
+    inline void document::index_rows(table_node & t)
+    {
+        auto & lookup = t.lookup;
+        size_t count = t.rows.size();
+        lookup.hashes.assign(count, 0);
+        lookup.next_named.assign(count, npos());
+        lookup.erased_bits.assign((count + 63) / 64, 0);
+
+        for (size_t pos = 0; pos < count; ++pos)
+        {
+            size_t slot = row_slots_.find(t.rows[pos].val);
+            if (slot >= rows_.size())
+            {
+                lookup.erased_bits[pos / 64] |= uint64_t(1) << pos % 64;
+                continue;
+            }
+            rows_[slot].listed_at = pos;
+            lookup.hashes[pos] = row_hash(rows_[slot]);
+        }
+
+        lookup.rehash();
+        lookup.rebuild_erased();
+    }
+
+    inline void document::index_listed_row(table_node & t, size_t pos)
+    {
+        size_t slot = row_slots_.find(t.rows[pos].val);
+        auto * rn = slot < rows_.size() ? &rows_[slot] : nullptr;
+        size_t hash = rn ? row_hash(*rn) : 0;
+
+        if (pos + 1 == t.rows.size())
+            t.lookup.push(hash, !rn);
+        else
+        {
+            // Inserting in the middle shifts every later position
+            for (size_t i = pos + 1; i < t.rows.size(); ++i)
+                if (size_t s = row_slots_.find(t.rows[i].val); s < rows_.size())
+                    rows_[s].listed_at = i;
+            t.lookup.insert(pos, hash, !rn);
+        }
+
+        if (rn)
+            rn->listed_at = pos;
+    }
+
+    inline void document::unindex_listed_row(table_node & t, size_t pos)
+    {
+        if (pos + 1 == t.rows.size())
+            return t.lookup.pop();
+
+        for (size_t i = pos + 1; i < t.rows.size(); ++i)
+            if (size_t s = row_slots_.find(t.rows[i].val); s < rows_.size())
+                rows_[s].listed_at = i - 1;
+        t.lookup.erase(pos);
+    }
+
+    inline void document::rename_listed_row(row_node const & r)
+    {
+        auto * tbl = get_node(r.table);
+        size_t pos = r.listed_at;
+        if (!tbl || pos >= tbl->rows.size() || tbl->rows[pos] != r.id || tbl->lookup.erased_at(pos))
+            return;
+
+        auto & lookup = tbl->lookup;
+        if (size_t hash = row_hash(r); hash != lookup.hashes[pos])
+        {
+            lookup.unlink(pos);
+            lookup.hashes[pos] = hash;
+            lookup.link(pos);
         }
-        return std::nullopt;
     }
 
     template<typename T>
     typename std::vector<T>::iterator
     document::find_node_by_id(std::vector<T> & cont, typename T::id_type id) noexcept
     {
-        return std::ranges::find_if(cont, [id](auto const & node) {
-            return node._id() == id;
-        });
+        size_t slot = slots_for<T>().find(id.val);
+        if (slot >= cont.size())
+            return cont.end();
+
+        assert (cont[slot]._id() == id && "Slot index out of sync with node storage");
+        return cont.begin() + slot;
     }
 
     template<typename T>
     typename std::vector<T>::const_iterator
     document::find_node_by_id(std::vector<T> const & cont, typename T::id_type id) const noexcept
     {
-        return std::ranges::find_if(cont, [id](auto const & node) {
-            return node._id() == id;
-        });
+        size_t slot = slots_for<T>().find(id.val);
+        if (slot >= cont.size())
+            return cont.end();
+
+        assert (cont[slot]._id() == id && "Slot index out of sync with node storage");
+        return cont.begin() + slot;
     }
 
     inline std::optional<document::category_view>
@@ -1094,8 +2610,24 @@ namespace nuno
     std::optional<document::category_view> 
     document::category_view::child(std::string_view name) const noexcept
     {
+        auto sym = doc->symbols_.find(name);
+        if (!sym)
+            return std::nullopt;
+        return child(*sym);
+    }
+
+    inline std::optional<document::category_view> 
+    document::category_view::child(symbol name) const noexcept
+    {
+        category_id id;
+        auto found = node->child_names.find(name, id);
+        if (found == name_index<category_id>::match::unique)
+            return doc->category(id);
+        if (found == name_index<category_id>::match::none)
+            return std::nullopt;
+
         for (auto child_id : node->children)
-            if (auto child_view = doc->category(child_id); child_view.has_value() && child_view->name() == name)
+            if (auto child_view = doc->category(child_id); child_view.has_value() && child_view->node->name == name)
                 return child_view;
         return std::nullopt;
     }
@@ -1103,8 +2635,24 @@ namespace nuno
     std::optional<document::key_view> 
     document::category_view::key(std::string_view name) const noexcept
     {
+        auto sym = doc->symbols_.find(name);
+        if (!sym)
+            return std::nullopt;
+        return key(*sym);
+    }
+
+    inline std::optional<document::key_view> 
+    document::category_view::key(symbol name) const noexcept
+    {
+        key_id id;
+        auto found = node->key_names.find(name, id);
+        if (found == name_index<key_id>::match::unique)
+            return doc->key(id);
+        if (found == name_index<key_id>::match::none)
+            return std::nullopt;
+
         for (auto kid : node->keys)
-            if (auto k_view = doc->key(kid); k_view.has_value() && k_view->name() == name)
+            if (auto k_view = doc->key(kid); k_view.has_value() && k_view->node->name == name)
                 return k_view;
         return std::nullopt;
     }
@@ -1133,8 +2681,23 @@ namespace nuno
     }
     std::optional<document::column_view> document::table_view::column( std::string_view name ) const noexcept
     {
+        auto sym = doc->symbols_.find(name);
+        if (!sym)
+            return std::nullopt;
+        return column(*sym);
+    }
+
+    inline std::optional<document::column_view> document::table_view::column( symbol name ) const noexcept
+    {
+        column_id id;
+        auto found = node->column_names.find(name, id);
+        if (found == name_index<column_id>::match::unique)
+            return doc->column(id);
+        if (found == name_index<column_id>::match::none)
+            return std::nullopt;
+
         for (auto col_id : columns())
-            if (auto col = doc->column(col_id); col->name() == name)
+            if (auto col = doc->column(col_id); col->node->col.name == name)
                 return col;
         return std::nullopt;
     }
@@ -1157,6 +2720,184 @@ namespace nuno
         return *table().row_index(id());
     }
 
+    inline document::cell_range document::table_row_view::cells() const
+    {
+        return { *doc, *node };
+    }
+
+    inline std::string document::table_row_view::name() const noexcept
+    {
+        std::string name;
+        doc->visit_cell(*node, 0, [&name](typed_value const & cell) { name = cell.value_to_string(); });
+        return name;
+    }
+
+//========================================================================
+// Columnar tables
+//========================================================================
+
+    inline column_store const * document::store_of(row_node const & r) const noexcept
+    {
+        auto it = find_node_by_id(tables_, r.table);
+        return it != tables_.end() ? it->store.get() : nullptr;
+    }
+
+    inline bool document::make_columnar(table_node & t)
+    {
+        if (t.store)
+            return true;
+
+        purge_erased_rows(t);
+        for (auto rid : t.rows)
+        {
+            auto * rn = get_node(rid);
+            if (!rn || rn->cells.size() != t.columns.size())
+                return false;
+        }
+
+        auto store = std::make_unique<column_store>();
+        store->columns.resize(t.columns.size());
+
+        for (auto rid : t.rows)
+        {
+            auto * rn = get_node(rid);
+            for (size_t c = 0; c < rn->cells.size(); ++c)
+                store->columns[c].push_back(rn->cells[c]);
+
+            rn->store_index = store->row_count++;
+            std::vector<typed_value>().swap(rn->cells);
+        }
+
+        t.store = std::move(store);
+        return true;
+    }
+
+    inline std::unique_ptr<column_store> document::make_row_oriented(table_node & t)
+    {
+        if (!t.store)
+            return nullptr;
+
+        for (auto rid : t.rows)
+        {
+            auto * rn = get_node(rid);
+            if (!rn || !rn->cells.empty())
+                continue;
+
+            rn->cells.reserve(t.store->columns.size());
+            for (auto const & col : t.store->columns)
+                rn->cells.push_back(col.at(rn->store_index));
+        }
+
+        return std::move(t.store);
+    }
+
+    inline void document::restore_columnar(table_node & t, std::unique_ptr<column_store> store)
+    {
+        for (auto rid : t.rows)
+            if (auto * rn = get_node(rid))
+                std::vector<typed_value>().swap(rn->cells);
+
+        t.store = std::move(store);
+    }
+
+    inline std::span<const typed_value> document::row_cells(row_node const & r, std::vector<typed_value> & scratch) const
+    {
+        auto const * store = store_of(r);
+        if (!store)
+            return r.cells;
+
+        scratch.resize(store->columns.size());
+        for (size_t c = 0; c < scratch.size(); ++c)
+            store->columns[c].read(r.store_index, scratch[c]);
+        return scratch;
+    }
+
+    template<typename F>
+    bool document::for_each_cell(row_node const & r, F && fn) const
+    {
+        auto const * store = store_of(r);
+
+        if (!store)
+        {
+            for (auto const & cell : r.cells)
+                if (!fn(cell))
+                    return false;
+            return true;
+        }
+
+        typed_value cell;
+        for (auto const & col : store->columns)
+        {
+            col.read(r.store_index, cell);
+            if (!fn(std::as_const(cell)))
+                return false;
+        }
+        return true;
+    }
+
+    template<typename F>
+    bool document::visit_cell(row_node const & r, size_t index, F && fn) const
+    {
+        auto const * store = store_of(r);
+
+        if (!store)
+        {
+            if (index >= r.cells.size())
+                return false;
+            fn(r.cells[index]);
+            return true;
+        }
+
+        if (index >= store->columns.size())
+            return false;
+        fn(store->columns[index].at(r.store_index));
+        return true;
+    }
+
+
+//========================================================================
+// Snapshots
+//========================================================================
+
+    inline document::snapshot document::take_snapshot() const
+    {
+        return snapshot
+        {
+            category_names_, key_names_,
+            categories_, tables_, columns_, rows_, keys_, comments_, paragraphs_,
+            category_slots_, table_slots_, column_slots_, row_slots_,
+            key_slots_, comment_slots_, paragraph_slots_,
+            contaminated_source_keys_, contaminated_source_rows_,
+            erased_rows_
+        };
+    }
+
+    inline void document::restore(snapshot && s)
+    {
+        category_names_ = std::move(s.category_names);
+        key_names_      = std::move(s.key_names);
+
+        categories_ = std::move(s.categories);
+        tables_     = std::move(s.tables);
+        columns_    = std::move(s.columns);
+        rows_       = std::move(s.rows);
+        keys_       = std::move(s.keys);
+        comments_   = std::move(s.comments);
+        paragraphs_ = std::move(s.paragraphs);
+
+        category_slots_  = std::move(s.category_slots);
+        table_slots_     = std::move(s.table_slots);
+        column_slots_    = std::move(s.column_slots);
+        row_slots_       = std::move(s.row_slots);
+        key_slots_       = std::move(s.key_slots);
+        comment_slots_   = std::move(s.comment_slots);
+        paragraph_slots_ = std::move(s.paragraph_slots);
+
+        contaminated_source_keys_ = std::move(s.contaminated_source_keys);
+        contaminated_source_rows_ = std::move(s.contaminated_source_rows);
+
+        erased_rows_ = s.erased_rows;
+    }
 
     namespace 
     {
@@ -1173,7 +2914,7 @@ namespace nuno
     std::vector<document::category_view>  document::categories() const noexcept { return collect_views<category_view>(this, categories_); }
     std::vector<document::table_view>     document::tables()     const noexcept { return collect_views<table_view>(this, tables_); }
     std::vector<document::column_view>    document::columns()    const noexcept { return collect_views<column_view>(this, columns_); }
-    std::vector<document::table_row_view> document::rows()       const noexcept { return collect_views<table_row_view>(this, rows_); }
+    std::vector<document::table_row_view> document::rows()       const noexcept { auto live = rows_range(); return { live.begin(), live.end() }; }
     std::vector<document::key_view>       document::keys()       const noexcept { return collect_views<key_view>(this, keys_); }
 
 } // namespace nuno
@@ -8,6 +8,10 @@
 
 #include "nuno_document.hpp"
 
+#include <exception>
+#include <unordered_set>
+#include <utility>
+
 namespace nuno
 {
     // Convenience method
@@ -94,12 +98,29 @@ namespace nuno
         template<typename Tag> table_id insert_table_after( id<Tag> anchor, std::vector<std::string> column_names );
         template<typename Tag> table_id insert_table_after( id<Tag> anchor, std::vector<std::pair<std::string, std::optional<value_type>>> columns );
 
+    // Storage layout
+    //----------------------------
+        // Stores the cells of a table per row or per column. A columnar
+        // table stays columnar through append_rows, set_column_type and
+        // moving or erasing rows; other edits of its rows, columns or
+        // cells return it to row layout.
+        bool set_table_layout( table_id table, table_layout layout );
+
     // Rows
     //----------------------------        
         bool erase_row(row_id id);
 
         row_id append_row( table_id table, std::vector<value> cells );
 
+        // Appends many rows at once, moving their values out of rows.
+        // Storage is reserved once and the column types are resolved
+        // once; cells are checked and rows contaminated as by append_row.
+        // A columnar table stays columnar, its new cells going straight
+        // into the column store; make a table columnar before a large
+        // import to spare the per-row cell vectors.
+        // The rows get consecutive IDs starting with the one returned.
+        row_id append_rows( table_id table, std::span<std::vector<value>> rows );
+
         template<typename Tag> row_id insert_row_before(id<Tag> anchor, std::vector<value> cells);
         template<typename Tag> row_id insert_row_after(id<Tag> anchor, std::vector<value> cells);
 
@@ -146,6 +167,55 @@ namespace nuno
         bool set_key_type( key_id id, value_type type, type_ascription ascription = type_ascription::declared );
         bool set_column_type( column_id id, value_type type, type_ascription ascription = type_ascription::declared );
 
+    //============================================================
+    // Batches
+    //============================================================
+
+        enum class batch_failure
+        {
+            keep,      // A failed commit keeps the edits of the batch
+            rollback   // A failed commit restores the document as it was when the batch began
+        };
+
+        class batch;
+
+        // Opens a batch of edits. Edits in a batch store and validate
+        // their values as usual but defer marking and clearing
+        // contamination to the commit, which re-evaluates each key, row,
+        // table and category the batch touched once. The document is then
+        // as the same edits would have left it without a batch.
+        // Contamination flags read during a batch may be stale.
+        // A batch opened while another is open joins it.
+        [[nodiscard]] batch begin_batch( batch_failure on_failure = batch_failure::keep );
+
+    //============================================================
+    // History
+    //============================================================
+
+        // Records each edit so it can be undone and redone. An edit, or
+        // a batch, is one step. A step journals what its edit replaced:
+        // the prior state of the nodes it changed, the positions of the
+        // list entries it inserted or erased, and the contamination
+        // flags and counts of their ancestors, so its size and the time
+        // to undo or redo it follow the edit, not the document.
+        // While history is on, an erased row leaves the row lists of its
+        // table at once rather than when they are purged. Edits made
+        // past this editor break the history.
+        // Returns false, changing nothing, while a batch is open.
+        // Turning history off discards it.
+        bool enable_history( bool enabled = true );
+        bool history_enabled() const noexcept { return history_ != nullptr; }
+
+        // Undo the last step, or redo the last undone one, restoring the
+        // document exactly, IDs included. Return false if there is none
+        // or a batch is open. A new step discards the undone ones.
+        // Views taken before an undo or redo dangle.
+        bool undo();
+        bool redo();
+
+        bool can_undo() const noexcept { return history_ && !history_->undo.empty(); }
+        bool can_redo() const noexcept { return history_ && !history_->redo.empty(); }
+
     //============================================================
     // Low-level access to document internals
     //============================================================
@@ -174,6 +244,243 @@ namespace nuno
 
         document& doc_;
 
+    //========================================================
+    // Batch state
+    //========================================================
+
+        // Entities touched by a batch, in order of first touch. For keys
+        // and rows it also holds whether each is a source as of the
+        // batch, and whether a clear of it succeeded.
+        template<typename Tag>
+        struct dirty_list
+        {
+            std::vector<id<Tag>> ids;
+            detail::dense_bitset seen;
+            detail::dense_bitset source;
+            detail::dense_bitset cleared;
+
+            // Returns whether the entity was touched for the first time
+            bool touch(id<Tag> i)
+            {
+                if (seen.contains(i.val))
+                    return false;
+                seen.resize(i.val + 1);
+                source.resize(i.val + 1);
+                cleared.resize(i.val + 1);
+                seen.set(i.val);
+                ids.push_back(i);
+                return true;
+            }
+        };
+
+        struct batch_state
+        {
+            batch_failure                     on_failure;
+            std::optional<document::snapshot> before;  // with batch_failure::rollback
+            bool                              step {false};  // holds a history step open
+
+            dirty_list<key_tag>      keys;
+            dirty_list<row_tag>      rows;
+            dirty_list<table_tag>    tables;
+            dirty_list<category_tag> categories;
+        };
+
+        std::unique_ptr<batch_state> batch_;
+
+        // Contamination requests of edits. While a batch is open they set
+        // the flags of the key or row at once, as without a batch, and
+        // defer its registration as a source and the re-evaluation of
+        // its ancestors to the commit.
+        void mark_contaminated( key_id id );
+        void mark_contaminated( row_id id );
+        bool request_clear( document::clearable_node node );  // false when deferred
+        void reevaluate( table_id id );
+        void reevaluate( category_id id );
+
+        bool commit_batch();
+        bool rollback_batch();
+
+    //========================================================
+    // History state
+    //========================================================
+
+        // The ID lists of categories and tables a step edits by position
+        enum class list_kind : uint8_t
+        {
+            children, tables, keys, category_items,  // of a category
+            rows, table_items                        // of a table
+        };
+
+        // Journal entries. Replaying an entry swaps what it holds with
+        // the document, so the same entry undoes and then redoes.
+
+        // A node as it was, absent if it did not exist. Keys and rows
+        // also hold whether they were sources. The cells of a columnar
+        // row stay in its slot of the store, which replay finds as the
+        // step left it.
+        template<typename Node>
+        struct node_image
+        {
+            typename Node::id_type id;
+            std::optional<Node>    node {};
+            bool                   source {false};
+        };
+
+        // The parts of a table or category other nodes' edits change
+        struct table_header
+        {
+            table_id               id;
+            document::node<>       flags;
+            std::vector<column_id> columns;
+            size_t                 contaminated_rows;
+        };
+
+        struct category_header
+        {
+            category_id                 id;
+            document::node<false, true> flags;
+            size_t                      contaminated_keys;
+            size_t                      contaminated_children;
+        };
+
+        // An entry inserted into or erased from a list
+        struct list_edit
+        {
+            list_kind                 list;
+            size_t                    owner;
+            size_t                    pos;
+            document::source_item_ref item;
+            bool                      present;  // whether item is at pos
+        };
+
+        // A change of table layout. Holds the store a table left for row
+        // layout, so replay puts back the very slots its rows point to,
+        // and the store indices its rows had before the change, which
+        // building a store renumbers.
+        struct layout_change
+        {
+            table_id                                id;
+            std::unique_ptr<column_store>           store;
+            std::vector<std::pair<row_id, size_t>> store_indices;
+        };
+
+        // The metadata of a column of a columnar table
+        struct column_cells
+        {
+            table_id        table;
+            size_t          column;
+            column_metadata metadata;
+        };
+
+        // One column of the rows of a table: the cell each row holds
+        // there in row layout, and the flags and source state of the
+        // row, which edits of the column change. An inserted column is
+        // held by the rows and not the entry, an erased one the reverse.
+        enum class column_edit : uint8_t { cells, inserted, erased };
+
+        struct column_rows
+        {
+            struct row_state
+            {
+                row_id                     id;
+                document::node<>           flags;
+                bool                       source;
+                std::optional<typed_value> cell;
+            };
+
+            table_id               table;
+            size_t                 column;
+            column_edit            edit;
+            std::vector<row_state> rows;
+        };
+
+        using journal_entry = std::variant<
+            node_image<document::category_node>,
+            node_image<document::table_node>,
+            node_image<document::column_node>,
+            node_image<document::row_node>,
+            node_image<document::key_node>,
+            node_image<document::comment_node>,
+            node_image<document::paragraph_node>,
+            table_header,
+            category_header,
+            list_edit,
+            layout_change,
+            column_cells,
+            column_rows>;
+
+        using journal_step = std::vector<journal_entry>;
+
+        struct history_state
+        {
+            std::vector<journal_step> undo;
+            std::vector<journal_step> redo;
+
+            journal_step                 step;    // being recorded
+            std::unordered_set<uint64_t> kept;    // entries of step, by kind and ID
+            int                          depth {0};  // open edits, and an open batch
+            bool                         replaying {false};
+        };
+
+        std::unique_ptr<history_state> history_;
+
+        // Opens a step at each public edit; the outermost closes it,
+        // keeping it unless it journalled nothing
+        struct [[nodiscard]] step_scope
+        {
+            editor * ed;
+            ~step_scope() { if (ed) ed->close_step(); }
+        };
+
+        step_scope open_step();
+        void close_step();
+        void discard_step();  // the edits of the step were rolled back
+
+        bool recording() const noexcept { return history_ && history_->depth > 0 && !history_->replaying; }
+
+        template<typename Entry, size_t I = 0>
+        static constexpr uint64_t entry_kind() noexcept
+        {
+            if constexpr (std::is_same_v<std::variant_alternative_t<I, journal_entry>, Entry>) return I;
+            else return entry_kind<Entry, I + 1>();
+        }
+
+        // Whether an entity is journalled for the first time in the step
+        template<typename Entry>
+        bool first_in_step( size_t id ) { return history_->kept.insert(entry_kind<Entry>() << 56 | id).second; }
+
+        // Journal an entity before an edit first changes it. A node is
+        // journalled with the headers of its ancestors, whose flags and
+        // counts its contamination reaches.
+        template<typename Tag> void journal( id<Tag> id );
+        template<typename Tag> void journal_created( id<Tag> id );
+        void journal_header( table_id id );
+        void journal_header( category_id id );
+        void journal_column( document::table_node const & tbl, size_t column, column_edit edit );
+
+        // Drop the source extents an edit of an entity or ID list
+        // invalidates, so the serializer regenerates its region. Done
+        // by the journal helpers, which every edit calls first.
+        template<typename Tag> void mark_dirty( id<Tag> id );
+        void mark_dirty( list_kind list, size_t owner );
+
+        // Edit an ID list by position, journalled. Erasing removes every
+        // entry equal to item.
+        template<typename T>
+        void list_insert( list_kind list, size_t owner, std::vector<T> & items, size_t pos, T item );
+
+        template<typename T>
+        void list_erase( list_kind list, size_t owner, std::vector<T> & items, T const & item );
+
+        void replay( journal_step & step, bool backwards );
+        template<typename Node> void replay_entry( node_image<Node> & image );
+        void replay_entry( table_header & header );
+        void replay_entry( category_header & header );
+        void replay_entry( list_edit & edit );
+        void replay_entry( layout_change & change );
+        void replay_entry( column_cells & cells );
+        void replay_entry( column_rows & column );
+
     //========================================================
     // Internal helpers; not exposed for clients
     //========================================================
@@ -193,36 +500,715 @@ namespace nuno
             std::function<void()> mark_contaminated,
             std::function<void()> try_clear);        
 
+        // Fetches a table for mutation of its rows or cells, returning
+        // it to row layout if it is columnar
+        document::table_node* row_layout_table( table_id table );
+
+        // The store indices of the rows of a table, and their exchange
+        // with ones recorded by a layout change
+        std::vector<std::pair<row_id, size_t>> store_indices( document::table_node const & t ) const;
+        void swap_store_indices( std::vector<std::pair<row_id, size_t>> & indices );
+
         template<typename Tag>
         row_id insert_row_impl( id<Tag> anchor, std::vector<value> cells, insert_direction dir);
 
-        template<typename EntityId, typename NodeType>
-        bool erase_category_child( EntityId id, std::vector<NodeType>& storage);
+        void move_row_impl( row_id row, row_id anchor, insert_direction dir );
+
+        template<typename EntityId, typename NodeType>
+        bool erase_category_child( EntityId id, std::vector<NodeType>& storage);
+
+        category_id  create_category_node_only( category_id parent, std::string_view name);
+        key_id       create_key_node_only( category_id where, std::string_view name, value v, bool untyped);
+        table_id     create_table_node_only( category_id where, std::vector<std::pair<std::string, std::optional<value_type>>> columns);
+        column_id    create_column_node_only( table_id table, std::string_view name, std::optional<value_type> declared_type);
+        row_id create_row_node_only( table_id table, std::vector<typed_value> cells);
+
+        // Fills a new cell of a column declaring type, setting invalid
+        // if the value does not hold that type
+        void make_table_cell( typed_value& tv, value&& val, value_type declared_type, bool& invalid );
+        comment_id   create_comment_node_only( category_id where, std::string_view text);
+        paragraph_id create_paragraph_node_only( category_id where, std::string_view text);
+
+        // Generic insertion helper - creates node, adds to semantic collection, inserts at position
+        template<typename EntityId, typename Tag, typename CreateFn>
+        EntityId insert_category_child_before_impl( id<Tag> anchor, CreateFn&& create_fn);
+
+        template<typename EntityId, typename Tag, typename CreateFn>
+        EntityId insert_category_child_after_impl( id<Tag> anchor, CreateFn&& create_fn);
+
+        template<typename EntityId, typename AnchorTag>
+        bool move_before(EntityId item, id<AnchorTag> anchor);   
+    };
+
+    // Scope guard of an editor batch. Commits when it goes out of scope,
+    // or rolls back if it does so during stack unwinding and the batch
+    // was opened with batch_failure::rollback.
+    class editor::batch
+    {
+    public:
+        batch(batch && other) noexcept : ed_(std::exchange(other.ed_, nullptr)), unwinding_(other.unwinding_) {}
+        batch & operator=(batch &&) = delete;
+        ~batch();
+
+        // Runs the deferred contamination pass and closes the batch.
+        // Returns false if the batch left a key or row contaminated that
+        // was not contaminated when it began, after rolling back (see
+        // rollback) if the batch was opened with batch_failure::rollback.
+        bool commit();
+
+        // Restores the document as it was when the batch began and closes
+        // the batch. Returns false, leaving the batch open, if it was not
+        // opened with batch_failure::rollback. IDs handed out in the
+        // batch are not reused. Views taken before a rollback dangle.
+        bool rollback();
+
+        // False once committed or rolled back, and for a batch that
+        // joined an enclosing one
+        bool is_open() const noexcept { return ed_ != nullptr; }
+
+    private:
+        friend class editor;
+        explicit batch(editor * ed) noexcept : ed_(ed) {}
+
+        editor * ed_;
+        int      unwinding_ {std::uncaught_exceptions()};
+    };
+
+//================================================================================================================
+//
+// Editor implementations
+//
+//================================================================================================================
+
+//========================================================
+// Batches
+//========================================================
+
+    inline editor::batch editor::begin_batch(batch_failure on_failure)
+    {
+        if (batch_)
+            return batch{nullptr};
+
+        batch_ = std::make_unique<batch_state>();
+        batch_->on_failure = on_failure;
+        if (on_failure == batch_failure::rollback)
+            batch_->before = doc_.take_snapshot();
+
+        // The batch is one history step
+        if (history_)
+        {
+            ++history_->depth;
+            batch_->step = true;
+        }
+
+        return batch{this};
+    }
+
+    inline editor::batch::~batch()
+    {
+        if (!ed_)
+            return;
+
+        if (std::uncaught_exceptions() > unwinding_ && ed_->rollback_batch())
+            return;
+        ed_->commit_batch();
+    }
+
+    inline bool editor::batch::commit()
+    {
+        if (!ed_)
+            return true;
+        return std::exchange(ed_, nullptr)->commit_batch();
+    }
+
+    inline bool editor::batch::rollback()
+    {
+        if (!ed_ || !ed_->rollback_batch())
+            return false;
+        ed_ = nullptr;
+        return true;
+    }
+
+    inline void editor::mark_contaminated(key_id id)
+    {
+        if (!batch_)
+            return doc_.mark_key_contaminated(id);
+
+        auto& keys = batch_->keys;
+        if (keys.touch(id))
+            keys.source.set(id.val, doc_.contaminated_source_keys_.contains(id.val));
+        if (keys.source.test(id.val))
+            return;
+
+        auto* kn = doc_.get_node(id);
+        if (!kn) return;
+
+        kn->contamination = contamination_state::contaminated;
+        kn->value.contamination = contamination_state::contaminated;
+        keys.source.set(id.val);
+    }
+
+    inline void editor::mark_contaminated(row_id id)
+    {
+        if (!batch_)
+            return doc_.mark_row_contaminated(id);
+
+        auto* rn = doc_.get_node(id);
+        if (!rn) return;
+
+        rn->contamination = contamination_state::contaminated;
+
+        auto& rows = batch_->rows;
+        if (rows.touch(id))
+            rows.source.set(id.val, doc_.contaminated_source_rows_.contains(id.val));
+        rows.source.set(id.val);
+    }
+
+    inline bool editor::request_clear(document::clearable_node node)
+    {
+        if (!batch_)
+            return doc_.request_clear_contamination(node);
+
+        if (!doc_.may_clear_contamination(node))
+            return false;
+
+        auto clear = [](auto & list, auto id)
+        {
+            list.touch(id);
+            list.source.set(id.val, false);
+            list.cleared.set(id.val);
+        };
+
+        if (auto* key = std::get_if<key_id>(&node))
+        {
+            auto* kn = doc_.get_node(*key);
+            kn->contamination = contamination_state::clean;
+            kn->value.contamination = contamination_state::clean;
+            clear(batch_->keys, *key);
+        }
+        else
+        {
+            auto row = std::get<row_id>(node);
+            doc_.get_node(row)->contamination = contamination_state::clean;
+            clear(batch_->rows, row);
+        }
+        return true;
+    }
+
+    inline void editor::reevaluate(table_id id)
+    {
+        journal_header(id);
+        if (batch_) batch_->tables.touch(id);
+        else        doc_.try_clear_table_contamination(id);
+    }
+
+    inline void editor::reevaluate(category_id id)
+    {
+        journal_header(id);
+        if (batch_) batch_->categories.touch(id);
+        else        doc_.try_clear_category_contamination(id);
+    }
+
+    inline bool editor::commit_batch()
+    {
+        if (!batch_)
+            return true;
+
+        // Detached first, so the pass below reaches the document directly
+        auto state = std::move(batch_);
+
+        // Bring the sources up to date, then re-evaluate the ancestors
+        // of every cleared source and every entity an edit asked to
+        // re-evaluate. Entities erased in the batch are skipped. The
+        // batch fails only on sources it created; a key or row that was
+        // a source before the batch began may stay one.
+        bool ok = true;
+        auto update_sources = [this, &ok](auto & list, auto const & nodes)
+        {
+            for (auto id : list.ids)
+            {
+                auto* node = doc_.get_node(id);
+                if (!node) continue;
+
+                bool was = nodes.contains(id.val);
+                bool is  = list.source.test(id.val);
+                if (is && !was)
+                {
+                    doc_.register_source(*node);
+                    ok = false;
+                }
+                else if (!is && was) doc_.unregister_source(*node);
+            }
+        };
+        update_sources(state->keys, doc_.contaminated_source_keys_);
+        update_sources(state->rows, doc_.contaminated_source_rows_);
+
+        for (auto id : state->keys.ids)
+            if (state->keys.cleared.test(id.val))
+                if (auto* kn = doc_.get_node(id))
+                    doc_.try_clear_category_contamination(kn->owner);
+        for (auto id : state->rows.ids)
+            if (state->rows.cleared.test(id.val))
+                if (auto* rn = doc_.get_node(id))
+                    doc_.try_clear_table_contamination(rn->table);
+        for (auto id : state->tables.ids)
+            doc_.try_clear_table_contamination(id);
+        for (auto id : state->categories.ids)
+            doc_.try_clear_category_contamination(id);
+
+        bool rolled_back = !ok && state->before;
+        if (rolled_back)
+            doc_.restore(std::move(*state->before));
+
+        if (state->step)
+        {
+            if (rolled_back) discard_step();
+            else             close_step();
+        }
+        return ok;
+    }
+
+    inline bool editor::rollback_batch()
+    {
+        if (!batch_ || !batch_->before)
+            return false;
+
+        doc_.restore(std::move(*batch_->before));
+        if (batch_->step)
+            discard_step();
+        batch_.reset();
+        return true;
+    }
+
+//========================================================
+// History
+//========================================================
+
+    inline bool editor::enable_history(bool enabled)
+    {
+        if (batch_)
+            return false;
+
+        if (!enabled)
+            history_.reset();
+        else if (!history_)
+        {
+            // Steps record list positions, so the lists start purged
+            doc_.compact();
+            history_ = std::make_unique<history_state>();
+        }
+        return true;
+    }
+
+    inline bool editor::undo()
+    {
+        if (!can_undo() || batch_ || history_->depth > 0)
+            return false;
+
+        auto step = std::move(history_->undo.back());
+        history_->undo.pop_back();
+        replay(step, true);
+        history_->redo.push_back(std::move(step));
+        return true;
+    }
+
+    inline bool editor::redo()
+    {
+        if (!can_redo() || batch_ || history_->depth > 0)
+            return false;
+
+        auto step = std::move(history_->redo.back());
+        history_->redo.pop_back();
+        replay(step, false);
+        history_->undo.push_back(std::move(step));
+        return true;
+    }
+
+    inline editor::step_scope editor::open_step()
+    {
+        if (!history_ || history_->replaying)
+            return {nullptr};
+
+        ++history_->depth;
+        return {this};
+    }
+
+    inline void editor::close_step()
+    {
+        if (!history_ || --history_->depth > 0)
+            return;
+
+        if (!history_->step.empty())
+        {
+            history_->undo.push_back(std::move(history_->step));
+            history_->redo.clear();
+        }
+        history_->step.clear();
+        history_->kept.clear();
+    }
+
+    inline void editor::discard_step()
+    {
+        history_->step.clear();
+        history_->kept.clear();
+        history_->depth = 0;
+    }
+
+    template<typename Tag>
+    void editor::journal(id<Tag> id)
+    {
+        using node_type = document::node_for_t<Tag>;
+
+        mark_dirty(id);
+        if (!recording() || !first_in_step<node_image<node_type>>(id.val))
+            return;
+
+        auto* node = doc_.get_node(id);
+        if (!node) return;
+
+        node_image<node_type> image{id};
+
+        if constexpr (std::is_same_v<Tag, key_tag>)
+        {
+            image.source = doc_.contaminated_source_keys_.contains(id.val);
+            journal_header(node->owner);
+        }
+        else if constexpr (std::is_same_v<Tag, row_tag>)
+        {
+            image.source = doc_.contaminated_source_rows_.contains(id.val);
+            journal_header(node->table);
+        }
+        else if constexpr (std::is_same_v<Tag, column_tag>)
+            journal_header(node->table);
+        else if constexpr (std::is_same_v<Tag, table_tag>)
+            journal_header(node->owner);
+        else if constexpr (std::is_same_v<Tag, category_tag>)
+            journal_header(node->parent);
+
+        image.node = *node;
+        history_->step.push_back(std::move(image));
+    }
+
+    template<typename Tag>
+    void editor::journal_created(id<Tag> id)
+    {
+        using node_type = document::node_for_t<Tag>;
+
+        mark_dirty(id);
+        if (recording() && first_in_step<node_image<node_type>>(id.val))
+            history_->step.push_back(node_image<node_type>{id});
+    }
+
+    inline void editor::journal_header(table_id id)
+    {
+        doc_.mark_dirty(id);
+        if (!recording() || !first_in_step<table_header>(id.val))
+            return;
+
+        auto* tbl = doc_.get_node(id);
+        if (!tbl) return;
+
+        history_->step.push_back(table_header{id, *tbl, tbl->columns, tbl->contaminated_rows});
+        journal_header(tbl->owner);
+    }
+
+    inline void editor::journal_header(category_id id)
+    {
+        doc_.mark_dirty(id);
+
+        // Up to the root, or to an ancestor the step has journalled
+        // with its own ancestors
+        while (recording() && first_in_step<category_header>(id.val))
+        {
+            auto* cat = doc_.get_node(id);
+            if (!cat) return;
+
+            history_->step.push_back(category_header{id, *cat, cat->contaminated_keys, cat->contaminated_children});
+            id = cat->parent;
+        }
+    }
+
+    inline void editor::journal_column(document::table_node const & tbl, size_t column, column_edit edit)
+    {
+        if (!recording())
+            return;
+
+        column_rows entry{tbl.id, column, edit, {}};
+        entry.rows.reserve(tbl.rows.size());
+        for (auto rid : tbl.rows)
+        {
+            auto* rn = doc_.get_node(rid);
+            if (!rn) continue;
+
+            auto & state = entry.rows.emplace_back();
+            state.id     = rid;
+            state.flags  = *rn;
+            state.source = doc_.contaminated_source_rows_.contains(rid.val);
+            if (edit != column_edit::inserted && column < rn->cells.size())
+                state.cell = rn->cells[column];
+        }
+        history_->step.push_back(std::move(entry));
+    }
+
+    template<typename Tag>
+    void editor::mark_dirty(id<Tag> id)
+    {
+        auto* node = doc_.get_node(id);
+        if (!node) return;
+
+        if constexpr (std::is_same_v<Tag, key_tag>)
+            doc_.mark_dirty(node->owner);
+        else if constexpr (std::is_same_v<Tag, row_tag> || std::is_same_v<Tag, column_tag>)
+            doc_.mark_dirty(node->table);
+        else if constexpr (std::is_same_v<Tag, table_tag> || std::is_same_v<Tag, category_tag>)
+            doc_.mark_dirty(id);
+        else
+        {
+            // Authored comments and paragraphs may sit among the rows of
+            // a table, and know only their category
+            doc_.mark_dirty(node->owner);
+            if (auto* cat = doc_.get_node(node->owner))
+                for (auto tid : cat->tables)
+                    doc_.mark_dirty(tid);
+        }
+    }
+
+    inline void editor::mark_dirty(list_kind list, size_t owner)
+    {
+        if (list == list_kind::rows || list == list_kind::table_items)
+            doc_.mark_dirty(table_id{owner});
+        else
+            doc_.mark_dirty(category_id{owner});
+    }
+
+    template<typename T>
+    void editor::list_insert(list_kind list, size_t owner, std::vector<T> & items, size_t pos, T item)
+    {
+        mark_dirty(list, owner);
+        if (recording())
+            history_->step.push_back(list_edit{list, owner, pos, {item}, true});
+        items.insert(items.begin() + pos, std::move(item));
+
+        if constexpr (std::is_same_v<T, row_id>)
+            doc_.index_listed_row(*doc_.get_node(table_id{owner}), pos);
+    }
+
+    template<typename T>
+    void editor::list_erase(list_kind list, size_t owner, std::vector<T> & items, T const & item)
+    {
+        mark_dirty(list, owner);
+        for (size_t pos = 0; pos < items.size(); )
+        {
+            if (!(items[pos] == item))
+            {
+                ++pos;
+                continue;
+            }
+
+            if (recording())
+                history_->step.push_back(list_edit{list, owner, pos, {items[pos]}, false});
+            if constexpr (std::is_same_v<T, row_id>)
+                doc_.unindex_listed_row(*doc_.get_node(table_id{owner}), pos);
+            items.erase(items.begin() + pos);
+        }
+    }
+
+    inline void editor::replay(journal_step & step, bool backwards)
+    {
+        history_->replaying = true;
+
+        auto apply = [this](journal_entry & entry)
+        {
+            std::visit([this](auto & e) { replay_entry(e); }, entry);
+        };
+
+        if (backwards)
+            for (auto it = step.rbegin(); it != step.rend(); ++it)
+                apply(*it);
+        else
+            for (auto & entry : step)
+                apply(entry);
+
+        history_->replaying = false;
+    }
+
+    template<typename Node>
+    void editor::replay_entry(node_image<Node> & image)
+    {
+        constexpr bool is_row = std::is_same_v<Node, document::row_node>;
+
+        if constexpr (is_row || std::is_same_v<Node, document::key_node>)
+        {
+            auto & sources = is_row ? doc_.contaminated_source_rows_ : doc_.contaminated_source_keys_;
+            bool was = sources.contains(image.id.val);
+            sources.resize(image.id.val + 1);
+            sources.set(image.id.val, image.source);
+            image.source = was;
+        }
+
+        auto & nodes = doc_.nodes<Node>();
+        auto* node = doc_.get_node(image.id);
+
+        if (node && image.node)
+        {
+            if constexpr (is_row)
+            {
+                std::swap(*node, *image.node);
+                std::swap(node->listed_at, image.node->listed_at);  // where the row is listed now
+                doc_.rename_listed_row(*node);
+            }
+            else
+            {
+                doc_.unindex_name(*node);
+                std::swap(*node, *image.node);
+                doc_.index_name(*node);
+            }
+        }
+        else if (node)
+            image.node = doc_.take_node(nodes, image.id);
+        else if (image.node)
+        {
+            doc_.place_node(nodes, std::move(*image.node));
+            image.node.reset();
+        }
+    }
+
+    inline void editor::replay_entry(table_header & header)
+    {
+        auto* tbl = doc_.get_node(header.id);
+        if (!tbl) return;
+
+        std::swap(static_cast<document::node<> &>(*tbl), header.flags);
+        std::swap(tbl->columns, header.columns);
+        std::swap(tbl->contaminated_rows, header.contaminated_rows);
+    }
+
+    inline void editor::replay_entry(category_header & header)
+    {
+        auto* cat = doc_.get_node(header.id);
+        if (!cat) return;
+
+        std::swap(static_cast<document::node<false, true> &>(*cat), header.flags);
+        std::swap(cat->contaminated_keys, header.contaminated_keys);
+        std::swap(cat->contaminated_children, header.contaminated_children);
+    }
+
+    inline void editor::replay_entry(list_edit & edit)
+    {
+        auto apply = [&](auto & items, auto item)
+        {
+            if (edit.present) items.erase(items.begin() + edit.pos);
+            else              items.insert(items.begin() + edit.pos, item);
+            edit.present = !edit.present;
+        };
+
+        auto& item = edit.item;
+        if (edit.list == list_kind::rows || edit.list == list_kind::table_items)
+        {
+            auto* tbl = doc_.get_node(table_id{edit.owner});
+            if (!tbl) return;
+
+            if (edit.list != list_kind::rows)
+            {
+                apply(tbl->ordered_items, item);
+                return;
+            }
+
+            if (edit.present) doc_.unindex_listed_row(*tbl, edit.pos);
+            apply(tbl->rows, std::get<row_id>(item.id));
+            if (edit.present) doc_.index_listed_row(*tbl, edit.pos);
+            return;
+        }
+
+        auto* cat = doc_.get_node(category_id{edit.owner});
+        if (!cat) return;
+
+        switch (edit.list)
+        {
+            case list_kind::children: apply(cat->children, std::get<category_id>(item.id)); break;
+            case list_kind::tables:   apply(cat->tables, std::get<table_id>(item.id)); break;
+            case list_kind::keys:     apply(cat->keys, std::get<key_id>(item.id)); break;
+            default:                  apply(cat->ordered_items, item); break;
+        }
+    }
+
+    inline void editor::replay_entry(layout_change & change)
+    {
+        auto* tbl = doc_.get_node(change.id);
+        if (!tbl) return;
+
+        // Rows leave a store by the indices it gave them, and enter one
+        // by the indices it had
+        if (tbl->store)
+        {
+            change.store = doc_.make_row_oriented(*tbl);
+            swap_store_indices(change.store_indices);
+            return;
+        }
+
+        swap_store_indices(change.store_indices);
+        if (change.store) doc_.restore_columnar(*tbl, std::move(change.store));
+        else              doc_.make_columnar(*tbl);
+    }
+
+    inline void editor::replay_entry(column_cells & cells)
+    {
+        auto* tbl = doc_.get_node(cells.table);
+        if (!tbl || !tbl->store || cells.column >= tbl->store->columns.size())
+            return;
+
+        tbl->store->columns[cells.column].swap_metadata(cells.metadata);
+    }
+
+    inline void editor::replay_entry(column_rows & column)
+    {
+        auto* tbl = doc_.get_node(column.table);
+        if (!tbl) return;
 
-        category_id  create_category_node_only( category_id parent, std::string_view name);
-        key_id       create_key_node_only( category_id where, std::string_view name, value v, bool untyped);
-        table_id     create_table_node_only( category_id where, std::vector<std::pair<std::string, std::optional<value_type>>> columns);
-        column_id    create_column_node_only( table_id table, std::string_view name, std::optional<value_type> declared_type);
-        row_id create_row_node_only( table_id table, std::vector<typed_value> cells);
-        comment_id   create_comment_node_only( category_id where, std::string_view text);
-        paragraph_id create_paragraph_node_only( category_id where, std::string_view text);
+        auto & sources = doc_.contaminated_source_rows_;
+        size_t at = column.column;
+        for (auto & state : column.rows)
+        {
+            auto* rn = doc_.get_node(state.id);
+            if (!rn) continue;
 
-        // Generic insertion helper - creates node, adds to semantic collection, inserts at position
-        template<typename EntityId, typename Tag, typename CreateFn>
-        EntityId insert_category_child_before_impl( id<Tag> anchor, CreateFn&& create_fn);
+            std::swap(static_cast<document::node<> &>(*rn), state.flags);
+            bool was = sources.contains(state.id.val);
+            sources.resize(state.id.val + 1);
+            sources.set(state.id.val, state.source);
+            state.source = was;
 
-        template<typename EntityId, typename Tag, typename CreateFn>
-        EntityId insert_category_child_after_impl( id<Tag> anchor, CreateFn&& create_fn);
+            auto & cells = rn->cells;
+            switch (column.edit)
+            {
+                case column_edit::cells:
+                    if (state.cell && at < cells.size())
+                        std::swap(*state.cell, cells[at]);
+                    break;
+                case column_edit::inserted:
+                    if (at < cells.size())
+                    {
+                        state.cell = std::move(cells[at]);
+                        cells.erase(cells.begin() + at);
+                    }
+                    break;
+                case column_edit::erased:
+                    if (state.cell && at <= cells.size())
+                    {
+                        cells.insert(cells.begin() + at, std::move(*state.cell));
+                        state.cell.reset();
+                    }
+                    break;
+            }
+        }
 
-        template<typename EntityId, typename AnchorTag>
-        bool move_before(EntityId item, id<AnchorTag> anchor);   
-    };
+        if (column.edit == column_edit::inserted)    column.edit = column_edit::erased;
+        else if (column.edit == column_edit::erased) column.edit = column_edit::inserted;
 
-//================================================================================================================
-//
-// Editor implementations
-//
-//================================================================================================================
+        // The first column names the rows
+        if (at == 0)
+            doc_.index_rows(*tbl);
+    }
 
 //========================================================
 // Internal helpers; not exposed for clients
@@ -245,6 +1231,37 @@ namespace nuno
         return nullptr;
     }
 
+    inline document::table_node* editor::row_layout_table(table_id table)
+    {
+        auto* tbl = doc_.get_node(table);
+        if (!tbl)
+            return nullptr;
+        if (tbl->store)
+        {
+            auto store = doc_.make_row_oriented(*tbl);
+            if (recording())
+                history_->step.push_back(layout_change{table, std::move(store), store_indices(*tbl)});
+        }
+        return tbl;
+    }
+
+    inline std::vector<std::pair<row_id, size_t>> editor::store_indices(document::table_node const & t) const
+    {
+        std::vector<std::pair<row_id, size_t>> out;
+        out.reserve(t.rows.size());
+        for (auto rid : t.rows)
+            if (auto* rn = doc_.get_node(rid))
+                out.emplace_back(rid, rn->store_index);
+        return out;
+    }
+
+    inline void editor::swap_store_indices(std::vector<std::pair<row_id, size_t>> & indices)
+    {
+        for (auto & [rid, index] : indices)
+            if (auto* rn = doc_.get_node(rid))
+                std::swap(rn->store_index, index);
+    }
+
     inline typed_value editor::make_array_element(
         value val,
         value_type expected_type,
@@ -305,6 +1322,7 @@ namespace nuno
         if (!anchor_node) return invalid_id<typename EntityId::tag_type>();
 
         category_id where = anchor_node->owner;
+        auto step = open_step();
 
         // Create node without touching ordered_items
         EntityId id = std::invoke(std::forward<CreateFn>(create_fn), where);
@@ -314,7 +1332,8 @@ namespace nuno
         auto it = std::ranges::find(cat->ordered_items, *ref);
 
         // Insert ONCE at correct position
-        cat->ordered_items.insert(it, {id});
+        list_insert(list_kind::category_items, where.val, cat->ordered_items,
+                    static_cast<size_t>(it - cat->ordered_items.begin()), document::source_item_ref{id});
 
         return id;
     }
@@ -331,6 +1350,7 @@ namespace nuno
         if (!anchor_node) return invalid_id<typename EntityId::tag_type>();
 
         category_id where = anchor_node->owner;
+        auto step = open_step();
 
         // Create node without touching ordered_items
         EntityId id = std::invoke(std::forward<CreateFn>(create_fn), where);
@@ -342,7 +1362,8 @@ namespace nuno
         if (it != cat->ordered_items.end()) ++it;
 
         // Insert ONCE at correct position
-        cat->ordered_items.insert(it, {id});
+        list_insert(list_kind::category_items, where.val, cat->ordered_items,
+                    static_cast<size_t>(it - cat->ordered_items.begin()), document::source_item_ref{id});
 
         return id;
     }
@@ -377,6 +1398,7 @@ namespace nuno
             return false;
         
         // 4. Remove from current position
+        doc_.mark_dirty(cat->id);
         auto item_ref = *item_it;
         cat->ordered_items.erase(item_it);
         
@@ -437,16 +1459,12 @@ namespace nuno
         auto* cat = doc_.get_node(node->owner);
         if (!cat) return false;
 
-        std::erase_if(cat->ordered_items, [&](auto const& r) {
-            return std::holds_alternative<EntityId>(r.id)
-                && std::get<EntityId>(r.id) == id;
-        });
+        auto step = open_step();
+        journal(id);
 
-        storage.erase(
-            std::ranges::find_if(storage, [&](auto const& n) {
-                return n.id == id;
-            })
-        );
+        list_erase(list_kind::category_items, cat->id.val, cat->ordered_items, document::source_item_ref{id});
+
+        doc_.erase_node(storage, id);
 
         return true;
     }
@@ -461,11 +1479,12 @@ namespace nuno
         if (!cat)
             return invalid_id<key_tag>();
 
+        journal_header(where);
         key_id id = doc_.create_key_id();
 
         document::key_node kn;
         kn.id        = id;
-        kn.name      = std::string(name);
+        kn.name      = doc_.symbols_.intern(name);
         kn.owner     = where;
         kn.creation  = creation_state::generated;
         kn.is_edited = true;
@@ -482,8 +1501,9 @@ namespace nuno
         kn.value.contamination = contamination_state::clean;
         kn.value.creation      = creation_state::generated;
 
-        doc_.keys_.push_back(std::move(kn));
-        cat->keys.push_back(id);
+        doc_.insert_node(doc_.keys_, std::move(kn));
+        journal_created(id);
+        list_insert(list_kind::keys, where.val, cat->keys, cat->keys.size(), id);
 
         return id;
     }
@@ -503,7 +1523,8 @@ namespace nuno
         cn.owner    = where;
         cn.creation = creation_state::generated;
 
-        doc_.comments_.push_back(std::move(cn));
+        doc_.insert_node(doc_.comments_, std::move(cn));
+        journal_created(id);
         // Note: Does NOT add to ordered_items
         
         return id;
@@ -524,7 +1545,8 @@ namespace nuno
         pn.owner    = where;
         pn.creation = creation_state::generated;
 
-        doc_.paragraphs_.push_back(std::move(pn));
+        doc_.insert_node(doc_.paragraphs_, std::move(pn));
+        journal_created(id);
         // Note: Does NOT add to ordered_items
         
         return id;
@@ -537,6 +1559,7 @@ namespace nuno
         auto* cat = doc_.get_node(where);
         if (!cat) return invalid_id<table_tag>();
 
+        journal_header(where);
         table_id tid = doc_.create_table_id();
 
         document::table_node tbl;
@@ -550,19 +1573,21 @@ namespace nuno
 
             document::column_node cn;
             cn.col.id   = cid;
-            cn.col.name = std::move(name);
+            cn.col.name = doc_.symbols_.intern(name);
             cn.col.type = opt_type.value_or(value_type::unresolved);
             cn.col.semantic = semantic_state::valid;
 
             cn.table = tid;
             cn.owner = where;
 
-            doc_.columns_.push_back(std::move(cn));
+            doc_.insert_node(doc_.columns_, std::move(cn));
+            journal_created(cid);
             tbl.columns.push_back(cid);
         }
 
-        doc_.tables_.push_back(std::move(tbl));
-        cat->tables.push_back(tid);
+        doc_.insert_node(doc_.tables_, std::move(tbl));
+        journal_created(tid);
+        list_insert(list_kind::tables, where.val, cat->tables, cat->tables.size(), tid);
         // Note: Does NOT add to ordered_items
         
         return tid;
@@ -578,7 +1603,7 @@ namespace nuno
 
         document::column_node col;
         col.col.id        = id;
-        col.col.name      = name;
+        col.col.name      = doc_.symbols_.intern(name);
         col.table         = table;
         col.creation      = creation_state::generated;
         col.is_edited     = true;
@@ -589,7 +1614,8 @@ namespace nuno
              ? *declared_type
              : value_type::unresolved;
 
-        doc_.columns_.push_back(std::move(col));
+        doc_.insert_node(doc_.columns_, std::move(col));
+        journal_created(id);
 
         return id;
     }
@@ -631,7 +1657,7 @@ namespace nuno
                 ? contamination_state::contaminated
                 : contamination_state::clean;
 
-        doc_.rows_.push_back(std::move(row));
+        doc_.insert_node(doc_.rows_, std::move(row));
 
         return id;
     }
@@ -647,20 +1673,22 @@ namespace nuno
         auto* parent_node = doc_.get_node(parent);
         if (!parent_node) return invalid_id<category_tag>();
 
+        journal_header(parent);
         category_id id = doc_.create_category_id();
 
         document::category_node cn;
         cn.id     = id;
-        cn.name   = std::string(name);
+        cn.name   = doc_.symbols_.intern(name);
         cn.parent = parent;
         cn.creation = creation_state::generated;
         cn.is_edited = true;
 
-        doc_.categories_.push_back(std::move(cn));
+        doc_.insert_node(doc_.categories_, std::move(cn));
+        journal_created(id);
         
         // Re-acquire parent pointer after vector modification
         parent_node = doc_.get_node(parent);
-        parent_node->children.push_back(id);
+        list_insert(list_kind::children, parent.val, parent_node->children, parent_node->children.size(), id);
 
         return id;
     }
@@ -669,11 +1697,13 @@ namespace nuno
         category_id parent,
         std::string_view name)
     {
+        auto step = open_step();
         category_id id = create_category_node_only(parent, name);
         if (!valid(id)) return id;
 
         auto* parent_node = doc_.get_node(parent);
-        parent_node->ordered_items.push_back(document::source_item_ref{id});
+        list_insert(list_kind::category_items, parent.val, parent_node->ordered_items,
+                    parent_node->ordered_items.size(), document::source_item_ref{id});
 
         return id;
     }
@@ -730,22 +1760,17 @@ namespace nuno
             return false;
         }
 
+        auto step = open_step();
+        journal(id);
+
         // Remove from parent's children list
-        std::erase(parent->children, id);
+        list_erase(list_kind::children, parent->id.val, parent->children, id);
 
         // Remove from parent's ordered_items
-        std::erase_if(parent->ordered_items, [&](auto const& r) {
-            return std::holds_alternative<category_id>(r.id)
-                && std::get<category_id>(r.id) == id;
-        });
+        list_erase(list_kind::category_items, parent->id.val, parent->ordered_items, document::source_item_ref{id});
 
         // Remove from document storage
-        auto& categories = doc_.categories_;
-        categories.erase(
-            std::ranges::find_if(categories, [&](auto const& c) {
-                return c.id == id;
-            })
-        );
+        doc_.erase_node(doc_.categories_, id);
 
         return true;
     }
@@ -758,6 +1783,9 @@ namespace nuno
     {
         auto* kn = doc_.get_node(key);
         if (!kn) return;
+
+        auto step = open_step();
+        journal(key);
         
         auto& tv = kn->value;
         
@@ -793,12 +1821,12 @@ namespace nuno
         {
             tv.contamination = contamination_state::contaminated;
             kn->contamination = contamination_state::contaminated;
-            doc_.mark_key_contaminated(key);
+            mark_contaminated(key);
         } 
         else 
         {
             tv.contamination = contamination_state::clean;
-            doc_.request_clear_contamination(key);
+            request_clear(key);
         }
         
         kn->is_edited = true;
@@ -808,6 +1836,9 @@ namespace nuno
     {
         auto* kn = doc_.get_node(key);
         if (!kn) return;
+
+        auto step = open_step();
+        journal(key);
         
         auto& tv = kn->value;
         
@@ -832,7 +1863,7 @@ namespace nuno
         if (arr.back().semantic == semantic_state::invalid) {
             tv.contamination = contamination_state::contaminated;
             kn->contamination = contamination_state::contaminated;
-            doc_.mark_key_contaminated(key);
+            mark_contaminated(key);
         }
         
         kn->is_edited = true;
@@ -842,6 +1873,9 @@ namespace nuno
     {
         auto* kn = doc_.get_node(key);
         if (!kn) return;
+
+        auto step = open_step();
+        journal(key);
         
         auto& tv = kn->value;
         
@@ -874,12 +1908,12 @@ namespace nuno
         {
             tv.contamination = contamination_state::contaminated;
             kn->contamination = contamination_state::contaminated;
-            doc_.mark_key_contaminated(key);
+            mark_contaminated(key);
         } 
         else 
         {
             tv.contamination = contamination_state::clean;
-            doc_.request_clear_contamination(key);
+            request_clear(key);
         }
         
         kn->is_edited = true;
@@ -889,6 +1923,9 @@ namespace nuno
     {
         auto* kn = doc_.get_node(key);
         if (!kn) return;
+
+        auto step = open_step();
+        journal(key);
         
         auto& tv = kn->value;
         
@@ -918,12 +1955,12 @@ namespace nuno
         {
             tv.contamination = contamination_state::contaminated;
             kn->contamination = contamination_state::contaminated;
-            doc_.mark_key_contaminated(key);
+            mark_contaminated(key);
         } 
         else 
         {
             tv.contamination = contamination_state::clean;
-            doc_.request_clear_contamination(key);
+            request_clear(key);
         }
         
         kn->is_edited = true;
@@ -939,11 +1976,13 @@ namespace nuno
         value v,
         bool untyped)
     {
+        auto step = open_step();
         key_id id = create_key_node_only(where, name, std::move(v), untyped);
         if (!valid(id)) return id;
 
         auto* cat = doc_.get_node(where);
-        cat->ordered_items.push_back(document::source_item_ref{id});
+        list_insert(list_kind::category_items, where.val, cat->ordered_items,
+                    cat->ordered_items.size(), document::source_item_ref{id});
         return id;
     }
 
@@ -961,7 +2000,7 @@ namespace nuno
                 if (!valid(id)) return id;
                 
                 auto* cat = doc_.get_node(where);
-                cat->keys.push_back(id);  // Keys need this extra step
+                list_insert(list_kind::keys, where.val, cat->keys, cat->keys.size(), id);  // Keys need this extra step
                 
                 return id;
             }
@@ -982,7 +2021,7 @@ namespace nuno
                 if (!valid(id)) return id;
                 
                 auto* cat = doc_.get_node(where);
-                cat->keys.push_back(id);  // Keys need this extra step
+                list_insert(list_kind::keys, where.val, cat->keys, cat->keys.size(), id);  // Keys need this extra step
                 
                 return id;
             }
@@ -999,11 +2038,13 @@ namespace nuno
         if (!cat)
             return invalid_id<key_tag>();
 
+        auto step = open_step();
+        journal_header(where);
         key_id id = doc_.create_key_id();
 
         document::key_node kn;
         kn.id    = id;
-        kn.name  = std::string(name);
+        kn.name  = doc_.symbols_.intern(name);
         kn.owner = where;
 
         // Infer array type from first element if untyped
@@ -1061,14 +2102,17 @@ namespace nuno
         
         // Mark key contamination if array has invalid elements
         if (has_invalid)
-        {
             kn.contamination = contamination_state::contaminated;
-            doc_.mark_key_contaminated(id);
-        }
 
-        doc_.keys_.push_back(std::move(kn));
-        cat->keys.push_back(id);
-        cat->ordered_items.push_back(document::source_item_ref{id});
+        doc_.insert_node(doc_.keys_, std::move(kn));
+        journal_created(id);
+
+        // Registered once stored, so the source reaches its category
+        if (has_invalid)
+            mark_contaminated(id);
+        list_insert(list_kind::keys, where.val, cat->keys, cat->keys.size(), id);
+        list_insert(list_kind::category_items, where.val, cat->ordered_items,
+                    cat->ordered_items.size(), document::source_item_ref{id});
 
         return id;
     }
@@ -1090,11 +2134,12 @@ namespace nuno
                 auto* cat = doc_.get_node(where);
                 if (!cat) return invalid_id<key_tag>();
 
+                journal_header(where);
                 key_id id = doc_.create_key_id();
 
                 document::key_node kn;
                 kn.id    = id;
-                kn.name  = std::string(name);
+                kn.name  = doc_.symbols_.intern(name);
                 kn.owner = where;
 
                 // Infer array type from first element if untyped
@@ -1148,13 +2193,15 @@ namespace nuno
                     : contamination_state::clean;
                 
                 if (has_invalid)
-                {
                     kn.contamination = contamination_state::contaminated;
-                    doc_.mark_key_contaminated(id);
-                }
 
-                doc_.keys_.push_back(std::move(kn));
-                cat->keys.push_back(id);
+                doc_.insert_node(doc_.keys_, std::move(kn));
+                journal_created(id);
+
+                // Registered once stored, so the source reaches its category
+                if (has_invalid)
+                    mark_contaminated(id);
+                list_insert(list_kind::keys, where.val, cat->keys, cat->keys.size(), id);
                 
                 return id;
             }
@@ -1175,11 +2222,12 @@ namespace nuno
                 auto* cat = doc_.get_node(where);
                 if (!cat) return invalid_id<key_tag>();
 
+                journal_header(where);
                 key_id id = doc_.create_key_id();
 
                 document::key_node kn;
                 kn.id    = id;
-                kn.name  = std::string(name);
+                kn.name  = doc_.symbols_.intern(name);
                 kn.owner = where;
 
                 value_type array_type = value_type::unresolved;
@@ -1230,13 +2278,15 @@ namespace nuno
                     : contamination_state::clean;
                 
                 if (has_invalid)
-                {
                     kn.contamination = contamination_state::contaminated;
-                    doc_.mark_key_contaminated(id);
-                }
 
-                doc_.keys_.push_back(std::move(kn));
-                cat->keys.push_back(id);
+                doc_.insert_node(doc_.keys_, std::move(kn));
+                journal_created(id);
+
+                // Registered once stored, so the source reaches its category
+                if (has_invalid)
+                    mark_contaminated(id);
+                list_insert(list_kind::keys, where.val, cat->keys, cat->keys.size(), id);
                 
                 return id;
             }
@@ -1251,24 +2301,24 @@ namespace nuno
         auto* cat = doc_.get_node(kn->owner);
         if (!cat) return false;
 
+        auto step = open_step();
+        journal(id);
+
         // Remove contamination source if present
-        doc_.request_clear_contamination(id);
+        request_clear(id);
 
         // ordered_items
-        std::erase_if(cat->ordered_items, [&](auto const& r)
-        {
-            return std::holds_alternative<key_id>(r.id)
-                && std::get<key_id>(r.id) == id;
-        });
+        list_erase(list_kind::category_items, cat->id.val, cat->ordered_items, document::source_item_ref{id});
 
         // category key list
-        std::erase_if(cat->keys, [&](auto const& kid) {return kid == id;});
+        list_erase(list_kind::keys, cat->id.val, cat->keys, id);
 
         // key storage
-        auto& keys = doc_.keys_;
-        keys.erase(
-            std::ranges::find_if(keys, [&](auto const& k){return k.id == id;})
-        );
+        category_id owner = kn->owner;
+        doc_.erase_node(doc_.keys_, id);
+
+        // An erased source no longer holds its category contaminated
+        reevaluate(owner);
 
         return true;
     }
@@ -1278,6 +2328,9 @@ namespace nuno
     {
         auto* kn = doc_.get_node(key);
         if (!kn) return;
+
+        auto step = open_step();
+        journal(key);
         
         auto& tv = kn->value;
         
@@ -1294,18 +2347,18 @@ namespace nuno
                 // Type mismatch → contaminate
                 tv.semantic = semantic_state::invalid;
                 kn->semantic = semantic_state::invalid;
-                doc_.mark_key_contaminated(key);
+                mark_contaminated(key);
             }
             else
             {
                 // Valid → try to clear
-                if (doc_.request_clear_contamination(key))
+                if (request_clear(key))
                     tv.semantic = semantic_state::valid;
             }
         }
         else
         {
-            if (doc_.request_clear_contamination(key))
+            if (request_clear(key))
                 tv.semantic = semantic_state::valid;
         }
         
@@ -1317,6 +2370,9 @@ namespace nuno
         auto* kn = doc_.get_node(key);
         if (!kn) return;
 
+        auto step = open_step();
+        journal(key);
+
         auto& tv = kn->value;
 
         // Determine array type from key's declared type or infer from first element
@@ -1385,15 +2441,14 @@ namespace nuno
             kn->contamination = contamination_state::contaminated;
             tv.contamination  = contamination_state::contaminated;
 
-            doc_.mark_key_contaminated(key);
+            mark_contaminated(key);
         }
         else
         {
             kn->semantic      = semantic_state::valid;
-            kn->contamination = contamination_state::clean;
             tv.contamination  = contamination_state::clean;
 
-            doc_.request_clear_contamination(key);
+            request_clear(key);
         }
 
         kn->is_edited = true;
@@ -1410,9 +2465,11 @@ namespace nuno
     {
         auto* rn = doc_.get_node(row);
         if (!rn) return;
-        
-        auto* tbl = doc_.get_node(rn->table);
+
+        auto step = open_step();
+        auto* tbl = row_layout_table(rn->table);
         if (!tbl) return;
+        journal(row);
         
         // Find column to determine expected type
         auto* cn = doc_.get_node(col);
@@ -1443,8 +2500,8 @@ namespace nuno
         update_array_and_check(
             cell,
             cell.type,
-            [this, row]() { doc_.mark_row_contaminated(row); },
-            [this, row]() { doc_.request_clear_contamination(row); }
+            [this, row]() { mark_contaminated(row); },
+            [this, row]() { request_clear(row); }
         );
         
         cell.is_edited = true;
@@ -1459,9 +2516,11 @@ namespace nuno
     {
         auto* rn = doc_.get_node(row);
         if (!rn) return;
-        
-        auto* tbl = doc_.get_node(rn->table);
+
+        auto step = open_step();
+        auto* tbl = row_layout_table(rn->table);
         if (!tbl) return;
+        journal(row);
         
         auto col_it = std::ranges::find(tbl->columns, col);
         if (col_it == tbl->columns.end()) return;
@@ -1488,8 +2547,8 @@ namespace nuno
         update_array_and_check(
             cell,
             cell.type,
-            [this, row]() { doc_.mark_row_contaminated(row); },
-            [this, row]() { doc_.request_clear_contamination(row); }
+            [this, row]() { mark_contaminated(row); },
+            [this, row]() { request_clear(row); }
         );
         
         cell.is_edited = true;
@@ -1503,9 +2562,11 @@ namespace nuno
     {
         auto* rn = doc_.get_node(row);
         if (!rn) return;
-        
-        auto* tbl = doc_.get_node(rn->table);
+
+        auto step = open_step();
+        auto* tbl = row_layout_table(rn->table);
         if (!tbl) return;
+        journal(row);
         
         auto col_it = std::ranges::find(tbl->columns, col);
         if (col_it == tbl->columns.end()) return;
@@ -1537,8 +2598,8 @@ namespace nuno
         update_array_and_check(
             cell,
             cell.type,
-            [this, row]() { doc_.mark_row_contaminated(row); },
-            [this, row]() { doc_.request_clear_contamination(row); }
+            [this, row]() { mark_contaminated(row); },
+            [this, row]() { request_clear(row); }
         );
         
         cell.is_edited = true;
@@ -1552,9 +2613,11 @@ namespace nuno
     {
         auto* rn = doc_.get_node(row);
         if (!rn) return;
-        
-        auto* tbl = doc_.get_node(rn->table);
+
+        auto step = open_step();
+        auto* tbl = row_layout_table(rn->table);
         if (!tbl) return;
+        journal(row);
         
         auto col_it = std::ranges::find(tbl->columns, col);
         if (col_it == tbl->columns.end()) return;
@@ -1574,8 +2637,8 @@ namespace nuno
         update_array_and_check(
             cell,
             cell.type,
-            [this, row]() { doc_.mark_row_contaminated(row); },
-            [this, row]() { doc_.request_clear_contamination(row); }
+            [this, row]() { mark_contaminated(row); },
+            [this, row]() { request_clear(row); }
         );
         
         cell.is_edited = true;
@@ -1590,10 +2653,13 @@ namespace nuno
         table_id table,
         std::vector<value> cells)
     {
-        auto* tbl = doc_.get_node(table);
+        auto step = open_step();
+        auto* tbl = row_layout_table(table);
         if (!tbl) 
             return invalid_id<row_tag>();
 
+        journal_header(table);
+
         row_id id = doc_.create_row_id();
 
         document::row_node rn;
@@ -1611,61 +2677,146 @@ namespace nuno
             if (!col)
                 return invalid_id<row_tag>(); // structural corruption
 
-            typed_value tv;
+            value v = i < cells.size() ? std::move(cells[i]) : value{};
+            make_table_cell(rn.cells.emplace_back(), std::move(v), col->_type(), row_has_invalid);
+        }
 
-            if (i < cells.size())
-                tv.val = std::move(cells[i]);
-            else
-                tv.val = value{}; // default/empty
+        rn.contamination = row_has_invalid
+            ? contamination_state::contaminated
+            : contamination_state::clean;
+
+        doc_.insert_node(doc_.rows_, std::move(rn));
+        journal_created(id);
+        list_insert(list_kind::rows, table.val, tbl->rows, tbl->rows.size(), id);
+        list_insert(list_kind::table_items, table.val, tbl->ordered_items,
+                    tbl->ordered_items.size(), document::source_item_ref{id});
+
+        // Registered once stored, so the source reaches its table
+        if (row_has_invalid)
+            mark_contaminated(id);
+
+        return id;
+    }
+
+    inline row_id editor::append_rows(
+        table_id table,
+        std::span<std::vector<value>> rows)
+    {
+        auto step = open_step();
+
+        auto* tbl = doc_.get_node(table);
+        if (!tbl || rows.empty())
+            return invalid_id<row_tag>();
+
+        journal_header(table);
+
+        std::vector<value_type> declared;
+        declared.reserve(tbl->columns.size());
+        for (auto cid : tbl->columns)
+        {
+            auto* col = doc_.get_node(cid);
+            if (!col)
+                return invalid_id<row_tag>(); // structural corruption
+            declared.push_back(col->_type());
+        }
 
-            tv.origin   = value_locus::table_cell;
-            tv.creation = creation_state::generated;
-            tv.is_edited = false;
+        doc_.rows_.reserve(doc_.rows_.size() + rows.size());
+        tbl->rows.reserve(tbl->rows.size() + rows.size());
+        tbl->lookup.reserve(tbl->rows.size() + rows.size());
+        tbl->ordered_items.reserve(tbl->ordered_items.size() + rows.size());
 
-            value_type declared_type = col->_type();
+        row_id first = invalid_id<row_tag>();
+        std::vector<row_id> invalid_rows;
+        std::vector<typed_value> scratch;
 
-            tv.type = tv.held_type();
+        for (auto& cells : rows)
+        {
+            row_id id = doc_.create_row_id();
+            if (!first.valid())
+                first = id;
+
+            document::row_node rn;
+            rn.id    = id;
+            rn.table = table;
+            rn.owner = tbl->owner;
 
-            if (declared_type != value_type::unresolved)
+            // Columnar rows are built in scratch and pushed to the store
+            auto& out = tbl->store ? scratch : rn.cells;
+            out.clear();
+            out.reserve(declared.size());
+
+            bool row_has_invalid = false;
+            for (size_t i = 0; i < declared.size(); ++i)
             {
-                if (tv.type != declared_type)
-                {
-                    tv.semantic = semantic_state::invalid;
-                    tv.type_source = type_ascription::tacit;
-                    row_has_invalid = true;
-                }
+                if (i < cells.size())
+                    make_table_cell(out.emplace_back(), std::move(cells[i]), declared[i], row_has_invalid);
                 else
-                {
-                    tv.semantic = semantic_state::valid;
-                    tv.type_source = type_ascription::declared;
-                }
+                    make_table_cell(out.emplace_back(), value{}, declared[i], row_has_invalid);
             }
-            else
+
+            if (tbl->store)
             {
-                tv.semantic = semantic_state::valid;
-                tv.type_source = type_ascription::tacit;
+                for (size_t i = 0; i < out.size(); ++i)
+                    tbl->store->columns[i].push_back(out[i]);
+                rn.store_index = tbl->store->row_count++;
             }
 
-            tv.contamination = contamination_state::clean;
+            if (row_has_invalid)
+            {
+                rn.contamination = contamination_state::contaminated;
+                invalid_rows.push_back(id);
+            }
 
-            rn.cells.push_back(std::move(tv));
+            doc_.insert_node(doc_.rows_, std::move(rn));
+            journal_created(id);
+            list_insert(list_kind::rows, table.val, tbl->rows, tbl->rows.size(), id);
+            list_insert(list_kind::table_items, table.val, tbl->ordered_items,
+                        tbl->ordered_items.size(), document::source_item_ref{id});
         }
 
-        if (row_has_invalid)
+        // Sources are registered once all rows are stored; the first
+        // raises the ancestors, the rest find them raised
+        for (auto id : invalid_rows)
+            mark_contaminated(id);
+
+        return first;
+    }
+
+    inline void editor::make_table_cell(
+        typed_value& tv,
+        value&& val,
+        value_type declared_type,
+        bool& invalid)
+    {
+        tv.val = std::move(val);
+
+        tv.origin   = value_locus::table_cell;
+        tv.creation = creation_state::generated;
+        tv.is_edited = false;
+
+        tv.type = tv.held_type();
+
+        if (declared_type != value_type::unresolved)
         {
-            rn.contamination = contamination_state::contaminated;
-            doc_.mark_row_contaminated(id);
+            if (tv.type != declared_type)
+            {
+                tv.semantic = semantic_state::invalid;
+                tv.type_source = type_ascription::tacit;
+                invalid = true;
+            }
+            else
+            {
+                tv.semantic = semantic_state::valid;
+                tv.type_source = type_ascription::declared;
+            }
         }
         else
         {
-            rn.contamination = contamination_state::clean;
+            tv.semantic = semantic_state::valid;
+            tv.type_source = type_ascription::tacit;
         }
 
-        doc_.rows_.push_back(std::move(rn));
-        tbl->rows.push_back(id);
-        tbl->ordered_items.push_back({id});
-
-        return id;
+        tv.contamination = contamination_state::clean;
     }
 
     template<typename Tag>
@@ -1684,15 +2835,15 @@ namespace nuno
         auto* tbl = doc_.get_node(table);
         if (!tbl) return invalid_id<row_tag>();
 
+        auto step = open_step();
         row_id new_id = append_row(table, std::move(cells));
         if (!valid(new_id)) return new_id;
 
+        doc_.purge_erased_rows(*tbl);
+
         // Remove auto-appended entry
-        std::erase(tbl->rows, new_id);
-        std::erase_if(tbl->ordered_items, [&](auto const& r) {
-            return std::holds_alternative<row_id>(r.id)
-                && std::get<row_id>(r.id) == new_id;
-        });
+        list_erase(list_kind::rows, table.val, tbl->rows, new_id);
+        list_erase(list_kind::table_items, table.val, tbl->ordered_items, document::source_item_ref{new_id});
 
         // Find anchor position
         auto it = std::ranges::find_if(tbl->ordered_items, [&](auto const& r) {
@@ -1709,12 +2860,64 @@ namespace nuno
             if (it != tbl->ordered_items.end()) ++it;
         }
 
-        tbl->rows.insert(row_it, new_id);
-        tbl->ordered_items.insert(it, {new_id});
+        list_insert(list_kind::rows, table.val, tbl->rows,
+                    static_cast<size_t>(row_it - tbl->rows.begin()), new_id);
+        list_insert(list_kind::table_items, table.val, tbl->ordered_items,
+                    static_cast<size_t>(it - tbl->ordered_items.begin()), document::source_item_ref{new_id});
 
         return new_id;
     }
 
+    inline void editor::move_row_impl(
+        row_id row,
+        row_id anchor,
+        insert_direction dir)
+    {
+        if (row == anchor) return;
+
+        auto* rn = doc_.get_node(row);
+        auto* an = doc_.get_node(anchor);
+        if (!rn || !an || rn->table != an->table) return;
+
+        auto* tbl = doc_.get_node(rn->table);
+        if (!tbl) return;
+
+        doc_.purge_erased_rows(*tbl);
+        auto step = open_step();
+
+        auto is_anchor = [&](auto const& r) {
+            return std::holds_alternative<row_id>(r.id)
+                && std::get<row_id>(r.id) == anchor;
+        };
+
+        list_erase(list_kind::rows, tbl->id.val, tbl->rows, row);
+        list_erase(list_kind::table_items, tbl->id.val, tbl->ordered_items, document::source_item_ref{row});
+
+        auto row_it = std::ranges::find(tbl->rows, anchor);
+        auto it     = std::ranges::find_if(tbl->ordered_items, is_anchor);
+
+        if (dir == insert_direction::after)
+        {
+            if (row_it != tbl->rows.end()) ++row_it;
+            if (it != tbl->ordered_items.end()) ++it;
+        }
+
+        list_insert(list_kind::rows, tbl->id.val, tbl->rows,
+                    static_cast<size_t>(row_it - tbl->rows.begin()), row);
+        list_insert(list_kind::table_items, tbl->id.val, tbl->ordered_items,
+                    static_cast<size_t>(it - tbl->ordered_items.begin()), document::source_item_ref{row});
+    }
+
+    inline void editor::move_row_before(row_id row, row_id anchor)
+    {
+        move_row_impl(row, anchor, insert_direction::before);
+    }
+
+    inline void editor::move_row_after(row_id row, row_id anchor)
+    {
+        move_row_impl(row, anchor, insert_direction::after);
+    }
+
     template<typename Tag>
     row_id editor::insert_row_before(
         id<Tag> anchor,
@@ -1736,14 +2939,18 @@ namespace nuno
         auto* cn = doc_.get_node(id);
         if (!cn) return false;
         
-        auto* tbl = doc_.get_node(cn->table);
+        auto step = open_step();
+        auto* tbl = row_layout_table(cn->table);
         if (!tbl) return false;
         
         // Find column index
         auto col_it = std::ranges::find(tbl->columns, id);
         if (col_it == tbl->columns.end()) return false;
-        
+
         size_t col_idx = std::distance(tbl->columns.begin(), col_it);
+
+        journal(id);
+        journal_column(*tbl, col_idx, column_edit::erased);
         
         // Remove cells from all rows at this index
         for (auto rid : tbl->rows)
@@ -1769,20 +2976,23 @@ namespace nuno
             if (has_invalid)
             {
                 rn->contamination = contamination_state::contaminated;
-                doc_.mark_row_contaminated(rid);
+                mark_contaminated(rid);
             }
             else
             {
-                rn->contamination = contamination_state::clean;
-                doc_.request_clear_contamination(rid);
+                request_clear(rid);
             }
         }
         
+        // The next column names the rows now
+        if (col_idx == 0)
+            doc_.index_rows(*tbl);
+
         // Remove column from table
         tbl->columns.erase(col_it);
         
         // Remove column node
-        std::erase_if(doc_.columns_, [&](auto& c) { return c._id() == id; });
+        doc_.erase_node(doc_.columns_, id);
         
         return true;
     }
@@ -1793,9 +3003,12 @@ namespace nuno
         std::optional<value_type> declared_type
     )
     {
-        auto* tbl = doc_.get_node(table_id);
+        auto step = open_step();
+        auto* tbl = row_layout_table(table_id);
         if (!tbl) return invalid_id<column_tag>();
 
+        journal_header(table_id);
+        journal_column(*tbl, tbl->columns.size(), column_edit::inserted);
         column_id cid = create_column_node_only(table_id, name, declared_type);
         tbl->columns.push_back(cid);
 
@@ -1816,9 +3029,12 @@ namespace nuno
             rn->cells.push_back(std::move(empty_cell));
 
             // A monostate cell is invalid.
-            doc_.mark_row_contaminated(rid);
+            mark_contaminated(rid);
         }
 
+        if (tbl->columns.size() == 1)
+            doc_.index_rows(*tbl);
+
         return cid;
     }
 
@@ -1831,14 +3047,17 @@ namespace nuno
         if (!anchor_node) return invalid_id<column_tag>();
 
         table_id owner = anchor_node->table;
-        auto* tbl = doc_.get_node(owner);
+        auto step = open_step();
+        auto* tbl = row_layout_table(owner);
         if (!tbl) return invalid_id<column_tag>();
 
+        journal_header(owner);
         column_id cid = create_column_node_only(owner, name, declared_type);
 
         auto it = std::ranges::find(tbl->columns, anchor);
         auto ins_it = tbl->columns.insert(it, cid);
         auto dist = std::distance(tbl->columns.begin(), ins_it);
+        journal_column(*tbl, dist, column_edit::inserted);
 
         for (auto rid : tbl->rows) 
         {
@@ -1859,9 +3078,13 @@ namespace nuno
             rn->cells.insert( pos, std::move(empty_cell) );
             
             // A monostate cell is invalid.
-            doc_.mark_row_contaminated(rid);
+            mark_contaminated(rid);
         }
 
+        // The new column names the rows now
+        if (dist == 0)
+            doc_.index_rows(*tbl);
+
         return cid;
     }
 
@@ -1874,15 +3097,18 @@ namespace nuno
         if (!anchor_node) return invalid_id<column_tag>();
 
         table_id owner = anchor_node->table;
-        auto* tbl = doc_.get_node(owner);
+        auto step = open_step();
+        auto* tbl = row_layout_table(owner);
         if (!tbl) return invalid_id<column_tag>();
 
+        journal_header(owner);
         column_id cid = create_column_node_only(owner, name, declared_type);
 
         auto it = std::ranges::find(tbl->columns, anchor);
         if (it != tbl->columns.end()) ++it;
         auto ins_it = tbl->columns.insert(it, cid);
         auto dist = std::distance(tbl->columns.begin(), ins_it);
+        journal_column(*tbl, dist, column_edit::inserted);
 
         for (auto rid : tbl->rows) 
         {
@@ -1903,9 +3129,13 @@ namespace nuno
             rn->cells.insert( pos, std::move(empty_cell) );
             
             // A monostate cell is invalid.
-            doc_.mark_row_contaminated(rid);
+            mark_contaminated(rid);
         }
 
+        // The new column names the rows now
+        if (dist == 0)
+            doc_.index_rows(*tbl);
+
         return cid;
     }
 
@@ -1917,8 +3147,10 @@ namespace nuno
         auto* rn = doc_.get_node(row);
         if (!rn) return;
 
-        auto* tbl = doc_.get_node(rn->table);
+        auto step = open_step();
+        auto* tbl = row_layout_table(rn->table);
         if (!tbl) return;
+        journal(row);
 
         auto col_it = std::ranges::find(tbl->columns, col);
         if (col_it == tbl->columns.end()) return;
@@ -1931,7 +3163,9 @@ namespace nuno
 
         auto& cell = rn->cells[idx];
 
+        // The first cell names the row
         cell.val       = std::move(val);
+        if (idx == 0) doc_.rename_listed_row(*rn);
         cell.origin    = value_locus::table_cell;
         cell.creation  = creation_state::generated;
         cell.is_edited = true;
@@ -1945,7 +3179,7 @@ namespace nuno
             cell.semantic   = semantic_state::invalid;
             cell.contamination = contamination_state::clean;
 
-            doc_.mark_row_contaminated(row);
+            mark_contaminated(row);
         }
         else
         {
@@ -1953,7 +3187,7 @@ namespace nuno
             cell.semantic   = semantic_state::valid;
             cell.contamination = contamination_state::clean;
 
-            doc_.request_clear_contamination(row);
+            request_clear(row);
         }
 
         rn->is_edited = true;
@@ -1967,8 +3201,10 @@ namespace nuno
         auto* rn = doc_.get_node(row);
         if (!rn) return;
 
-        auto* tbl = doc_.get_node(rn->table);
+        auto step = open_step();
+        auto* tbl = row_layout_table(rn->table);
         if (!tbl) return;
+        journal(row);
 
         auto col_it = std::ranges::find(tbl->columns, col);
         if (col_it == tbl->columns.end()) return;
@@ -1988,7 +3224,7 @@ namespace nuno
             expected_array_type != value_type::unresolved)
         {
             cell.semantic = semantic_state::invalid;
-            doc_.mark_row_contaminated(row);
+            mark_contaminated(row);
             rn->is_edited = true;
             return;
         }
@@ -2013,6 +3249,7 @@ namespace nuno
         }
 
         cell.val         = std::move(typed_arr);
+        if (idx == 0) doc_.rename_listed_row(*rn);
         cell.type        = expected_array_type;
         cell.origin      = value_locus::table_cell;
         cell.creation    = creation_state::generated;
@@ -2024,9 +3261,9 @@ namespace nuno
                 : contamination_state::clean;
 
         if (has_invalid)
-            doc_.mark_row_contaminated(row);
+            mark_contaminated(row);
         else
-            doc_.request_clear_contamination(row);
+            request_clear(row);
 
         rn->is_edited = true;
     }
@@ -2039,21 +3276,45 @@ namespace nuno
         auto* tbl = doc_.get_node(rn->table);
         if (!tbl) return false;
 
-        doc_.request_clear_contamination(id);
+        auto step = open_step();
+        journal(id);
+
+        request_clear(id);
 
-        std::erase_if(tbl->ordered_items, [&](auto const& r)
+        // Tombstoned; the row lists of the table keep the ID until they
+        // are sparse enough to purge, unless the erase is journalled by
+        // position
+        if (recording())
         {
-            return std::holds_alternative<row_id>(r.id)
-                && std::get<row_id>(r.id) == id;
-        });
+            list_erase(list_kind::rows, tbl->id.val, tbl->rows, id);
+            list_erase(list_kind::table_items, tbl->id.val, tbl->ordered_items, document::source_item_ref{id});
+        }
+        doc_.erase_row_node(id, !recording());
+        doc_.compact_sparse(tbl);
 
-        std::erase_if(tbl->rows, [&](auto const& rid) {return rid == id;});
+        // An erased source no longer holds its table contaminated
+        reevaluate(tbl->id);
 
-        auto& rows = doc_.rows_;
-        rows.erase(
-            std::ranges::find_if(rows, [&](auto const& r){return r.id == id;})
-        );
+        return true;
+    }
+
+    inline bool editor::set_table_layout(table_id table, table_layout layout)
+    {
+        auto* tbl = doc_.get_node(table);
+        if (!tbl) return false;
+
+        auto step = open_step();
+        bool columnar = tbl->store != nullptr;
+        std::unique_ptr<column_store> left;
+        auto indices = recording() ? store_indices(*tbl) : std::vector<std::pair<row_id, size_t>>{};
+
+        if (layout == table_layout::rows)
+            left = doc_.make_row_oriented(*tbl);
+        else if (!doc_.make_columnar(*tbl))
+            return false;
 
+        if (recording() && columnar != (tbl->store != nullptr))
+            history_->step.push_back(layout_change{table, std::move(left), std::move(indices)});
         return true;
     }
 
@@ -2065,38 +3326,46 @@ namespace nuno
         auto* cat = doc_.get_node(tbl->owner);
         if (!cat) return false;
 
-        // 1. Erase rows (they may be contamination sources)
+        auto step = open_step();
+        if (recording())
+        {
+            journal(id);
+            for (auto cid : tbl->columns)
+                journal(cid);
+        }
+
+        // 1. Erase rows (they may be contamination sources). The image
+        // of a row takes over the cells its erase drops, not a copy.
         for (auto rid : tbl->rows)
         {
-            doc_.request_clear_contamination(rid);
+            auto* rn = doc_.get_node(rid);
+            if (!rn) continue;
 
-            std::erase_if(cat->ordered_items, [&](auto const& r)
-            {
-                return std::holds_alternative<row_id>(r.id)
-                    && std::get<row_id>(r.id) == rid;
-            });
+            auto cells = std::move(rn->cells);
+            size_t journalled = recording() ? history_->step.size() : 0;
+            journal(rid);
+            bool imaged = recording() && history_->step.size() > journalled;
+            rn->cells = std::move(cells);
 
-            std::erase_if(doc_.rows_, [&](auto & r){return r.id == rid;});
+            request_clear(rid);
+            if (imaged)
+                std::get<node_image<document::row_node>>(history_->step.back()).node->cells = std::move(rn->cells);
+            doc_.erase_row_node(rid);
         }
 
         // 2. Erase columns
-        for (auto cid : tbl->columns)
-            std::erase_if(doc_.columns_, [&](auto & c){return c._id() == cid;});
+        doc_.erase_nodes_if(doc_.columns_, [&](auto const & c){return c.table == id;});
 
         // 3. Remove table from category
-        std::erase(cat->tables, id);
-
-        std::erase_if(cat->ordered_items, [&](auto const& r)
-        {
-            return std::holds_alternative<table_id>(r.id)
-                && std::get<table_id>(r.id) == id;
-        });
+        list_erase(list_kind::tables, cat->id.val, cat->tables, id);
+        list_erase(list_kind::category_items, cat->id.val, cat->ordered_items, document::source_item_ref{id});
 
         // 4. Remove table storage
-        std::erase_if(doc_.tables_, [&](auto & t){return t.id == id;});
+        doc_.erase_node(doc_.tables_, id);
+        doc_.compact_sparse(nullptr);
 
         // 5. Remove contamination from owning category
-        doc_.try_clear_category_contamination(cat->id);
+        reevaluate(cat->id);
 
         return true;
     }
@@ -2118,11 +3387,13 @@ namespace nuno
         category_id where,
         std::vector<std::pair<std::string, std::optional<value_type>>> columns)
     {
+        auto step = open_step();
         table_id id = create_table_node_only(where, std::move(columns));
         if (!valid(id)) return id;
 
         auto* cat = doc_.get_node(where);
-        cat->ordered_items.push_back({id});
+        list_insert(list_kind::category_items, where.val, cat->ordered_items,
+                    cat->ordered_items.size(), document::source_item_ref{id});
 
         return id;
     }
@@ -2195,11 +3466,13 @@ namespace nuno
         category_id where,
         std::string_view text)
     {
+        auto step = open_step();
         comment_id id = create_comment_node_only(where, text);
         if (!valid(id)) return id;
 
         auto* cat = doc_.get_node(where);
-        cat->ordered_items.push_back({id});
+        list_insert(list_kind::category_items, where.val, cat->ordered_items,
+                    cat->ordered_items.size(), document::source_item_ref{id});
 
         return id;
     }
@@ -2209,6 +3482,8 @@ namespace nuno
         auto* cn = doc_.get_node(id);
         if (!cn) return;
 
+        auto step = open_step();
+        journal(id);
         cn->text = std::string(text);
         cn->creation = creation_state::generated;
         cn->is_edited = true;
@@ -2249,11 +3524,13 @@ namespace nuno
         category_id where,
         std::string_view text)
     {
+        auto step = open_step();
         paragraph_id id = create_paragraph_node_only(where, text);
         if (!valid(id)) return id;
 
         auto* cat = doc_.get_node(where);
-        cat->ordered_items.push_back({id});
+        list_insert(list_kind::category_items, where.val, cat->ordered_items,
+                    cat->ordered_items.size(), document::source_item_ref{id});
 
         return id;
     }
@@ -2263,6 +3540,8 @@ namespace nuno
         auto* pn = doc_.get_node(id);
         if (!pn) return;
 
+        auto step = open_step();
+        journal(id);
         pn->text = std::string(text);
         pn->creation = creation_state::generated;
         pn->is_edited = true;
@@ -2307,6 +3586,9 @@ namespace nuno
         auto* kn = doc_.get_node(id);
         if (!kn) return false;
 
+        auto step = open_step();
+        journal(id);
+
         // Store old type for validation
         value_type old_type = kn->type;
 
@@ -2371,16 +3653,17 @@ namespace nuno
             kn->semantic      = semantic_state::invalid;
             kn->contamination = contamination_state::contaminated;
 
-            doc_.mark_key_contaminated(id);
+            mark_contaminated(id);
         }
         else
         {
             tv.semantic       = semantic_state::valid;
             tv.contamination  = contamination_state::clean;
             kn->semantic      = semantic_state::valid;
-            kn->contamination = contamination_state::clean;
 
-            doc_.request_clear_contamination(id);
+            // The key flag is cleared with the source, and only if the
+            // key is clean throughout (its array elements included)
+            request_clear(id);
         }
 
         return is_valid;
@@ -2394,6 +3677,7 @@ namespace nuno
         auto* cn = doc_.get_node(id);
         if (!cn) return false;
 
+        auto step = open_step();
         auto* tbl = doc_.get_node(cn->table);
         if (!tbl) return false;
 
@@ -2402,6 +3686,9 @@ namespace nuno
         
         size_t col_idx = std::distance(tbl->columns.begin(), col_it);
 
+        journal(id);
+        journal_column(*tbl, col_idx, column_edit::cells);
+
         // Update column metadata
         cn->col.type        = type;
         cn->col.type_source = ascription;
@@ -2409,14 +3696,10 @@ namespace nuno
 
         bool any_invalid = false;
 
-        // PHASE 1: Update and validate each cell in this column
-        for (auto rid : tbl->rows)
+        // Retypes one cell holding a value of type held; returns whether
+        // it is valid under the new type
+        auto retype_cell = [&](typed_value& cell, value_type held)
         {
-            auto* rn = doc_.get_node(rid);
-            if (!rn || col_idx >= rn->cells.size()) continue;
-
-            auto& cell = rn->cells[col_idx];
-            
             cell.type        = type;
             cell.type_source = ascription;
             cell.is_edited   = true;
@@ -2452,27 +3735,65 @@ namespace nuno
                 }
                 else
                 {
-                    if (cell.held_type() != type)
+                    if (held != type)
                     {
                         cell_valid = false;
                     }
                 }
             }
+            else if (is_array(cell))
+            {
+                // No type, so no element can be invalid against it
+                for (auto& elem : std::get<std::vector<typed_value>>(cell.val))
+                    elem.semantic = semantic_state::valid;
+            }
 
             // Update cell state (but don't touch row contamination yet)
-            if (!cell_valid)
+            cell.semantic      = cell_valid ? semantic_state::valid : semantic_state::invalid;
+            cell.contamination = contamination_state::clean;
+            any_invalid |= !cell_valid;
+            return cell_valid;
+        };
+
+        // PHASE 1: Update and validate each cell in this column
+        if (tbl->store && col_idx < tbl->store->columns.size())
+        {
+            // Columnar: packed cells share their metadata, so they are
+            // retyped once through the prototype and their validity
+            // written in one sequential pass. Exceptions are per cell.
+            auto& column = tbl->store->columns[col_idx];
+            if (recording())
+                history_->step.push_back(column_cells{tbl->id, col_idx, column.metadata()});
+
+            bool any_packed   = column.size() > column.exceptions().size();
+            bool packed_valid = !any_packed || retype_cell(column.prototype(), column.packed_type());
+            column.prototype().semantic = semantic_state::valid;
+
+            for (size_t r = 0; r < column.size(); ++r)
+                if (column.is_packed(r))
+                    column.set_invalid(r, !packed_valid);
+
+            for (auto& [r, cell] : column.exceptions())
+                retype_cell(cell, cell.held_type());
+
+            for (auto rid : tbl->rows)
             {
-                cell.semantic      = semantic_state::invalid;
-                cell.contamination = contamination_state::clean;
-                any_invalid = true;
+                auto* rn = doc_.get_node(rid);
+                if (!rn) continue;
+
+                rn->is_edited = true;
             }
-            else
+        }
+        else
+        {
+            for (auto rid : tbl->rows)
             {
-                cell.semantic      = semantic_state::valid;
-                cell.contamination = contamination_state::clean;
-            }
+                auto* rn = doc_.get_node(rid);
+                if (!rn || col_idx >= rn->cells.size()) continue;
 
-            rn->is_edited = true;
+                retype_cell(rn->cells[col_idx], rn->cells[col_idx].held_type());
+                rn->is_edited = true;
+            }
         }
 
         // PHASE 2: Re-evaluate entire row contamination states
@@ -2482,26 +3803,20 @@ namespace nuno
             if (!rn) continue;
             
             // Check ALL cells in this row
-            bool row_has_invalid = false;
-            for (auto& cell : rn->cells)
+            bool row_has_invalid = !doc_.for_each_cell(*rn, [](typed_value const& cell)
             {
-                if (cell.semantic == semantic_state::invalid ||
-                    cell.contamination == contamination_state::contaminated)
-                {
-                    row_has_invalid = true;
-                    break;
-                }
-            }
+                return cell.semantic != semantic_state::invalid
+                    && cell.contamination != contamination_state::contaminated;
+            });
             
             if (row_has_invalid)
             {
                 rn->contamination = contamination_state::contaminated;
-                doc_.mark_row_contaminated(rid);
+                mark_contaminated(rid);
             }
             else
             {
-                rn->contamination = contamination_state::clean;
-                doc_.request_clear_contamination(rid);
+                request_clear(rid);
             }
         }
 
@@ -17,6 +17,7 @@
 #include "nuno_parser.hpp"
 #include "nuno_document.hpp"
 #include <array>
+#include <charconv>
 #include <memory>
 #include <ranges>
 #include <unordered_map>
@@ -35,6 +36,7 @@ namespace nuno
     {
         bool own_parser_data {true}; // Document will assume ownership of the parser data. Without it the serialiser will not be able to output the original format.
         size_t max_category_depth {64};
+        size_t columnar_min_rows {0}; // Tables with at least this many rows are stored column-wise. 0 keeps all tables row-oriented.
     //--Debug options
         bool echo_lines  {false}; // prints each CST parser event to be handled
         bool echo_errors {false}; // prints each logged error 
@@ -104,8 +106,25 @@ namespace nuno
 
         // State
         materialiser_options     opts_;
-        std::vector<category_id> stack_;
+
+        // Open categories and the active table are held by their slots
+        // in the document's node storage, so that no event needs an ID
+        // lookup. (Slots rather than pointers, as insertions may
+        // reallocate the storage.)
+        struct scope
+        {
+            category_id id;
+            size_t      slot;
+        };
+
+        std::vector<scope>       stack_;
         std::optional<table_id>  active_table_;
+        size_t                   active_table_slot_ {0};
+        std::vector<size_t>      active_column_slots_;
+        bool                     active_columns_invalid_ {false};
+
+        document::category_node & active_category() { return doc_.categories_[stack_.back().slot]; }
+        document::table_node    & active_table()    { return doc_.tables_[active_table_slot_]; }
 
         // Materialisation can break the direct 
         // correspondence between CST events and
@@ -116,8 +135,6 @@ namespace nuno
 
         // Helpers
         void insert_source_item(document::source_id id);
-        document::table_node * find_table(table_id tid);
-        document::category_node * find_category(category_id cid);
 
         void handle_category_open(const parse_event& ev, size_t parse_idx );
         void handle_category_close(const parse_event& ev, size_t parse_idx);
@@ -164,20 +181,127 @@ namespace
         }
     }
 
-    std::optional<bool> is_bool(std::string_view s)
+    inline std::optional<bool> is_bool(std::string_view s)
     {
-        static std::unordered_map<std::string_view, bool> booleans = 
+        // Further spellings (yes/no, on/off) would go here
+        if (s == "true")  return true;
+        if (s == "false") return false;
+        return std::nullopt;
+    };
+
+//========================================================================
+// Literal classification
+// ---------------------------
+// Numeric literals are read with std::from_chars: locale independent,
+// non-allocating, and bounded by the view, so literals need not be
+// NUL-terminated. The accepted forms are those strtol/strtod accepted
+// in base 10, i.e. leading whitespace and a '+' sign are allowed. Hex
+// floats are not numbers, and out of range integers are not integers
+// (strtol clamped them).
+//========================================================================
+
+    // Strips what from_chars does not accept but strtol/strtod did.
+    // Returns false if nothing convertible can remain.
+    inline bool numeric_prefix(std::string_view & s)
+    {
+        size_t i = 0;
+        while (i < s.size() && (s[i] == ' ' || (s[i] >= '\t' && s[i] <= '\r')))
+            ++i;
+
+        if (i < s.size() && s[i] == '+')
         {
-            {"true", true}, {"false", false},
-            // {"yes",  true}, {"no",    false},
-            // {"on",   true}, {"off",   false},
-        };
+            ++i;
+            if (i < s.size() && s[i] == '-')
+                return false;
+        }
 
-        if (auto it = booleans.find(s); it != booleans.end())
-            return it->second;
-        return std::nullopt;
+        s.remove_prefix(i);
+        return !s.empty();
+    }
+
+    template <typename T>
+    std::optional<T> from_chars_exact(std::string_view s)
+    {
+        // As with strtol/strtod, an empty literal reads as zero
+        if (s.empty())
+            return T{};
+
+        if (!numeric_prefix(s))
+            return std::nullopt;
+
+        T v{};
+        auto [ptr, ec] = std::from_chars(s.data(), s.data() + s.size(), v);
+        if (ptr != s.data() + s.size())
+            return std::nullopt;
+
+        if constexpr (std::is_floating_point_v<T>)
+        {
+            // Overflow to infinity and underflow to zero, as strtod does.
+            // Rare enough to take the slow path.
+            if (ec == std::errc::result_out_of_range)
+                return static_cast<T>(std::strtod(std::string(s).c_str(), nullptr));
+        }
+
+        if (ec != std::errc{})
+            return std::nullopt;
+        return v;
+    }
+
+    inline std::optional<int64_t> parse_integer(std::string_view s)
+    {
+        return from_chars_exact<int64_t>(s);
+    }
+
+    inline std::optional<double> parse_real(std::string_view s)
+    {
+        return from_chars_exact<double>(s);
+    }
+
+    enum class literal_kind { boolean, integer, floating_point, string };
+
+    struct classified_literal
+    {
+        literal_kind kind;
+        bool         b {false};
+        int64_t      i {0};
+        double       d {0.0};
     };
 
+    // Decides the tacit type of a literal in one pass: bool, then int,
+    // then float, else string. Only literals that can start a number
+    // are converted at all.
+    inline classified_literal classify_literal(std::string_view s)
+    {
+        if (s.empty())
+            return { literal_kind::integer };
+
+        switch (s.front())
+        {
+            case 't': case 'f':
+                if (auto b = is_bool(s))
+                    return { .kind = literal_kind::boolean, .b = *b };
+                return { literal_kind::string };
+
+            // Digits, signs, a leading point, inf/nan and whitespace
+            // may start a number
+            case '0': case '1': case '2': case '3': case '4':
+            case '5': case '6': case '7': case '8': case '9':
+            case '-': case '+': case '.':
+            case 'i': case 'I': case 'n': case 'N':
+            case ' ': case '\t': case '\n': case '\v': case '\f': case '\r':
+                break;
+
+            default:
+                return { literal_kind::string };
+        }
+
+        if (auto i = parse_integer(s))
+            return { .kind = literal_kind::integer, .i = *i };
+        if (auto d = parse_real(s))
+            return { .kind = literal_kind::floating_point, .d = *d };
+        return { literal_kind::string };
+    }
+
     inline std::optional<value_type> parse_declared_type(std::string_view s, material_context & out)
     {
         static std::unordered_map<std::string_view, value_type> valid_types = 
@@ -215,33 +339,29 @@ namespace
         tv.origin = value_locus::key_value;
         tv.creation = creation_state::authored;
 
-        if (auto b = is_bool(s); b.has_value())
+        auto lit = classify_literal(s);
+        switch (lit.kind)
         {
-            tv.type = value_type::boolean;
-            tv.val  = b.value();
-            return tv;
-        }
+            case literal_kind::boolean:
+                tv.type = value_type::boolean;
+                tv.val  = lit.b;
+                break;
 
-        char* end = nullptr;
-        long i = std::strtol(s.data(), &end, 10);
-        if (end == s.data() + s.size())
-        {
-            tv.type = value_type::integer;
-            tv.val  = static_cast<int64_t>(i);
-            return tv;
-        }
+            case literal_kind::integer:
+                tv.type = value_type::integer;
+                tv.val  = lit.i;
+                break;
 
-        char* fend = nullptr;
-        double d = std::strtod(s.data(), &fend);
-        if (fend == s.data() + s.size())
-        {
-            tv.type = value_type::floating_point;
-            tv.val  = d;
-            return tv;
-        }
+            case literal_kind::floating_point:
+                tv.type = value_type::floating_point;
+                tv.val  = lit.d;
+                break;
 
-        tv.type = value_type::string;
-        tv.val  = std::string(s);
+            case literal_kind::string:
+                tv.type = value_type::string;
+                tv.val  = std::string(s);
+                break;
+        }
         return tv;
     }    
 
@@ -252,7 +372,7 @@ namespace
             std::string msg("could not convert ");
             msg += s;
             msg += " to ";
-            msg += type_to_string(t);
+            msg += detail::type_to_string(t);
 
             err.push_back({
                 semantic_error_kind::type_mismatch,
@@ -267,28 +387,16 @@ namespace
                 return std::string(s);
 
             case value_type::integer:
-            {
-                char* end = nullptr;
-                long v = std::strtol(s.data(), &end, 10);
-                if (end != s.data() + s.size())
-                {
-                    log_err();
-                    return std::nullopt;
-                }
-                return static_cast<int64_t>(v);
-            }
+                if (auto v = parse_integer(s))
+                    return *v;
+                log_err();
+                return std::nullopt;
 
             case value_type::floating_point:
-            {
-                char* end = nullptr;
-                double v = std::strtod(s.data(), &end);
-                if (end != s.data() + s.size())
-                {
-                    log_err();
-                    return std::nullopt;
-                }
-                return v;
-            }
+                if (auto v = parse_real(s))
+                    return *v;
+                log_err();
+                return std::nullopt;
 
             case value_type::boolean:
                 if (auto b = is_bool(s); b.has_value())
@@ -588,7 +696,7 @@ namespace
     {
         cst_to_doc_category_.resize(cst_.categories.size());
         category_id root = doc_.create_root();
-        stack_.push_back(root);
+        stack_.push_back({ root, doc_.categories_.size() - 1 });
     }
 
     inline material_context materialiser::run()
@@ -640,6 +748,10 @@ namespace
             }
         }
 
+        // Row lookups are built once each table holds all its rows
+        for (auto & tbl : doc_.tables_)
+            doc_.index_rows(tbl);
+
         if (opts_.own_parser_data)
         {
             // Transfer ownership via move
@@ -648,6 +760,8 @@ namespace
                 std::make_unique<parse_context>(std::move(ctx_));
                 // I had expected the const-ness of ctx_ to require:
                 //std::make_unique<parse_context>(std::move(const_cast<parse_context&>(ctx_)));
+
+            doc_.map_source_extents();
         }
                 
         // Register contamination sources
@@ -667,6 +781,11 @@ namespace
         if (!doc_.rows_.empty())        doc_.next_row_id_       = doc_.rows_.back().id + 1;
         if (!doc_.tables_.empty())      doc_.next_table_id_     = doc_.tables_.back().id + 1;
 
+        if (opts_.columnar_min_rows != 0)
+            for (auto & tbl : doc_.tables_)
+                if (tbl.rows.size() >= opts_.columnar_min_rows)
+                    doc_.make_columnar(tbl);
+
         return std::move(out_);
     }
 
@@ -710,21 +829,23 @@ namespace
         active_table_.reset();
 
         const auto& cst_cat = cst_.categories[cid.val];
-        category_id parent  = stack_.back();
+        category_id parent  = stack_.back().id;
 
         category_id doc_id = doc_.create_category(cid, cst_cat.name, parent);
         if (opts_.echo_lines) DBG_EMIT << "created category id: " << cid.val << ", name: " << cst_cat.name << std::endl;
 
-        auto it = std::ranges::find_if(doc_.categories_, [doc_id](document::category_node const &cat){return cat.id.val == doc_id.val;});
-        assert (it != doc_.categories_.end());
+        // The new category is the last node inserted
+        size_t slot = doc_.categories_.size() - 1;
+        auto & cat  = doc_.categories_[slot];
+        assert (cat.id == doc_id);
 
-        it->source_event_index_open = parse_idx;        
-        it->creation = creation_state::authored;
-        it->semantic = semantic_state::valid;
+        cat.source_event_index_open = parse_idx;        
+        cat.creation = creation_state::authored;
+        cat.semantic = semantic_state::valid;
 
         cst_to_doc_category_[cid.val] = doc_id;
         insert_source_item(doc_id);
-        stack_.push_back(doc_id);
+        stack_.push_back({ doc_id, slot });
     }
 
     inline void materialiser::handle_category_close(const parse_event& ev, size_t parse_idx)
@@ -750,20 +871,17 @@ namespace
                 return;
             }
 
-            auto it = std::find_if(
+            auto sym = doc_.symbols_.find(name);
+            auto it = !sym ? stack_.rend() : std::find_if(
                 stack_.rbegin(),
                 stack_.rend(),
-                [&](category_id cid)
+                [&](scope const & s)
                 {
-                    decltype(document::categories_)::iterator it;
-                    it = std::ranges::find_if(doc_.categories_, [cid](document::category_node const &cat){return cat.id.val == cid.val;});
-                    if (it != doc_.categories_.end())
-                        return it->name == name;
-                    return false;
+                    return doc_.categories_[s.slot].name == *sym;
                 }
             );
 
-            if (it == stack_.rend() || (*it).val == stack_.front().val)
+            if (it == stack_.rend() || it->id.val == stack_.front().id.val)
             {
                 log_err(semantic_error_kind::invalid_category_close,
                         "attempt to close category that is not open",
@@ -771,17 +889,16 @@ namespace
                 return;
             }
 
-            auto cat_it = std::ranges::find_if(doc_.categories_, [cid = *it](document::category_node const &cat){return cat.id.val == cid.val;});
-            assert (cat_it != doc_.categories_.end());
-            cat_it->source_event_index_close = parse_idx;
+            category_id closing = it->id;
+            doc_.categories_[it->slot].source_event_index_close = parse_idx;
 
-            while (stack_.back() != *it)
+            while (stack_.back().id != closing)
                 stack_.pop_back();
 
             stack_.pop_back();
             active_table_.reset();
 
-            document::category_close_marker marker{*it, document::category_close_form::named};
+            document::category_close_marker marker{closing, document::category_close_form::named};
             insert_source_item(marker);
 
             return;
@@ -800,7 +917,7 @@ namespace
 
             auto closing = std::get<category_id>(ev.target);
 
-            if (stack_.back() != closing)
+            if (stack_.back().id != closing)
             {
                 log_err( semantic_error_kind::invalid_category_close,
                          "category close does not match open scope",
@@ -808,9 +925,7 @@ namespace
                 return;
             }
 
-            auto cat_it = std::ranges::find_if(doc_.categories_, [closing](document::category_node const &cat){return cat.id.val == closing.val;});
-            assert (cat_it != doc_.categories_.end());
-            cat_it->source_event_index_close = parse_idx;
+            active_category().source_event_index_close = parse_idx;
 
             stack_.pop_back();
             active_table_.reset();
@@ -828,20 +943,28 @@ namespace
         document::table_node tbl;
         tbl.id       = tid;
         tbl.creation = creation_state::authored;
-        tbl.owner    = stack_.back();
+        tbl.owner    = stack_.back().id;
         tbl.source_event_index = parse_idx;
         tbl.rows.clear();
 
+        active_column_slots_.clear();
+        active_columns_invalid_ = false;
+
         for (const auto& cst_col : cst_tbl.columns)
         {
             document::column_node col_;
-            col_.col      = cst_col;
+            col_.col.id            = cst_col.id;
+            col_.col.name          = doc_.symbols_.intern(cst_col.name);
+            col_.col.type          = cst_col.type;
+            col_.col.type_source   = cst_col.type_source;
+            col_.col.declared_type = cst_col.declared_type;
+            col_.col.semantic      = cst_col.semantic;
             col_.table    = tid;
             col_.creation = creation_state::authored;
             col_.owner    = tbl.owner;
             col_.source_event_index = parse_idx;
 
-            column & col = col_.col;
+            auto & col = col_.col;
 
             // Resolve declared column types early
             if (col.type_source == type_ascription::declared)
@@ -871,29 +994,35 @@ namespace
                 }
 
                 if (tbl.contamination == contamination_state::contaminated)
+                {
+                    // The table itself is counted by its owner once stored
+                    if (auto* owner = doc_.get_node(col_.owner))
+                        doc_.set_contamination(*owner, contamination_state::contaminated);
                     doc_.propagate_contamination_up_category_chain(col_.owner);
+                }
             }
             else
             {
                 col.type = value_type::unresolved;
             }
 
-            doc_.columns_.push_back(col_);
+            if (col.semantic == semantic_state::invalid)
+                active_columns_invalid_ = true;
+
+            doc_.insert_node(doc_.columns_, col_);
+            active_column_slots_.push_back(doc_.columns_.size() - 1);
             tbl.columns.push_back(col_.col.id);
         }
 
         // Store the table
-        doc_.tables_.push_back(std::move(tbl));
+        doc_.insert_node(doc_.tables_, std::move(tbl));
 
         // Attach table to owning category
-        category_id cat_id = stack_.back();
-
-        auto it = doc_.find_node_by_id(doc_.categories_, cat_id);
-        assert (it != doc_.categories_.end());
-        it->tables.push_back(tid);
+        active_category().tables.push_back(tid);
         insert_source_item(tid);
 
-        active_table_ = tid;
+        active_table_      = tid;
+        active_table_slot_ = doc_.tables_.size() - 1;
     }
 
 
@@ -904,12 +1033,12 @@ namespace
 
         auto rid = std::get<row_id>(ev.target);
         const auto& cst_row = cst_.rows[rid.val];
+        auto cst_cells      = cst_.row_cells(cst_row);
 
-        auto it = doc_.find_node_by_id(doc_.tables_, *active_table_);
-        assert(it != doc_.tables_.end());
-        auto & tbl = *it;
+        auto & tbl = active_table();
+        assert (tbl.id == *active_table_);
 
-        if (cst_row.cells.size() != tbl.columns.size())
+        if (cst_cells.size() != tbl.columns.size())
         {
             out_.errors.push_back({
                 semantic_error_kind::column_arity_mismatch,
@@ -923,34 +1052,24 @@ namespace
         row.id                 = rid;
         row.table              = tbl.id;
         row.creation           = creation_state::authored;
-        row.owner              = stack_.back();
+        row.owner              = stack_.back().id;
         row.semantic           = semantic_state::valid;
         row.contamination      = contamination_state::clean;        
         row.source_event_index = parse_idx;
         row.cells.reserve(tbl.columns.size());
 
         // Column invalidity contaminates the row
-        for (auto const& col_id : tbl.columns)
-        {
-            auto it = doc_.find_node_by_id(doc_.columns_, col_id);
-            assert (it != doc_.columns_.end());
-            if (it->col.semantic == semantic_state::invalid)
-            {
-                row.contamination = contamination_state::contaminated;
-                break;
-            }
-        }
+        if (active_columns_invalid_)
+            row.contamination = contamination_state::contaminated;
 
         for (size_t i = 0; i < tbl.columns.size(); ++i)
         {
-            auto it = doc_.find_node_by_id(doc_.columns_, tbl.columns[i]);
-            assert (it != doc_.columns_.end());
-            auto & col = it->col;
+            auto & col = doc_.columns_[active_column_slots_[i]].col;
 
-            std::string literal =
-                (i < cst_row.cells.size())
-                    ? cst_row.cells[i].value_to_string()//std::string_view(cst_row.cells[i].source_literal.value())
-                    : "";
+            std::string_view literal =
+                (i < cst_cells.size())
+                    ? cst_cells[i]
+                    : std::string_view{};
 
             typed_value tv;
             tv.origin = value_locus::table_cell;
@@ -985,7 +1104,7 @@ namespace
             }
         }
 
-        doc_.rows_.push_back(std::move(row));
+        doc_.insert_node(doc_.rows_, std::move(row));
         tbl.rows.push_back(rid);
         insert_source_item(rid);
     }
@@ -997,9 +1116,9 @@ namespace
 
         document::key_node k;
         k.id    = kid;
-        k.name  = cst.name;
+        k.name  = doc_.symbols_.intern(cst.name);
         k.creation = creation_state::authored;
-        k.owner = stack_.back(); 
+        k.owner = stack_.back().id;
         k.source_event_index = parse_idx;
 
         k.type_source = cst.declared_type
@@ -1075,45 +1194,19 @@ namespace
         k.type  = tv.type;
         k.value = std::move(tv);
 
-        key_id id{ doc_.keys_.size() };
-        doc_.keys_.emplace_back(std::move(k));
-        auto& key = doc_.keys_[id.val];
-        
-        auto it = std::ranges::find_if(doc_.categories_, [&](auto const & c){return c.id.val == key.owner.val;});
-        assert (it != doc_.categories_.end() && "Category doesn't exist");
-        auto & cat = *it;
+        auto& key = doc_.insert_node(doc_.keys_, std::move(k));
+        key_id id = key.id;
 
-        cat.keys.emplace_back(id);
+        active_category().keys.emplace_back(id);
         insert_source_item(id);
     }
 
-    document::table_node * materialiser::find_table(table_id tid)
-    {
-        for (auto & t : doc_.tables_)
-            if (t.id == tid)
-                return &t;
-        return nullptr;
-    }
-    document::category_node * materialiser::find_category(category_id cid)
-    {
-        for (auto & c : doc_.categories_)
-            if (c.id == cid)
-                return &c;
-        return nullptr;
-    }
-
     void materialiser::insert_source_item(document::source_id id)  // Takes the variant directly
     {
         if (active_table_)
-        {
-            if (auto ptr = find_table(*active_table_))
-                ptr->ordered_items.push_back(document::source_item_ref{id});
-        }
+            active_table().ordered_items.push_back(document::source_item_ref{id});
         else
-        {
-            if (auto ptr = find_category(stack_.back()))
-                ptr->ordered_items.push_back(document::source_item_ref{id});
-        }
+            active_category().ordered_items.push_back(document::source_item_ref{id});
     }
 
     inline void materialiser::handle_comment(const parse_event& ev, size_t parse_idx)
@@ -1123,11 +1216,11 @@ namespace
         document::comment_node cn;
         cn.id       = cid;
         cn.text     = ev.text;
-        cn.owner    = stack_.back();
+        cn.owner    = stack_.back().id;
         cn.creation = creation_state::authored;
         cn.source_event_index = parse_idx;
         
-        doc_.comments_.push_back(std::move(cn));
+        doc_.insert_node(doc_.comments_, std::move(cn));
         
         if (opts_.echo_lines)
             DBG_EMIT << "Created comment_id{" << cid.val << "} with text: \"" << ev.text << "\"\n";
@@ -1142,11 +1235,11 @@ namespace
         document::paragraph_node pn;
         pn.id       = pid;
         pn.text     = ev.text;
-        pn.owner    = stack_.back();
+        pn.owner    = stack_.back().id;
         pn.creation = creation_state::authored;
         pn.source_event_index = parse_idx;
         
-        doc_.paragraphs_.push_back(std::move(pn));
+        doc_.insert_node(doc_.paragraphs_, std::move(pn));
         
         if (opts_.echo_lines)
             DBG_EMIT << "Created paragraph_id{" << pid.val << "} with text: \"" << ev.text << "\"\n";
@@ -7,10 +7,47 @@
 #define NUNO_PARSER_HPP
 
 #include "nuno_core.hpp"
+#include "nuno_scanner.hpp"
 #include <assert.h>
+#include <cctype>
 #include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <list>
+#include <memory>
+#include <span>
 #include <sstream>
 #include <iostream>
+#include <thread>
+
+// Used only by detail::file_mapping. On Windows the lean/no-minmax
+// switches are set only for this include and withdrawn afterwards, so
+// includers see the same <windows.h> they would have without us.
+#if defined(_WIN32)
+    #if !defined(WIN32_LEAN_AND_MEAN)
+        #define WIN32_LEAN_AND_MEAN
+        #define NUNO_UNDEF_WIN32_LEAN_AND_MEAN__
+    #endif
+    #if !defined(NOMINMAX)
+        #define NOMINMAX
+        #define NUNO_UNDEF_NOMINMAX__
+    #endif
+    #include <windows.h>
+    #if defined(NUNO_UNDEF_WIN32_LEAN_AND_MEAN__)
+        #undef WIN32_LEAN_AND_MEAN
+        #undef NUNO_UNDEF_WIN32_LEAN_AND_MEAN__
+    #endif
+    #if defined(NUNO_UNDEF_NOMINMAX__)
+        #undef NOMINMAX
+        #undef NUNO_UNDEF_NOMINMAX__
+    #endif
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
 
 namespace nuno 
 {
@@ -67,9 +104,231 @@ namespace nuno
     {
         parse_event_kind   kind;
         source_location    loc;
-        std::string        text;        
+        std::string_view   text;   // View into the source buffer
         parse_event_target target; // Optional semantic attachment
     };
+
+//========================================================================
+// File mapping
+// ---------------------------
+// A read-only memory mapping of a whole file. Mapping (rather than
+// reading) lets the parser work directly on the page cache, so a
+// loaded file is never held in memory twice.
+//========================================================================
+
+    namespace detail
+    {
+        class file_mapping
+        {
+        public:
+            ~file_mapping() { unmap(); }
+
+            file_mapping(file_mapping const &) = delete;
+            file_mapping & operator=(file_mapping const &) = delete;
+
+            // Returns nullptr if the file could not be opened or mapped
+            static std::unique_ptr<file_mapping> open(std::filesystem::path const & path);
+
+            std::string_view text() const noexcept { return {data_, size_}; }
+
+        private:
+            file_mapping() = default;
+            void unmap() noexcept;
+
+            const char * data_ {nullptr};
+            size_t       size_ {0};
+        #if defined(_WIN32)
+            HANDLE       mapping_ {nullptr};
+        #endif
+        };
+
+    #if defined(_WIN32)
+
+        inline std::unique_ptr<file_mapping> file_mapping::open(std::filesystem::path const & path)
+        {
+            HANDLE file = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                        OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+            if (file == INVALID_HANDLE_VALUE)
+                return nullptr;
+
+            std::unique_ptr<file_mapping> fm(new file_mapping);
+
+            LARGE_INTEGER size;
+            if (!::GetFileSizeEx(file, &size))
+            {
+                ::CloseHandle(file);
+                return nullptr;
+            }
+
+            // Empty files cannot be mapped, but are valid sources
+            if (size.QuadPart > 0)
+            {
+                fm->mapping_ = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+                if (fm->mapping_)
+                    fm->data_ = static_cast<const char *>(::MapViewOfFile(fm->mapping_, FILE_MAP_READ, 0, 0, 0));
+
+                if (!fm->data_)
+                {
+                    ::CloseHandle(file);
+                    return nullptr;
+                }
+                fm->size_ = static_cast<size_t>(size.QuadPart);
+            }
+
+            // The mapping keeps its own reference to the file
+            ::CloseHandle(file);
+            return fm;
+        }
+
+        inline void file_mapping::unmap() noexcept
+        {
+            if (data_)    ::UnmapViewOfFile(data_);
+            if (mapping_) ::CloseHandle(mapping_);
+            data_    = nullptr;
+            mapping_ = nullptr;
+            size_    = 0;
+        }
+
+    #else
+
+        inline std::unique_ptr<file_mapping> file_mapping::open(std::filesystem::path const & path)
+        {
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0)
+                return nullptr;
+
+            struct stat st;
+            if (::fstat(fd, &st) != 0 || !S_ISREG(st.st_mode))
+            {
+                ::close(fd);
+                return nullptr;
+            }
+
+            std::unique_ptr<file_mapping> fm(new file_mapping);
+
+            // Empty files cannot be mapped, but are valid sources
+            if (st.st_size > 0)
+            {
+                void * addr = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (addr == MAP_FAILED)
+                {
+                    ::close(fd);
+                    return nullptr;
+                }
+
+                // The parser reads front to back exactly once
+                ::madvise(addr, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+
+                fm->data_ = static_cast<const char *>(addr);
+                fm->size_ = static_cast<size_t>(st.st_size);
+            }
+
+            // The mapping keeps its own reference to the file
+            ::close(fd);
+            return fm;
+        }
+
+        inline void file_mapping::unmap() noexcept
+        {
+            if (data_)
+                ::munmap(const_cast<char *>(data_), size_);
+            data_ = nullptr;
+            size_ = 0;
+        }
+
+    #endif
+    }
+
+//========================================================================
+// Source buffer
+// ---------------------------
+// The CST does not copy source text. Event texts, key parts and row
+// cells are views into a single source buffer which is shared by the
+// CST and any document materialised from it. The buffer either owns
+// a copy of the input, owns a read-only mapping of a source file, or
+// borrows the caller's memory, in which case the caller must keep the
+// input alive for as long as the CST or the document exist.
+//
+// Text that does not occur verbatim in the input (lower-cased names,
+// blobs joined across CRLF line endings, rewritten lines) is
+// synthesised into stable storage owned by the buffer.
+//========================================================================
+
+    struct source_buffer
+    {
+        std::string            owned;       // The input copy, unless borrowed or mapped
+        std::string_view       text;        // The complete source text, unless streamed
+        std::list<std::string> chunks;      // Streamed input, as blocks of whole lines
+        std::list<std::string> synthesized; // Node-based, so views stay valid
+
+        std::unique_ptr<detail::file_mapping> mapping;
+
+        source_buffer() = default;
+        source_buffer(source_buffer const &) = delete;
+        source_buffer & operator=(source_buffer const &) = delete;
+
+        static std::shared_ptr<source_buffer> own(std::string input)
+        {
+            auto buf   = std::make_shared<source_buffer>();
+            buf->owned = std::move(input);
+            buf->text  = buf->owned;
+            return buf;
+        }
+
+        static std::shared_ptr<source_buffer> borrow(std::string_view input)
+        {
+            auto buf  = std::make_shared<source_buffer>();
+            buf->text = input;
+            return buf;
+        }
+
+        // Maps the file if possible, otherwise reads it into an owned
+        // copy. Returns nullptr if the file can't be read at all.
+        static std::shared_ptr<source_buffer> open(std::filesystem::path const & path)
+        {
+            if (auto fm = detail::file_mapping::open(path))
+            {
+                auto buf     = std::make_shared<source_buffer>();
+                buf->text    = fm->text();
+                buf->mapping = std::move(fm);
+                return buf;
+            }
+
+            std::ifstream in(path, std::ios::binary);
+            if (!in)
+                return nullptr;
+
+            std::ostringstream ss;
+            ss << in.rdbuf();
+            if (in.bad())
+                return nullptr;
+
+            return own(std::move(ss).str());
+        }
+
+        std::string_view store(std::string s)
+        {
+            return synthesized.emplace_back(std::move(s));
+        }
+
+        static bool region_contains(std::string_view region, std::string_view sv) noexcept
+        {
+            return !region.empty()
+                && std::less_equal<>{}(region.data(), sv.data())
+                && std::less_equal<>{}(sv.data() + sv.size(), region.data() + region.size());
+        }
+
+        // Whether sv refers to input text (rather than synthesised text)
+        bool contains(std::string_view sv) const noexcept
+        {
+            if (region_contains(text, sv))
+                return true;
+            for (auto const & chunk : chunks)
+                if (region_contains(chunk, sv))
+                    return true;
+            return false;
+        }
+    };
     
 //========================================================================
 // PARSER API
@@ -78,12 +337,20 @@ namespace nuno
     struct cst_key
     {
         category_id owner;
-        std::string name;
-        std::optional<std::string> declared_type; // raw text after ':'
-        std::string literal;                      // RHS verbatim
+        std::string_view name;
+        std::optional<std::string_view> declared_type; // raw text after ':'
+        std::string_view literal;                      // RHS verbatim
         source_location loc;
     };
 
+    struct cst_row
+    {
+        row_id      id;
+        category_id owning_category;
+        size_t      first_cell {0};  // Offset into cst_document::cells
+        size_t      cell_count {0};
+    };
+
     struct cst_document
     {
         // Primary spine
@@ -92,13 +359,25 @@ namespace nuno
         // Entities
         std::vector<category>    categories;
         std::vector<table>       tables;
-        std::vector<table_row>   rows;
+        std::vector<cst_row>     rows;
         std::vector<cst_key>     keys;
+
+        // Cell literals of all rows, stored contiguously
+        std::vector<std::string_view> cells;
+
+        // The text all views in the CST refer to
+        std::shared_ptr<source_buffer> source;
+
+        std::span<const std::string_view> row_cells(cst_row const & row) const
+        {
+            return std::span<const std::string_view>(cells).subspan(row.first_cell, row.cell_count);
+        }
     };
 
     enum struct parse_error_kind
     {
         nothing,
+        file_unreadable,
     };
 
     using parse_context = context<cst_document, parse_error_kind>;
@@ -106,24 +385,143 @@ namespace nuno
     struct parser_options
     {
         bool echo_lines {false};
+
+        // Parse directly from the caller's memory without copying. The
+        // input must then outlive the CST and any document built from it.
+        bool borrow_source {false};
     };
 
     parse_context parse(const std::string& input, parser_options = {});
+    parse_context parse(std::string&& input, parser_options = {});
     parse_context parse(const std::string_view input, parser_options = {});
+
+    // Parses a file through a read-only mapping that the CST keeps alive.
+    // parser_options::borrow_source is ignored.
+    parse_context parse_file(const std::filesystem::path& path, parser_options = {});
+
+//========================================================================
+// Event handler parsing
+// ---------------------------
+// Reports the grammar to a handler as it is recognised, without
+// building a CST. Nothing is stored: all arguments are views that are
+// valid only for the duration of the call, and names are lower-cased
+// as in the CST. Memory use is independent of the input size, which
+// makes this the scan path for very large sources.
+//
+// A top-level category implicitly closes any open categories; no
+// close is reported for them. An anonymous close ("/") is reported
+// with an empty name. Rows are normalised to the header arity.
+//========================================================================
+
+    struct column_header
+    {
+        std::string_view name;
+        std::optional<std::string_view> declared_type;
+    };
+
+    struct parse_handler
+    {
+        virtual ~parse_handler() = default;
+
+        virtual void on_comment(std::string_view /*text*/) {}
+        virtual void on_paragraph(std::string_view /*text*/) {}
+
+        virtual void on_category_open(std::string_view /*name*/) {}
+        virtual void on_category_close(std::string_view /*name*/) {}
+
+        virtual void on_key(std::string_view /*name*/, 
+                            std::optional<std::string_view> /*declared_type*/, 
+                            std::string_view /*literal*/) {}
+
+        virtual void on_table_header(std::span<const column_header> /*columns*/) {}
+        virtual void on_row(std::span<const std::string_view> /*cells*/) {}
+    };
+
+    using parse_errors = std::vector<error<parse_error_kind>>;
+
+    // The input is always borrowed
+    parse_errors parse(const std::string_view input, parse_handler& handler, parser_options = {});
+    parse_errors parse_file(const std::filesystem::path& path, parse_handler& handler, parser_options = {});
+
+//========================================================================
+// Parallel parsing
+// ---------------------------
+// A top-level category line ("name:") returns the parser to the root
+// whatever came before it, so the source can be cut at such lines and
+// the pieces parsed independently. Each piece is parsed on its own
+// thread into a partial CST, and the partial CSTs are then stitched
+// together with their IDs and line numbers rebased. The result is
+// identical to parse().
+//
+// A source without top-level categories (or smaller than two chunks)
+// is parsed serially.
+//========================================================================
+
+    struct parallel_options
+    {
+        unsigned threads {0};                // 0: hardware concurrency
+        size_t   min_chunk_bytes {1u << 20}; // Smallest piece worth a thread
+    };
+
+    parse_context parallel_parse(const std::string_view input, parser_options = {}, parallel_options = {});
+
+//========================================================================
+// Streaming parser
+// ---------------------------
+// Accepts the source in arbitrary chunks, e.g. as it arrives from a
+// pipe or a decompressor, and parses every complete line as soon as it
+// has been fed. Only a partial trailing line is held back between
+// calls; the category stack, open table and pending comment/paragraph
+// blobs carry over. The result is identical to parse() on the
+// concatenated input.
+//
+// The CST refers to the fed text, which is retained (in blocks of
+// whole lines) by the source buffer.
+//========================================================================
+
+    class stream_parser
+    {
+    public:
+        explicit stream_parser(parser_options opt = {});
+        ~stream_parser();
+
+        stream_parser(stream_parser &&) noexcept;
+        stream_parser & operator=(stream_parser &&) noexcept;
+
+        void feed(std::span<const char> chunk);
+
+        // Parses any trailing unterminated line and returns the CST.
+        // The parser must not be fed after finishing.
+        parse_context finish();
+
+    private:
+        struct state;
+        std::unique_ptr<state> state_;
+    };
     
 //========================================================================
 // Implementation details
 //========================================================================
     
-    namespace
+    namespace detail
     {
-        using namespace detail;
-
         struct parser_impl
         {
             parse_context ctx;
             parser_options opt;
 
+            // When set, the grammar is reported to the handler and no
+            // CST is built
+            parse_handler * handler {nullptr};
+
+            // Text synthesised while reporting to a handler; released
+            // once nothing pending refers to it
+            std::list<std::string> transient;
+            std::vector<column_header> header_scratch;
+            size_t active_arity {0};
+
+            std::string_view synthesise(std::string text);
+
             // Columns are stored per-table so a global counter is needed
             column_id next_column_id {0};
 
@@ -132,20 +530,43 @@ namespace nuno
             table_id active_table {invalid_id<table_tag>()};
 
             // Blobbing state for comments and paragraphs
-            std::vector<std::string> pending_comment_lines;
-            std::vector<std::string> pending_paragraph_lines;
+            std::vector<std::string_view> pending_comment_lines;
+            std::vector<std::string_view> pending_paragraph_lines;
             
             void flush_pending_comment();
             void flush_pending_paragraph();
             void flush_all_pending();
 
-            void parse(std::string_view input, parser_options opt = {});
+            // Line number of the last parsed line
+            size_t line_no {0};
+
+            void parse(std::shared_ptr<source_buffer> source, parser_options opt = {});
+
+            void begin(std::shared_ptr<source_buffer> source, parser_options opt);
+            void parse_block(std::string_view text);
+            void end();
+
             void add_error(const std::string& message);
 
             std::vector<std::string> split_lines(const std::string& input);
-            std::vector<std::string> split_table_cells(std::string_view line);
+            // Reused by split_table_cells() so that splitting a row
+            // allocates nothing once the parser has warmed up
+            std::vector<std::string_view> cell_scratch;
+
+            std::span<const std::string_view> split_table_cells(std::string_view line);
+
+            std::string_view join_lines(std::vector<std::string_view> const & lines);
+            std::string_view lower(std::string_view s);
+
+            // The block of lines being parsed; line_info offsets refer into it
+            std::string_view source_text;
+            std::vector<line_info> line_scratch;
+
+            void parse_line(line_info const & li, size_t line_no);
 
-            void parse_line(std::string_view line, size_t line_no);
+            // Whether the line would be parsed as a top-level category,
+            // which does not depend on the parser state
+            static bool is_top_level_category(std::string_view text, line_info const & li);
 
             void create_root_category();
 
@@ -153,7 +574,7 @@ namespace nuno
             void open_category(std::string_view name, parse_event& ev);
             void close_category(std::string_view, parse_event& ev);
 
-            bool key_value(parse_event& ev);
+            bool key_value(parse_event& ev, line_info const & li);
 
             void start_table(std::string_view header, parse_event& ev);
             bool table_row(std::string_view text, parse_event& ev);
@@ -161,45 +582,58 @@ namespace nuno
 
 //---------------------------------------------------------------------------        
 
-        void parser_impl::parse(std::string_view input, parser_options opt)
+        inline void parser_impl::parse(std::shared_ptr<source_buffer> source, parser_options opt)
+        {
+            begin(std::move(source), opt);
+            parse_block(ctx.document.source->text);
+            end();
+        }
+
+//---------------------------------------------------------------------------        
+
+        inline void parser_impl::begin(std::shared_ptr<source_buffer> source, parser_options opt)
         {
             this->opt = opt;
-            size_t line_no = 0;
+            ctx.document.source = std::move(source);
             create_root_category();
-            
-            size_t start = 0;
-            while (start < input.size())
+        }
+
+//---------------------------------------------------------------------------        
+
+        // Parses a run of whole lines. The text must be owned (or borrowed)
+        // by the source buffer, as the CST keeps views into it. Parser state
+        // carries over between blocks.
+        inline void parser_impl::parse_block(std::string_view text)
+        {
+            source_text = text;
+
+            // Lines are split and indexed in batches by the structural
+            // scanner (see nuno_scanner.hpp)
+            structural_scanner scanner(source_text);
+
+            while (scanner.next_batch(line_scratch))
             {
-                size_t end = input.find('\n', start);
-                
-                // Extract line (either to newline or to end of input)
-                std::string_view line = (end == std::string_view::npos) 
-                    ? input.substr(start) 
-                    : input.substr(start, end - start);
-                
-                // Trim \r for Windows line endings
-                if (!line.empty() && line.back() == '\r')
-                    line.remove_suffix(1);
+                for (auto const & li : line_scratch)
+                {
+                    if (opt.echo_lines)
+                        DBG_EMIT << "Extracted: " << source_text.substr(li.begin, li.length) << std::endl;
 
-                if (opt.echo_lines)
-                    DBG_EMIT << "Extracted: " << line << std::endl;
-                    
-                parse_line(line, ++line_no);
-                
-                // If no more newlines, we're done
-                if (end == std::string_view::npos)
-                    break;
-                    
-                start = end + 1;
+                    parse_line(li, ++line_no);
+                }
             }
-            
+        }
+
+//---------------------------------------------------------------------------        
+
+        inline void parser_impl::end()
+        {
             // Flush any pending blobs at end of document
             flush_all_pending();            
         }
 
 //---------------------------------------------------------------------------        
 
-        void parser_impl::add_error(const std::string& message)
+        inline void parser_impl::add_error(const std::string& message)
         {
             ctx.errors.push_back({
                 parse_error_kind::nothing,
@@ -210,7 +644,7 @@ namespace nuno
 
 //---------------------------------------------------------------------------        
 
-        void parser_impl::create_root_category()
+        inline void parser_impl::create_root_category()
         {
             assert (ctx.document.categories.empty() && "Root must be the first category");
 
@@ -219,13 +653,14 @@ namespace nuno
             root.name   = "__root__";
             root.parent = invalid_id<category_tag>();
 
-            ctx.document.categories.push_back(root);
+            if (!handler)
+                ctx.document.categories.push_back(root);
             category_stack.push_back(root.id);
         }
 
 //---------------------------------------------------------------------------        
 
-        std::vector<std::string> parser_impl::split_lines(const std::string& input) 
+        inline std::vector<std::string> parser_impl::split_lines(const std::string& input) 
         {
             std::vector<std::string> result;
             std::istringstream stream(input);
@@ -237,42 +672,34 @@ namespace nuno
 
 //---------------------------------------------------------------------------        
             
-        std::vector<std::string> parser_impl::split_table_cells(std::string_view line) 
+        // Cells are separated by runs of two or more spaces. Each cell is
+        // a trimmed view into the line, so no cell text is copied. The
+        // returned span refers to cell_scratch and is valid until the
+        // next call.
+        inline std::span<const std::string_view> parser_impl::split_table_cells(std::string_view line) 
         {
-            std::vector<std::string> cells;
-            std::string current;
-            int spaces = 0;
+            auto & cells = cell_scratch;
+            cells.clear();
+
+            size_t pos = 0;
             
-            for (char c : line) 
+            // Skip the separator (and any leading spaces); the cell then
+            // ends at the next double space
+            while ((pos = skip_spaces(line, pos)) < line.size())
             {
-                if (c == ' ') 
-                {
-                    ++spaces;
-                    if (spaces >= 2 && !current.empty()) 
-                    {
-                        cells.push_back(std::string(trim_sv(current)));
-
-                        if (opt.echo_lines)
-                            DBG_EMIT << "  - Split out item \"" << cells.back() << "\"" << std::endl;
-                        
-                        current.clear();
-                        spaces = 0;
-                    }
-                } 
-                else 
-                {
-                    if (spaces == 1) current += ' ';
-                    spaces = 0;
-                    current += c;
-                }
+                size_t end = find_double_space(line, pos);
+
+                cells.push_back(trim_sv(line.substr(pos, end - pos)));
+
+                if (opt.echo_lines)
+                    DBG_EMIT << "  - Split out item \"" << cells.back() << "\"" << std::endl;
+
+                pos = end;
             }
             
-            if (!current.empty())
-                cells.push_back(std::string(trim_sv(current)));
-            
             // If we only got 1 cell and it contains '=', this is likely a key-value pair
             // that shouldn't be parsed as a table row at all
-            if (cells.size() == 1 && cells[0].find('=') != std::string::npos)
+            if (cells.size() == 1 && cells[0].find('=') != std::string_view::npos)
             {
                 cells.clear(); // Return empty to signal this isn't a valid table row
             }
@@ -282,7 +709,60 @@ namespace nuno
 
 //---------------------------------------------------------------------------
 
-        void parser_impl::flush_pending_comment()
+        // Consecutive source lines separated by a bare '\n' already form a
+        // contiguous blob in the source buffer; only otherwise is a joined
+        // copy synthesised.
+        inline std::string_view parser_impl::join_lines(std::vector<std::string_view> const & lines)
+        {
+            if (lines.size() == 1)
+                return lines.front();
+
+            bool contiguous = source_buffer::region_contains(source_text, lines.front());
+            for (size_t i = 1; contiguous && i < lines.size(); ++i)
+            {
+                auto const & prev = lines[i - 1];
+                contiguous = source_buffer::region_contains(source_text, lines[i])
+                          && lines[i].data() == prev.data() + prev.size() + 1
+                          && prev.data()[prev.size()] == '\n';
+            }
+
+            if (contiguous)
+            {
+                auto const & last = lines.back();
+                return std::string_view(lines.front().data(), last.data() + last.size() - lines.front().data());
+            }
+
+            std::string blob;
+            for (size_t i = 0; i < lines.size(); ++i)
+            {
+                blob += lines[i];
+                if (i + 1 < lines.size())
+                    blob += '\n';
+            }
+            return synthesise(std::move(blob));
+        }
+
+//---------------------------------------------------------------------------
+
+        inline std::string_view parser_impl::lower(std::string_view s)
+        {
+            if (std::ranges::none_of(s, [](unsigned char c){ return std::isupper(c); }))
+                return s;
+            return synthesise(to_lower(std::string(s)));
+        }
+
+//---------------------------------------------------------------------------
+
+        inline std::string_view parser_impl::synthesise(std::string text)
+        {
+            if (handler)
+                return transient.emplace_back(std::move(text));
+            return ctx.document.source->store(std::move(text));
+        }
+
+//---------------------------------------------------------------------------
+
+        inline void parser_impl::flush_pending_comment()
         {
             if (pending_comment_lines.empty())
                 return;
@@ -292,25 +772,24 @@ namespace nuno
             ev.loc.line = 0;  // TODO: track first line number if needed
             
             // Join lines with newlines to create multi-line blob
-            std::string blob;
-            for (size_t i = 0; i < pending_comment_lines.size(); ++i)
+            ev.text = join_lines(pending_comment_lines);
+            pending_comment_lines.clear();
+
+            if (handler)
             {
-                blob += pending_comment_lines[i];
-                if (i + 1 < pending_comment_lines.size())
-                    blob += '\n';
+                handler->on_comment(ev.text);
+                return;
             }
-            ev.text = std::move(blob);
 
             if (opt.echo_lines)
                 DBG_EMIT << "Adding comment \"" << ev.text << "\" as event #" << ctx.document.events.size() << std::endl;
             
             ctx.document.events.push_back(ev);
-            pending_comment_lines.clear();
         }
 
 //---------------------------------------------------------------------------
 
-        void parser_impl::flush_pending_paragraph()
+        inline void parser_impl::flush_pending_paragraph()
         {
             if (pending_paragraph_lines.empty())
                 return;
@@ -320,26 +799,24 @@ namespace nuno
             ev.loc.line = 0;  // TODO: track first line number if needed
             
             // Join lines with newlines to create multi-line blob
-            std::string blob;
-            for (size_t i = 0; i < pending_paragraph_lines.size(); ++i)
+            ev.text = join_lines(pending_paragraph_lines);
+            pending_paragraph_lines.clear();
+
+            if (handler)
             {
-                blob += pending_paragraph_lines[i];
-                if (i + 1 < pending_paragraph_lines.size())
-                    blob += '\n';
+                handler->on_paragraph(ev.text);
+                return;
             }
-
-            ev.text = std::move(blob);
             
             if (opt.echo_lines)
                 DBG_EMIT << "Adding paragraph \"" << ev.text << "\" as event #" << ctx.document.events.size() << std::endl;
 
             ctx.document.events.push_back(ev);
-            pending_paragraph_lines.clear();
         }
 
 //---------------------------------------------------------------------------
 
-        void parser_impl::flush_all_pending()
+        inline void parser_impl::flush_all_pending()
         {
             flush_pending_comment();
             flush_pending_paragraph();
@@ -347,34 +824,40 @@ namespace nuno
 
 //---------------------------------------------------------------------------        
 
-    void parser_impl::parse_line(std::string_view line, size_t line_no)
+    // Lines are classified from their structural index; the line text is
+    // not rescanned.
+    inline void parser_impl::parse_line(line_info const & li, size_t line_no)
     {
-        std::string_view trimmed = trim_sv(line);
+        std::string_view line    = source_text.substr(li.begin, li.length);
+        std::string_view trimmed = line.substr(li.first, li.last - li.first);
 
         if (opt.echo_lines)
             DBG_EMIT << "Trimmed: " << trimmed << std::endl;
+
+        if (handler && pending_comment_lines.empty() && pending_paragraph_lines.empty())
+            transient.clear();
             
         // Empty lines become paragraphs
-        if (trimmed.empty())
+        if (li.blank())
         {
             flush_pending_comment();
         
             if (opt.echo_lines)
                 DBG_EMIT << "Pushing empty line to paragraph queue" << std::endl;
                 
-            pending_paragraph_lines.push_back(std::string(line));
+            pending_paragraph_lines.push_back(line);
             return;
         }
 
         // Comments: accumulate into blob
-        if (trimmed.starts_with("//"))
+        if (li.slashes == li.first)
         {
             flush_pending_paragraph();
         
             if (opt.echo_lines)
                 DBG_EMIT << "Pushing comment to queue" << std::endl;
 
-            pending_comment_lines.push_back(std::string(line));
+            pending_comment_lines.push_back(line);
             return;
         }
 
@@ -384,7 +867,7 @@ namespace nuno
         ev.text     = line;
 
         // Category open (subcategory)
-        if (trimmed.starts_with(":"))
+        if (li.colon == li.first)
         {
             flush_all_pending();
             open_category(trimmed.substr(1), ev);
@@ -408,7 +891,7 @@ namespace nuno
         }
 
         // Table header
-        if (trimmed.starts_with("#"))
+        if (li.hash == li.first)
         {
             flush_all_pending();
             start_table(trimmed.substr(1), ev);
@@ -416,15 +899,15 @@ namespace nuno
         }
 
         // Key/value
-        if (trimmed.find('=') != std::string_view::npos)
+        if (li.equals != npos())
         {
             flush_all_pending();
-            if (!key_value(ev))
+            if (!key_value(ev, li))
             {
                 // Malformed key - treat as paragraph
                 if (opt.echo_lines)
                     DBG_EMIT << "Pushing malformed key to paragraph queue" << std::endl;
-                pending_paragraph_lines.push_back(std::string(line));
+                pending_paragraph_lines.push_back(line);
             }
             return;
         }
@@ -438,7 +921,7 @@ namespace nuno
                 // Not a valid row - treat as paragraph
                 if (opt.echo_lines)
                     DBG_EMIT << "Pushing malformed row to paragraph queue" << std::endl;
-                pending_paragraph_lines.push_back(std::string(line));
+                pending_paragraph_lines.push_back(line);
             }
             return;
         }
@@ -447,12 +930,28 @@ namespace nuno
         flush_pending_comment();
         if (opt.echo_lines)
             DBG_EMIT << "Pushing paragraph to queue" << std::endl;
-        pending_paragraph_lines.push_back(std::string(line));
+        pending_paragraph_lines.push_back(line);
     }
 
 //---------------------------------------------------------------------------        
 
-        void parser_impl::open_top_level_category(std::string_view name, parse_event& ev)
+        // Follows the classification order of parse_line()
+        inline bool parser_impl::is_top_level_category(std::string_view text, line_info const & li)
+        {
+            if (li.blank() || li.slashes == li.first || li.colon == li.first)
+                return false;
+
+            std::string_view trimmed = text.substr(li.begin + li.first, li.last - li.first);
+
+            if (trimmed.starts_with("/") && trimmed.size() > 1)
+                return false;
+
+            return trimmed.ends_with(":");
+        }
+
+//---------------------------------------------------------------------------        
+
+        inline void parser_impl::open_top_level_category(std::string_view name, parse_event& ev)
         {
             category_stack.resize(1); // back to root
             active_table = npos();
@@ -462,8 +961,15 @@ namespace nuno
 
 //---------------------------------------------------------------------------        
 
-        void parser_impl::open_category(std::string_view name, parse_event& ev)
+        inline void parser_impl::open_category(std::string_view name, parse_event& ev)
         {        
+            if (handler)
+            {
+                category_stack.push_back(category_id{ category_stack.size() });
+                handler->on_category_open(lower(trim_sv(name)));
+                return;
+            }
+
             category cat;
             cat.id     = ctx.document.categories.size();
             cat.name   = to_lower(std::string(trim_sv(name)));
@@ -483,7 +989,7 @@ namespace nuno
 
 //---------------------------------------------------------------------------        
 
-        void parser_impl::close_category(std::string_view name, parse_event& ev)
+        inline void parser_impl::close_category(std::string_view name, parse_event& ev)
         {
             ev.kind = parse_event_kind::category_close;
 
@@ -497,7 +1003,7 @@ namespace nuno
                 if (opt.echo_lines)
                     DBG_EMIT << "Converting illegal category close to comment: " << name << std::endl;
 
-                pending_comment_lines.push_back(std::string("// ") + std::string(ev.text));
+                pending_comment_lines.push_back(synthesise(std::string("// ") + std::string(ev.text)));
                 return;
             }            
 
@@ -507,6 +1013,12 @@ namespace nuno
                 if (opt.echo_lines)
                     DBG_EMIT << "Close named category " << name << std::endl;
 
+                if (handler)
+                {
+                    handler->on_category_close(name);
+                    return;
+                }
+
                 ev.target = unresolved_name{name};
                 ctx.document.events.push_back(ev);
                 return;
@@ -520,6 +1032,12 @@ namespace nuno
 
             active_table = invalid_id<table_tag>();
 
+            if (handler)
+            {
+                handler->on_category_close({});
+                return;
+            }
+
             ev.target = closing;
 
             if (opt.echo_lines)
@@ -531,24 +1049,42 @@ namespace nuno
 
 //---------------------------------------------------------------------------        
 
-        void parser_impl::start_table(std::string_view header, parse_event& ev)
+        inline void parser_impl::start_table(std::string_view header, parse_event& ev)
         {
             if (opt.echo_lines)
                 DBG_EMIT << "Starting table" << std::endl;
 
+            if (handler)
+            {
+                header_scratch.clear();
+                for (auto c : split_table_cells(header))
+                {
+                    auto pos = c.find(':');
+                    if (pos != std::string_view::npos)
+                        header_scratch.push_back({ lower(c.substr(0, pos)), trim_sv(c.substr(pos + 1)) });
+                    else
+                        header_scratch.push_back({ lower(c), std::nullopt });
+                }
+
+                active_table = 0;
+                active_arity = header_scratch.size();
+                handler->on_table_header(header_scratch);
+                return;
+            }
+
             table tbl;
             tbl.id              = ctx.document.tables.size();
             tbl.owning_category = category_stack.back();
 
             auto cols = split_table_cells(header);
-            for (auto& c : cols)
+            for (auto c : cols)
             {
                 column col;
                 col.id = next_column_id++;
                 auto pos = c.find(':');
-                if (pos != std::string::npos)
+                if (pos != std::string_view::npos)
                 {
-                    col.name = to_lower(c.substr(0, pos));
+                    col.name = to_lower(std::string(c.substr(0, pos)));
                     col.type = value_type::unresolved;
                     col.type_source = type_ascription::declared;
                     col.declared_type = std::string(trim_sv(c.substr(pos + 1)));
@@ -558,7 +1094,7 @@ namespace nuno
                 }
                 else
                 {
-                    col.name = to_lower(c);
+                    col.name = to_lower(std::string(c));
                     col.type = value_type::unresolved;
                     col.type_source = type_ascription::tacit;
 
@@ -589,7 +1125,7 @@ namespace nuno
 
 //---------------------------------------------------------------------------        
 
-        bool parser_impl::table_row(std::string_view text, parse_event& ev)
+        inline bool parser_impl::table_row(std::string_view text, parse_event& ev)
         {
             if (opt.echo_lines)
                 DBG_EMIT << "Starting row \"" << text << "\"" << std::endl;
@@ -599,28 +1135,36 @@ namespace nuno
             if (cells.empty())
                 return false; // not a valid row
 
-            struct table_row row;
+            if (handler)
+            {
+                // Normalise in place; the span views cell_scratch
+                cell_scratch.resize(active_arity);
+                handler->on_row(cell_scratch);
+                return true;
+            }
+
+            cst_row row;
             row.id = ctx.document.rows.size();
             row.owning_category = category_stack.back();
 
             const table& tbl = ctx.document.tables.at(static_cast<size_t>(active_table));
 
+            // Rows are normalised to the header arity: missing cells are
+            // empty, surplus cells are dropped
+            row.first_cell = ctx.document.cells.size();
+            row.cell_count = tbl.columns.size();
+
             for (size_t i = 0; i < tbl.columns.size(); ++i)
             {
-                typed_value tv;
-
-                tv.type           = value_type::unresolved;
-                tv.type_source    = tbl.columns[i].type_source;
-                tv.origin         = value_locus::table_cell;
-                tv.val =
+                std::string_view cell =
                     (i < cells.size())
-                        ? std::string(cells[i])
-                        : std::string{};
+                        ? cells[i]
+                        : std::string_view{};
 
                 if (opt.echo_lines)
-                    DBG_EMIT << "  - Adding cell " << tv.value_to_string() << " of type " << detail::type_to_string(tv.type) << std::endl;
+                    DBG_EMIT << "  - Adding cell " << cell << std::endl;
 
-                row.cells.push_back(tv);
+                ctx.document.cells.push_back(cell);
             }
 
             ctx.document.rows.push_back(row);
@@ -638,15 +1182,15 @@ namespace nuno
 
 //---------------------------------------------------------------------------        
 
-        bool parser_impl::key_value(parse_event& ev)
+        inline bool parser_impl::key_value(parse_event& ev, line_info const & li)
         {
             if (opt.echo_lines)
                 DBG_EMIT << "Parsing key \"" << ev.text << "\"" << std::endl;
 
             active_table = invalid_id<table_tag>();
 
-            auto pos = ev.text.find('=');
-            if (pos == std::string::npos)
+            auto pos = li.equals;
+            if (pos == npos())
             {
                 if (opt.echo_lines)
                     DBG_EMIT << "  - Key malformed" << std::endl;
@@ -654,29 +1198,37 @@ namespace nuno
                 return false;  // Malformed
             }
 
-            std::string lhs = std::string(trim_sv(ev.text.substr(0, pos)));
-            std::string rhs = std::string(trim_sv(ev.text.substr(pos + 1)));
+            std::string_view lhs = trim_sv(ev.text.substr(0, pos));
+            std::string_view rhs = trim_sv(ev.text.substr(pos + 1));
 
-            std::string name;
-            std::optional<std::string> declared;
+            std::string_view name;
+            std::optional<std::string_view> declared;
 
-            auto type_pos = lhs.find(':');
-            if (type_pos != std::string::npos)
+            // The lhs starts at the first non-blank of the line, so the
+            // first ':' of the line is in the lhs if it precedes the '='
+            if (li.colon < pos)
             {
-                name = to_lower(lhs.substr(0, type_pos));
-                declared = std::string(trim_sv(lhs.substr(type_pos + 1)));
+                auto type_pos = li.colon - li.first;
+                name = lower(lhs.substr(0, type_pos));
+                declared = trim_sv(lhs.substr(type_pos + 1));
 
                 if (opt.echo_lines)
                     DBG_EMIT << "  - Key named \"" << name << "\" of type " << *declared << std::endl;
             }
             else
             {
-                name = to_lower(lhs);
+                name = lower(lhs);
 
                 if (opt.echo_lines)
                     DBG_EMIT << "  - Untyped key named \"" << name << "\"" << std::endl;
             }
 
+            if (handler)
+            {
+                handler->on_key(name, declared, rhs);
+                return true;
+            }
+
             cst_key key;
             key.owner         = category_stack.back();
             key.name          = name;
@@ -698,24 +1250,350 @@ namespace nuno
             return true;
         }
 
-    } // anon ns
+    } // namespace detail
 
 
 //========================================================================
 // Parser API implementation
 //========================================================================
 
-    parse_context parse(const std::string& input, parser_options opt)
+    inline parse_context parse(const std::string& input, parser_options opt)
+    {
+        return parse(std::string_view(input), opt);
+    }
+
+    inline parse_context parse(std::string&& input, parser_options opt)
     {
-        parser_impl p;
-        p.parse(input, opt);
+        detail::parser_impl p;
+        p.parse(source_buffer::own(std::move(input)), opt);
         return std::move(p.ctx);
     }
     
-    parse_context parse(const std::string_view input, parser_options opt)
+    inline parse_context parse(const std::string_view input, parser_options opt)
+    {
+        detail::parser_impl p;
+        p.parse(opt.borrow_source 
+                    ? source_buffer::borrow(input) 
+                    : source_buffer::own(std::string(input)), 
+                opt);
+        return std::move(p.ctx);
+    }
+
+    inline parse_errors parse(const std::string_view input, parse_handler& handler, parser_options opt)
+    {
+        detail::parser_impl p;
+        p.handler = &handler;
+        p.parse(source_buffer::borrow(input), opt);
+        return std::move(p.ctx.errors);
+    }
+
+    inline parse_errors parse_file(const std::filesystem::path& path, parse_handler& handler, parser_options opt)
+    {
+        auto source = source_buffer::open(path);
+        if (!source)
+        {
+            return {{
+                parse_error_kind::file_unreadable,
+                { 0 },
+                "could not read file " + path.string()
+            }};
+        }
+
+        detail::parser_impl p;
+        p.handler = &handler;
+        p.parse(std::move(source), opt);
+        return std::move(p.ctx.errors);
+    }
+
+//========================================================================
+// Parallel parser implementation
+//========================================================================
+
+    namespace detail
+    {
+        // Returns the offset of the first top-level category line at or
+        // after the line containing pos, or npos
+        inline size_t find_top_level_category(std::string_view input, size_t pos)
+        {
+            size_t start = pos == 0 ? 0 : input.rfind('\n', pos - 1);
+            start = (start == std::string_view::npos) ? 0 : start + (pos != 0);
+
+            std::string_view rest = input.substr(start);
+            structural_scanner scanner(rest);
+            std::vector<line_info> lines;
+
+            while (scanner.next_batch(lines, 256))
+                for (auto const & li : lines)
+                    if (parser_impl::is_top_level_category(rest, li))
+                        return start + li.begin;
+
+            return npos();
+        }
+
+        // Where a piece's entities go in the stitched CST. Each base is
+        // the count of the entity in all preceding pieces.
+        struct piece_bases
+        {
+            size_t category {0};  // Excluding the root of each piece
+            size_t table    {0};
+            size_t row      {0};
+            size_t key      {0};
+            size_t cell     {0};
+            size_t event    {0};
+            size_t column   {0};
+            size_t line     {0};
+        };
+
+        // Moves a partial CST into its slots of the (presized) stitched
+        // CST, rebasing its IDs. A piece's root category is the document
+        // root. Pieces write to disjoint slots and may be placed
+        // concurrently.
+        inline void place_piece(cst_document & into, cst_document & piece, piece_bases const & base, bool first)
+        {
+            auto category_of = [&](category_id id)
+            {
+                return (id.val == 0 || !id.valid()) ? id : category_id{ id.val + base.category };
+            };
+
+            auto line_of = [&](source_location loc)
+            {
+                // Line 0 marks an untracked location
+                if (loc.line != 0)
+                    loc.line += base.line;
+                return loc;
+            };
+
+            for (size_t i = first ? 0 : 1; i < piece.categories.size(); ++i)
+            {
+                auto & cat = into.categories[i + base.category] = std::move(piece.categories[i]);
+                cat.id     = category_of(cat.id);
+                cat.parent = category_of(cat.parent);
+            }
+
+            for (size_t i = 0; i < piece.tables.size(); ++i)
+            {
+                auto & tbl = into.tables[i + base.table] = std::move(piece.tables[i]);
+                tbl.id              = table_id{ tbl.id.val + base.table };
+                tbl.owning_category = category_of(tbl.owning_category);
+                for (auto & col : tbl.columns)
+                    col.id = column_id{ col.id.val + base.column };
+                for (auto & r : tbl.rows)
+                    r = row_id{ r.val + base.row };
+            }
+
+            for (size_t i = 0; i < piece.rows.size(); ++i)
+            {
+                auto & row = into.rows[i + base.row] = piece.rows[i];
+                row.id              = row_id{ row.id.val + base.row };
+                row.owning_category = category_of(row.owning_category);
+                row.first_cell     += base.cell;
+            }
+
+            for (size_t i = 0; i < piece.keys.size(); ++i)
+            {
+                auto & key = into.keys[i + base.key] = piece.keys[i];
+                key.owner = category_of(key.owner);
+                key.loc   = line_of(key.loc);
+            }
+
+            std::ranges::copy(piece.cells, into.cells.begin() + base.cell);
+
+            for (size_t i = 0; i < piece.events.size(); ++i)
+            {
+                auto & ev = into.events[i + base.event] = piece.events[i];
+                ev.loc = line_of(ev.loc);
+                std::visit([&](auto & target)
+                {
+                    using T = std::decay_t<decltype(target)>;
+                    if constexpr (std::is_same_v<T, category_id>)
+                        target = category_of(target);
+                    else if constexpr (std::is_same_v<T, table_id>)
+                        target = table_id{ target.val + base.table };
+                    else if constexpr (std::is_same_v<T, row_id>)
+                        target = row_id{ target.val + base.row };
+                    else if constexpr (std::is_same_v<T, key_id>)
+                        target = key_id{ target.val + base.key };
+                }, ev.target);
+            }
+        }
+
+        template <typename F>
+        void run_concurrently(size_t count, F && fn)
+        {
+            std::vector<std::jthread> workers;
+            workers.reserve(count);
+            for (size_t i = 0; i < count; ++i)
+                workers.emplace_back([&fn, i]{ fn(i); });
+        }
+    }
+
+    inline parse_context parallel_parse(const std::string_view input, parser_options opt, parallel_options popt)
     {
-        parser_impl p;
-        p.parse(input, opt);
+        auto source = opt.borrow_source 
+                        ? source_buffer::borrow(input) 
+                        : source_buffer::own(std::string(input));
+        std::string_view text = source->text;
+
+        unsigned threads = popt.threads ? popt.threads : std::max(1u, std::thread::hardware_concurrency());
+        size_t   pieces  = std::min<size_t>(threads, text.size() / std::max<size_t>(popt.min_chunk_bytes, 1));
+
+        // Cut at the first top-level category after each nominal boundary
+        std::vector<size_t> cuts { 0 };
+        for (size_t i = 1; i < pieces; ++i)
+        {
+            size_t nominal = text.size() / pieces * i;
+            if (nominal <= cuts.back())
+                continue;
+
+            size_t cut = detail::find_top_level_category(text, nominal);
+            if (cut == npos())
+                break;
+            if (cut > cuts.back())
+                cuts.push_back(cut);
+        }
+        cuts.push_back(text.size());
+
+        if (cuts.size() <= 2)
+        {
+            detail::parser_impl p;
+            p.parse(std::move(source), opt);
+            return std::move(p.ctx);
+        }
+
+        // Every piece has a buffer of its own for synthesised text, as
+        // the pieces are parsed concurrently
+        std::vector<detail::parser_impl> parsers(cuts.size() - 1);
+
+        detail::run_concurrently(parsers.size(), [&](size_t i)
+        {
+            auto & p = parsers[i];
+            p.begin(source_buffer::borrow(text), opt);
+            p.parse_block(text.substr(cuts[i], cuts[i + 1] - cuts[i]));
+            p.end();
+        });
+
+        std::vector<detail::piece_bases> bases(parsers.size());
+        detail::piece_bases total;
+        for (size_t i = 0; i < parsers.size(); ++i)
+        {
+            auto const & piece = parsers[i].ctx.document;
+            bases[i] = total;
+
+            total.category += piece.categories.size() - 1;
+            total.table    += piece.tables.size();
+            total.row      += piece.rows.size();
+            total.key      += piece.keys.size();
+            total.cell     += piece.cells.size();
+            total.event    += piece.events.size();
+            total.column   += parsers[i].next_column_id;
+            total.line     += parsers[i].line_no;
+        }
+
+        parse_context ctx;
+        auto & doc = ctx.document;
+        doc.source = std::move(source);
+        doc.categories.resize(total.category + 1);
+        doc.tables.resize(total.table);
+        doc.rows.resize(total.row);
+        doc.keys.resize(total.key);
+        doc.cells.resize(total.cell);
+        doc.events.resize(total.event);
+
+        detail::run_concurrently(parsers.size(), [&](size_t i)
+        {
+            detail::place_piece(doc, parsers[i].ctx.document, bases[i], i == 0);
+        });
+
+        for (auto & p : parsers)
+        {
+            // Moving synthesised text between lists does not relocate it
+            doc.source->synthesized.splice(doc.source->synthesized.end(), p.ctx.document.source->synthesized);
+            ctx.errors.insert(ctx.errors.end(), p.ctx.errors.begin(), p.ctx.errors.end());
+        }
+
+        return ctx;
+    }
+
+//========================================================================
+// Streaming parser implementation
+//========================================================================
+
+    struct stream_parser::state
+    {
+        detail::parser_impl impl;
+        std::string carry;  // Partial line awaiting its line break
+    };
+
+    inline stream_parser::stream_parser(parser_options opt)
+        : state_(std::make_unique<state>())
+    {
+        auto source = std::make_shared<source_buffer>();
+        state_->impl.begin(std::move(source), opt);
+    }
+
+    inline stream_parser::~stream_parser() = default;
+    inline stream_parser::stream_parser(stream_parser &&) noexcept = default;
+    inline stream_parser & stream_parser::operator=(stream_parser &&) noexcept = default;
+
+    inline void stream_parser::feed(std::span<const char> chunk)
+    {
+        assert (state_ && "stream_parser fed after finish()");
+
+        std::string_view data(chunk.data(), chunk.size());
+
+        size_t last_break = data.rfind('\n');
+        if (last_break == std::string_view::npos)
+        {
+            state_->carry += data;
+            return;
+        }
+
+        // Retain the whole lines as one block and parse them right away
+        auto & source = *state_->impl.ctx.document.source;
+        auto & block  = source.chunks.emplace_back(std::move(state_->carry));
+        block.append(data.substr(0, last_break + 1));
+
+        state_->carry = std::string(data.substr(last_break + 1));
+        state_->impl.parse_block(block);
+    }
+
+    inline parse_context stream_parser::finish()
+    {
+        assert (state_ && "stream_parser finished twice");
+
+        auto & impl = state_->impl;
+
+        if (!state_->carry.empty())
+        {
+            auto & block = impl.ctx.document.source->chunks.emplace_back(std::move(state_->carry));
+            impl.parse_block(block);
+        }
+
+        impl.end();
+
+        parse_context ctx = std::move(impl.ctx);
+        state_.reset();
+        return ctx;
+    }
+
+//---------------------------------------------------------------------------
+
+    inline parse_context parse_file(const std::filesystem::path& path, parser_options opt)
+    {
+        auto source = source_buffer::open(path);
+        if (!source)
+        {
+            parse_context ctx;
+            ctx.errors.push_back({
+                parse_error_kind::file_unreadable,
+                { 0 },
+                "could not read file " + path.string()
+            });
+            return ctx;
+        }
+
+        detail::parser_impl p;
+        p.parse(std::move(source), opt);
         return std::move(p.ctx);
     }
         
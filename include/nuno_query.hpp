@@ -22,6 +22,7 @@
 
 #include <charconv>
 #include <concepts>
+#include <memory>
 #include <optional>
 #include <span>
 #include <string_view>
@@ -148,6 +149,7 @@ namespace nuno
         reflect::address           addr;
         location_kind              kind;
         const typed_value*         value_ptr { nullptr };
+        std::shared_ptr<const typed_value> decoded {};  // owns value_ptr if it is a decoded columnar cell
     };
 
 // =====================================================================
@@ -652,6 +654,34 @@ namespace nuno
                 filter_by_name = true;
             }
 
+            // Rows of a table are matched through its row name index
+            if (auto tbl = std::get_if<document::table_view>(&insp.item); tbl && filter_by_name)
+            {
+                // The ordinals ascend, so one walk of the rows finds them all
+                auto rows = tbl->rows();
+                auto row  = rows.begin();
+                size_t at = 0;
+
+                for (size_t i : tbl->row_indices(row_name))
+                {
+                    std::ranges::advance(row, static_cast<std::ptrdiff_t>(i - at));
+                    at = i;
+
+                    reflect::structural_child child{
+                        reflect::structural_child::kind::row,
+                        {},
+                        static_cast<size_t>(*row)
+                    };
+
+                    out.push_back({
+                        insp.extend_address(child),
+                        location_kind::row_scope,
+                        nullptr
+                    });
+                }
+                return out;
+            }
+
             for (auto const& child : insp.structural_children(ctx))
             {
                 if (child.kind != reflect::structural_child::kind::row)
@@ -714,7 +744,8 @@ namespace nuno
                     out.push_back({
                         child_addr,
                         location_kind::terminal_value,
-                        child_insp.value
+                        child_insp.value,
+                        child_insp.decoded
                     });
                 }
             }
@@ -953,7 +984,8 @@ namespace nuno
                     out.push_back({
                         child_addr,
                         location_kind::terminal_value,
-                        child_insp.value
+                        child_insp.value,
+                        child_insp.decoded
                     });
                 }
             }
@@ -1699,7 +1731,8 @@ namespace nuno
                         next.push_back({
                             child_addr,
                             location_kind::terminal_value,
-                            child_insp.value
+                            child_insp.value,
+                            child_insp.decoded
                         });
                     }
                 }
@@ -1768,7 +1801,8 @@ namespace nuno
                         next.push_back({
                             child_addr,
                             location_kind::terminal_value,
-                            child_insp.value
+                            child_insp.value,
+                            child_insp.decoded
                         });
                     }
                 }
@@ -1853,7 +1887,8 @@ namespace nuno
                         next.push_back({
                             child_addr,
                             location_kind::terminal_value,
-                            child_insp.value
+                            child_insp.value,
+                            child_insp.decoded
                         });
                     }
                 }
@@ -1998,6 +2033,51 @@ namespace nuno
 
     // Main filter:
     // -----------------------------------------------
+        // Columnar tables are matched a column at a time: packed cells are
+        // read from the packed arrays into one scratch cell, and only the
+        // exception cells are visited row by row
+        struct column_scan
+        {
+            const column_store*  store;
+            size_t               column;
+            detail::dense_bitset matched;
+        };
+        std::vector<column_scan> scans;
+
+        auto scan = [&](const column_store& store, size_t column) -> const detail::dense_bitset&
+        {
+            for (auto& s : scans)
+                if (s.store == &store && s.column == column)
+                    return s.matched;
+
+            auto& col = store.columns[column];
+            auto& matched = scans.emplace_back(column_scan{ &store, column, {} }).matched;
+            matched.resize(col.size());
+
+            typed_value cell = col.prototype();
+            cell.semantic = semantic_state::valid;
+            if (cell.type == value_type::unresolved)
+                return matched;
+
+            col.for_each_packed([&](size_t r, auto v)
+            {
+                if (col.is_invalid(r))
+                    return;
+
+                if constexpr (std::is_same_v<decltype(v), std::string_view>)
+                {
+                    if (auto* str = std::get_if<std::string>(&cell.val)) str->assign(v);
+                    else                                                 cell.val = std::string(v);
+                }
+                else
+                    cell.val = v;
+
+                if (evaluate_predicate(cell, pred))
+                    matched.set(r);
+            });
+            return matched;
+        };
+
         for (const auto& loc : locations_)
         {
             if (loc.kind != location_kind::row_scope)
@@ -2013,22 +2093,31 @@ namespace nuno
             if (!row_view)
                 continue;
 
-            auto idx = details::resolve_column_index(row_view->table(), pred.column);
+            auto table = row_view->table();
+            auto idx = details::resolve_column_index(table, pred.column);
             if (!idx)
             {
                 report_issue(query_issue_kind::invalid_index, "where()");
                 continue;
             }
 
-            const auto & cells = row_view->node->cells;
-            if (*idx >= cells.size())
-                continue;
-            
-            const typed_value & cell = cells.at(*idx);
-            if (cell.type == value_type::unresolved)
-                continue;
+            bool matched = false;
+            auto store = table.column_storage();
+            auto slot  = row_view->storage_index();
 
-            if (evaluate_predicate(cell, pred))
+            if (store && *idx < store->columns.size() && store->columns[*idx].is_packed(slot))
+            {
+                matched = scan(*store, *idx).test(slot);
+            }
+            else
+            {
+                row_view->visit_cell(*idx, [&](const typed_value & cell)
+                {
+                    matched = cell.type != value_type::unresolved && evaluate_predicate(cell, pred);
+                });
+            }
+
+            if (matched)
                 next.push_back(loc);
         }
 
@@ -2084,13 +2173,20 @@ namespace nuno
                     continue;
                 }
 
-                const auto& cells = row_view->node->cells;
-                if (*idx >= cells.size())
-                    continue;
-
-                const typed_value& cell = cells[*idx];
+                // A cell of a columnar row is decoded into storage the
+                // location owns
+                std::shared_ptr<const typed_value> decoded;
+                const typed_value* cell = nullptr;
+                if (row_view->table().column_storage())
+                    row_view->visit_cell(*idx, [&](const typed_value& c)
+                    {
+                        decoded = std::make_shared<const typed_value>(c);
+                        cell = decoded.get();
+                    });
+                else if (const auto cells = row_view->cells(); *idx < cells.size())
+                    cell = &cells[*idx];
 
-                if (cell.type == value_type::unresolved)
+                if (!cell || cell->type == value_type::unresolved)
                     continue;
 
                 auto child = reflect::structural_child{
@@ -2102,7 +2198,8 @@ namespace nuno
                 next.push_back({
                     insp.extend_address(child),
                     location_kind::terminal_value,
-                    &cell
+                    cell,
+                    std::move(decoded)
                 });
             }
         }
@@ -2194,7 +2291,7 @@ namespace nuno
             [&](int64_t i) { out = (i != 0); return true; },
             [&](const std::string& s) 
             {
-                auto sv = trim_sv(s);
+                auto sv = detail::trim_sv(s);
                 if (sv == "true" || sv == "1") { out = true; return true; }
                 if (sv == "false" || sv == "0") { out = false; return true; }
                 return false;
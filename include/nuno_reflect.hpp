@@ -14,6 +14,7 @@
 #include "nuno_document.hpp"
 
 #include <array>
+#include <memory>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -312,6 +313,7 @@ namespace nuno::reflect
         std::optional<document::column_view>    column;
         std::optional<document::key_view>       key;
         const typed_value*                      value = nullptr;
+        std::shared_ptr<const typed_value>      decoded = nullptr;  // the cell of a columnar row value points to
     };    
 
 // ------------------------------------------------------------
@@ -388,6 +390,7 @@ namespace nuno::reflect
         std::optional<address> addr;
         inspected_item     item;
         const typed_value* value;
+        std::shared_ptr<const typed_value> decoded; // keeps a decoded columnar cell alive for value
         size_t             steps_inspected;
 
         bool fully_inspected() const { return addr && steps_inspected == addr->steps.size(); }
@@ -501,6 +504,7 @@ namespace nuno::reflect
         ctx.column.reset();
         ctx.key.reset();
         ctx.value = nullptr;
+        ctx.decoded.reset();
 
         inspected out;
         out.item = *ctx.category;
@@ -650,15 +654,7 @@ namespace nuno::reflect
                         error(step_error::row_not_found);
                     else
                     {
-                        bool owned = false;
-                        for (auto rid : ctx.table->rows())
-                        {
-                            if (rid == s->id)
-                            {
-                                owned = true;
-                                break;
-                            }
-                        }
+                        bool owned = ctx.table->row_index(s->id).has_value();
 
                         if (!owned)
                             error( step_error::row_not_owned);
@@ -697,7 +693,18 @@ namespace nuno::reflect
                     else
                     {
                         ctx.column = col;
-                        ctx.value = &ctx.row->cells()[col->index()];
+                        if (ctx.row->table().column_storage())
+                        {
+                            // A columnar cell is decoded into storage of its own
+                            ctx.decoded.reset();
+                            ctx.row->visit_cell(col->index(), [&ctx](typed_value const& cell)
+                            {
+                                ctx.decoded = std::make_shared<const typed_value>(cell);
+                            });
+                            ctx.value = ctx.decoded.get();
+                        }
+                        else
+                            ctx.value = &ctx.row->cells()[col->index()];
                     }
                 }
             }
@@ -771,6 +778,7 @@ namespace nuno::reflect
 
         out.item = last_valid_item;
         out.addr = addr;
+        out.decoded = ctx.decoded;
 
         // Extract value from item
         if (auto pv = std::get_if<const typed_value*>(&out.item))
@@ -821,7 +829,7 @@ namespace nuno::reflect
             // Special case: root category lists top-level categories
             if (node.is_root())
             {
-                for (const auto& cat : ctx.doc->categories())
+                for (const auto& cat : ctx.doc->categories_range())
                 {
                     if (!cat.is_root() && cat.parent()->is_root())
                     {
@@ -1031,6 +1039,8 @@ namespace nuno::reflect
 // resolve
 // ------------------------------------------------------------
 
+    // A cell of a columnar row is owned by ctx, so the value lives
+    // until ctx next inspects
     const typed_value* resolve(
         inspect_context& ctx,
         address& addr
@@ -0,0 +1,369 @@
+// nuno_scanner.hpp - A Readable Format (NUNO) - Structural line scanner
+// Version 0.3.0
+// Copyright 2025 Mikael Ueno A
+// Licenced as-is under the MIT licence.
+
+#ifndef NUNO_SCANNER_HPP
+#define NUNO_SCANNER_HPP
+
+#include "nuno_core.hpp"
+#include <bit>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define NUNO_SCANNER_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define NUNO_SCANNER_SSE2
+#endif
+
+namespace nuno::detail
+{
+//========================================================================
+// Structural scanner
+// ---------------------------
+// A single vectorised pass over the source that splits it into lines
+// and records, per line, everything the line classifier needs: the
+// trimmed extent and the first position of each structural token.
+// The parser then classifies lines from this index instead of
+// rescanning each line with trim/starts_with/find.
+//
+// The input is processed in 64 byte blocks. Each block is reduced to
+// one bitmask per character class (AVX2, SSE2 or scalar), and lines
+// are walked by scanning the newline mask. Lines are produced in
+// batches so the index stays small regardless of input size.
+//========================================================================
+
+    // Per-line structural index. All positions are relative to begin.
+    struct line_info
+    {
+        size_t begin  {0};  // Offset of the line in the input
+        size_t length {0};  // Excluding '\n' and a trailing '\r'
+        size_t first  {0};  // First non-blank character, == last if blank
+        size_t last   {0};  // One past the last non-blank character
+
+        // First occurrence of each token, or npos()
+        size_t equals  {npos()};  // '='
+        size_t colon   {npos()};  // ':'
+        size_t hash    {npos()};  // '#'
+        size_t slashes {npos()};  // "//"
+
+        bool blank() const noexcept { return first == last; }
+    };
+
+    class structural_scanner
+    {
+    public:
+        static constexpr size_t BLOCK = 64;
+        static constexpr size_t DEFAULT_BATCH = 4096;
+
+        explicit structural_scanner(std::string_view input) noexcept
+            : input_(input)
+        {
+        }
+
+        // Replaces the contents of out with the next lines of the input.
+        // Returns false once the input is exhausted.
+        bool next_batch(std::vector<line_info> & out, size_t max_lines = DEFAULT_BATCH);
+
+        bool done() const noexcept { return finished_; }
+
+    private:
+        // One bit per byte of a 64 byte block, per character class
+        struct block_masks
+        {
+            uint64_t newline {0};
+            uint64_t solid   {0};  // Anything but ' ', '\t', '\r', '\n'
+            uint64_t equals  {0};
+            uint64_t colon   {0};
+            uint64_t hash    {0};
+            uint64_t slash   {0};
+        };
+
+        static block_masks scan_block(const char * p) noexcept;
+
+        void consume_block(block_masks const & m, size_t base, std::vector<line_info> & out);
+        void finish_line(size_t end, std::vector<line_info> & out);
+        void reset_line(size_t begin) noexcept;
+
+        static uint64_t range_mask(size_t lo, size_t hi) noexcept
+        {
+            if (lo >= 64) return 0;
+            uint64_t upper = (hi >= 64) ? ~uint64_t{0} : ((uint64_t{1} << hi) - 1);
+            return upper & (~uint64_t{0} << lo);
+        }
+
+        std::string_view input_;
+        size_t pos_      {0};
+        bool   finished_ {false};
+
+        // A '/' ending the previous block may pair with one starting the next
+        uint64_t slash_carry_ {0};
+
+        // The line in progress, in absolute offsets
+        size_t line_begin_ {0};
+        size_t first_      {npos()};
+        size_t last_       {npos()};
+        size_t equals_     {npos()};
+        size_t colon_      {npos()};
+        size_t hash_       {npos()};
+        size_t slashes_    {npos()};
+    };
+
+//------------------------------------------------------------------------
+// Block classification
+//------------------------------------------------------------------------
+
+#if defined(NUNO_SCANNER_AVX2)
+
+    inline structural_scanner::block_masks structural_scanner::scan_block(const char * p) noexcept
+    {
+        const __m256i lo = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        const __m256i hi = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p + 32));
+
+        auto match = [&](char c) -> uint64_t
+        {
+            const __m256i v = _mm256_set1_epi8(c);
+            uint64_t l = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, v)));
+            uint64_t h = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, v)));
+            return l | (h << 32);
+        };
+
+        block_masks m;
+        m.newline = match('\n');
+        m.solid   = ~(m.newline | match(' ') | match('\t') | match('\r'));
+        m.equals  = match('=');
+        m.colon   = match(':');
+        m.hash    = match('#');
+        m.slash   = match('/');
+        return m;
+    }
+
+#elif defined(NUNO_SCANNER_SSE2)
+
+    inline structural_scanner::block_masks structural_scanner::scan_block(const char * p) noexcept
+    {
+        const __m128i c0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        const __m128i c1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 16));
+        const __m128i c2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 32));
+        const __m128i c3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 48));
+
+        auto match = [&](char c) -> uint64_t
+        {
+            const __m128i v = _mm_set1_epi8(c);
+            uint64_t m0 = static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(c0, v)));
+            uint64_t m1 = static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(c1, v)));
+            uint64_t m2 = static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(c2, v)));
+            uint64_t m3 = static_cast<uint16_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(c3, v)));
+            return m0 | (m1 << 16) | (m2 << 32) | (m3 << 48);
+        };
+
+        block_masks m;
+        m.newline = match('\n');
+        m.solid   = ~(m.newline | match(' ') | match('\t') | match('\r'));
+        m.equals  = match('=');
+        m.colon   = match(':');
+        m.hash    = match('#');
+        m.slash   = match('/');
+        return m;
+    }
+
+#else
+
+    inline structural_scanner::block_masks structural_scanner::scan_block(const char * p) noexcept
+    {
+        block_masks m;
+        for (size_t i = 0; i < BLOCK; ++i)
+        {
+            const uint64_t bit = uint64_t{1} << i;
+            switch (p[i])
+            {
+                case '\n': m.newline |= bit; break;
+                case ' ':
+                case '\t':
+                case '\r':                   break;
+                case '=':  m.equals  |= bit; m.solid |= bit; break;
+                case ':':  m.colon   |= bit; m.solid |= bit; break;
+                case '#':  m.hash    |= bit; m.solid |= bit; break;
+                case '/':  m.slash   |= bit; m.solid |= bit; break;
+                default:                     m.solid |= bit; break;
+            }
+        }
+        return m;
+    }
+
+#endif
+
+//------------------------------------------------------------------------
+// Line walking
+//------------------------------------------------------------------------
+
+    inline void structural_scanner::reset_line(size_t begin) noexcept
+    {
+        line_begin_ = begin;
+        first_   = npos();
+        last_    = npos();
+        equals_  = npos();
+        colon_   = npos();
+        hash_    = npos();
+        slashes_ = npos();
+    }
+
+    inline void structural_scanner::finish_line(size_t end, std::vector<line_info> & out)
+    {
+        auto rel = [this](size_t abs) { return abs == npos() ? npos() : abs - line_begin_; };
+
+        line_info li;
+        li.begin  = line_begin_;
+        li.length = end - line_begin_;
+
+        // Windows line endings
+        if (li.length > 0 && input_[end - 1] == '\r')
+            --li.length;
+
+        if (first_ == npos())
+        {
+            li.first = li.length;
+            li.last  = li.length;
+        }
+        else
+        {
+            li.first = first_ - line_begin_;
+            li.last  = last_  - line_begin_;
+        }
+
+        li.equals  = rel(equals_);
+        li.colon   = rel(colon_);
+        li.hash    = rel(hash_);
+        li.slashes = rel(slashes_);
+
+        out.push_back(li);
+    }
+
+    inline void structural_scanner::consume_block(block_masks const & m, size_t base, std::vector<line_info> & out)
+    {
+        // Mark the second character of each "//"; the pair may straddle blocks
+        const uint64_t slash_pairs = m.slash & ((m.slash << 1) | slash_carry_);
+        slash_carry_ = m.slash >> 63;
+
+        auto first_in = [base](uint64_t bits) { return base + std::countr_zero(bits); };
+
+        uint64_t newlines = m.newline;
+        size_t   seg_lo   = 0;
+
+        while (true)
+        {
+            const size_t   seg_hi = newlines ? static_cast<size_t>(std::countr_zero(newlines)) : BLOCK;
+            const uint64_t seg    = range_mask(seg_lo, seg_hi);
+
+            if (uint64_t solid = m.solid & seg)
+            {
+                if (first_ == npos())
+                    first_ = first_in(solid);
+                last_ = base + (63 - std::countl_zero(solid)) + 1;
+            }
+
+            if (equals_  == npos() && (m.equals & seg))  equals_  = first_in(m.equals & seg);
+            if (colon_   == npos() && (m.colon  & seg))  colon_   = first_in(m.colon  & seg);
+            if (hash_    == npos() && (m.hash   & seg))  hash_    = first_in(m.hash   & seg);
+            if (slashes_ == npos() && (slash_pairs & seg)) slashes_ = first_in(slash_pairs & seg) - 1;
+
+            if (!newlines)
+                break;
+
+            finish_line(base + seg_hi, out);
+            reset_line(base + seg_hi + 1);
+
+            seg_lo = seg_hi + 1;
+            newlines &= newlines - 1;
+        }
+    }
+
+    inline bool structural_scanner::next_batch(std::vector<line_info> & out, size_t max_lines)
+    {
+        out.clear();
+
+        if (finished_)
+            return false;
+
+        while (out.size() < max_lines && pos_ + BLOCK <= input_.size())
+        {
+            consume_block(scan_block(input_.data() + pos_), pos_, out);
+            pos_ += BLOCK;
+        }
+
+        if (out.size() >= max_lines)
+            return true;
+
+        // Tail: pad with blanks, which match no character class
+        if (pos_ < input_.size())
+        {
+            char tail[BLOCK];
+            std::memset(tail, ' ', BLOCK);
+            std::memcpy(tail, input_.data() + pos_, input_.size() - pos_);
+
+            consume_block(scan_block(tail), pos_, out);
+            pos_ = input_.size();
+        }
+
+        // A final line without a line break
+        if (line_begin_ < input_.size())
+            finish_line(input_.size(), out);
+
+        finished_ = true;
+        return !out.empty();
+    }
+
+//========================================================================
+// Cell separator search
+// ---------------------------
+// Table cells are separated by runs of two or more spaces. These find
+// the next separator and the next cell start within a single line, 16
+// bytes at a time. Loads never extend past the end of the view.
+//========================================================================
+
+    // Position of the first "  " at or after pos, or s.size()
+    inline size_t find_double_space(std::string_view s, size_t pos) noexcept
+    {
+    #if defined(NUNO_SCANNER_AVX2) || defined(NUNO_SCANNER_SSE2)
+        const __m128i space = _mm_set1_epi8(' ');
+        while (pos + 17 <= s.size())
+        {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s.data() + pos));
+            const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s.data() + pos + 1));
+            const unsigned m = static_cast<unsigned>(_mm_movemask_epi8(
+                _mm_and_si128(_mm_cmpeq_epi8(a, space), _mm_cmpeq_epi8(b, space))));
+            if (m)
+                return pos + std::countr_zero(m);
+            pos += 16;
+        }
+    #endif
+        for (; pos + 1 < s.size(); ++pos)
+            if (s[pos] == ' ' && s[pos + 1] == ' ')
+                return pos;
+        return s.size();
+    }
+
+    // Position of the first character other than ' ' at or after pos, or s.size()
+    inline size_t skip_spaces(std::string_view s, size_t pos) noexcept
+    {
+    #if defined(NUNO_SCANNER_AVX2) || defined(NUNO_SCANNER_SSE2)
+        const __m128i space = _mm_set1_epi8(' ');
+        while (pos + 16 <= s.size())
+        {
+            const __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i *>(s.data() + pos));
+            const unsigned m = ~static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, space))) & 0xFFFFu;
+            if (m)
+                return pos + std::countr_zero(m);
+            pos += 16;
+        }
+    #endif
+        while (pos < s.size() && s[pos] == ' ')
+            ++pos;
+        return pos;
+    }
+}
+
+#endif // NUNO_SCANNER_HPP
@@ -8,8 +8,16 @@
 
 #include "nuno_document.hpp"
 #include <charconv>
+#include <cerrno>
 #include <ostream>
 #include <cassert>
+#include <unordered_map>
+
+#if defined(_WIN32)
+    #include <io.h>
+#else
+    #include <unistd.h>
+#endif
 
 namespace nuno
 {
@@ -39,9 +47,139 @@ namespace nuno
         bool emit_comments {true};      // If false, skip comment events
         bool emit_paragraphs {true};    // If false, skip paragraph events
 
+        // Copy the document, or the categories and tables, no editor has
+        // touched from the source whole, instead of line by line, while
+        // the options above leave the source as it is. Nodes changed
+        // other than through an editor are not seen as touched; clear to
+        // replay every line.
+        bool verbatim_regions {true};
+
         bool echo_lines  {false};       // prints each node to be serialised
     };
 
+//========================================================================
+// OUTPUT_SINK
+// ---------------------------
+// Where a serializer writes. Output appends straight to a string, or
+// collects in a buffer that is flushed to a stream or file descriptor
+// when full and when the sink is destroyed. A slice larger than the
+// buffer is passed on in one write.
+//========================================================================
+
+    namespace detail
+    {
+        // The shortest text that reads back as the same value
+        template<typename T>
+        std::string_view format_number(char (&buf)[32], T v) noexcept
+        {
+            auto [end, ec] = std::to_chars(buf, buf + sizeof buf, v);
+            return {buf, ec == std::errc{} ? end : buf};
+        }
+    }
+
+    class output_sink
+    {
+    public:
+        explicit output_sink(std::string & out) noexcept : str_(&out) {}
+        explicit output_sink(std::ostream & out) : os_(&out) { buf_.reserve(capacity); }
+        explicit output_sink(int fd) : fd_(fd) { buf_.reserve(capacity); }
+
+        ~output_sink() { flush(); }
+
+        output_sink(output_sink const &) = delete;
+        output_sink & operator=(output_sink const &) = delete;
+
+        void write(std::string_view text)
+        {
+            if (str_)
+            {
+                str_->append(text);
+                return;
+            }
+
+            if (buf_.size() + text.size() > capacity)
+            {
+                flush();
+                if (text.size() >= capacity)
+                    return emit(text);
+            }
+            buf_.append(text);
+        }
+
+        void put(char c, size_t count = 1)
+        {
+            auto & out = str_ ? *str_ : buf_;
+            out.append(count, c);
+            if (!str_ && buf_.size() >= capacity)
+                flush();
+        }
+
+        void write(int64_t v) { char buf[32]; write(detail::format_number(buf, v)); }
+        void write(double v)  { char buf[32]; write(detail::format_number(buf, v)); }
+
+        output_sink & operator<<(std::string_view text) { write(text); return *this; }
+        output_sink & operator<<(symbol const & s)      { write(s.str()); return *this; }
+        output_sink & operator<<(char c)                { put(c); return *this; }
+        output_sink & operator<<(int64_t v)             { write(v); return *this; }
+        output_sink & operator<<(double v)              { write(v); return *this; }
+
+        // Passes buffered output on; false once a write has failed
+        bool flush()
+        {
+            if (!buf_.empty())
+            {
+                emit(buf_);
+                buf_.clear();
+            }
+            return good_;
+        }
+
+        bool good() const noexcept { return good_; }
+
+    private:
+        void emit(std::string_view text);
+
+        static constexpr size_t capacity = 64 * 1024;
+
+        std::string    buf_;
+        std::string  * str_ {nullptr};
+        std::ostream * os_  {nullptr};
+        int            fd_  {-1};
+        bool           good_ {true};
+    };
+
+    inline void output_sink::emit(std::string_view text)
+    {
+        if (!good_)
+            return;
+
+        if (os_)
+        {
+            os_->write(text.data(), static_cast<std::streamsize>(text.size()));
+            good_ = os_->good();
+            return;
+        }
+
+        // Short writes are resumed; interrupted ones retried
+        while (!text.empty())
+        {
+        #if defined(_WIN32)
+            auto chunk = static_cast<unsigned>(std::min<size_t>(text.size(), 1u << 30));
+            auto n = ::_write(fd_, text.data(), chunk);
+        #else
+            auto n = ::write(fd_, text.data(), text.size());
+        #endif
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+            {
+                good_ = false;
+                return;
+            }
+            text.remove_prefix(static_cast<size_t>(n));
+        }
+    }
+
 //========================================================================
 // SERIALIZER
 //========================================================================
@@ -55,27 +193,94 @@ namespace nuno
         }
 
         void write(std::ostream& out)
+        {
+            output_sink sink(out);
+            write(sink);
+        }
+
+        void write(output_sink& out)
         {
             if (opts_.echo_lines)
                 DBG_EMIT << "serializer::write\n";
 
             out_ = &out;
+            indent_cache_ = {};
+            copy_extents_ = opts_.verbatim_regions
+                         && !opts_.echo_lines
+                         && opts_.types == serializer_options::type_policy::preserve
+                         && opts_.blank_lines != serializer_options::blank_line_policy::compact
+                         && opts_.emit_comments
+                         && opts_.emit_paragraphs
+                         && doc_.source_context_;
             write_category_open(doc_.categories_.front());            
         }
 
+        // A guess at the size of the output, to reserve for it: the
+        // source of a loaded document, or a few bytes a node
+        static size_t estimate_size(const document& doc);
+
     private:
         const document&    doc_;
-        std::ostream*      out_;        
+        output_sink*       out_;        
         serializer_options opts_;
 
         static constexpr size_t STANDARD_INDENT = 4;
         static constexpr size_t TABLE_ROW_OFFSET = 2;
 
         size_t indent_ {0};  // Current category nesting depth
+        bool   copy_extents_ {false};
         size_t current_spaces_ {0};  // Actual leading spaces (physical)
+
+        // Indentation inferred once per scope in a write, so regenerating
+        // many siblings does not scan them all each time. A sibling scan
+        // holds the indent of the first authored sibling, if there is one.
+        struct indent_cache
+        {
+            std::unordered_map<size_t, std::optional<size_t>> keys;        // by owner category
+            std::unordered_map<size_t, std::optional<size_t>> tables;      // by owner category
+            std::unordered_map<size_t, std::optional<size_t>> categories;  // by parent category
+            std::unordered_map<size_t, size_t>                rows;        // by table
+        } indent_cache_;
+
+        // Columnar rows are decoded here, so their strings reuse the
+        // storage of the rows written before them
+        std::vector<typed_value> row_scratch_;
                
     private:
 
+    //----------------------------------------------------------------
+    // Source replay
+    // Event texts are views into the parser's source buffer and are
+    // written out as raw slices, without formatting.
+    //----------------------------------------------------------------
+
+        void write_slice(std::string_view text)
+        {
+            out_->write(text);
+        }
+
+        void replay(const parse_event& event)
+        {
+            write_slice(event.text);
+            out_->put('\n');
+        }
+
+        // A category or table the editor has not touched is written as
+        // its source extent, which holds exactly what replaying its lines
+        // one by one would. Options that reformat or drop lines
+        // regenerate every region instead (copy_extents_, decided once
+        // per write).
+        bool copy_extent(std::optional<document::source_extent> const & extent)
+        {
+            if (!copy_extents_ || !extent)
+                return false;
+
+            auto src = doc_.source_context_->document.source->text;
+            write_slice(src.substr(extent->begin, extent->end - extent->begin));
+            indent_ += extent->opens;
+            return true;
+        }
+
     //----------------------------------------------------------------
     // Indentation inference
     //----------------------------------------------------------------
@@ -162,8 +367,7 @@ namespace nuno
             if (!opts_.emit_comments)
                 return;
 
-            auto it = std::ranges::find_if(doc_.comments_,
-                [id](auto const& c) { return c.id == id; });
+            auto it = doc_.find_node_by_id(doc_.comments_, id);
             
             if (it == doc_.comments_.end())
             {
@@ -182,8 +386,7 @@ namespace nuno
             if (!opts_.emit_paragraphs)
                 return;
 
-            auto it = std::ranges::find_if(doc_.paragraphs_,
-                [id](auto const& p) { return p.id == id; });
+            auto it = doc_.find_node_by_id(doc_.paragraphs_, id);
             assert(it != doc_.paragraphs_.end());
 
             write_paragraph(*it);
@@ -211,7 +414,7 @@ namespace nuno
             if (can_replay)
             {
                 const auto& event = doc_.source_context_->document.events[*k.source_event_index];
-                *out_ << event.text << '\n';
+                replay(event);
                 return;
             }
 
@@ -241,10 +444,17 @@ namespace nuno
 
             if (is_root)
             {
+                // The whole of an unedited document in one write
+                if (copy_extent(cat.extent))
+                    return;
+
                 write_category_contents(cat);
                 return;
             }
 
+            if (copy_extent(cat.extent))
+                return;
+
             // Can replay source?
             bool can_replay = (cat.creation == creation_state::authored)
                             && !cat.is_edited
@@ -254,7 +464,7 @@ namespace nuno
             if (can_replay)
             {
                 const auto& event = doc_.source_context_->document.events[*cat.source_event_index_open];
-                *out_ << event.text << '\n';
+                replay(event);
                 ++indent_;
                 write_category_contents(cat);
                 return;
@@ -290,7 +500,7 @@ namespace nuno
             if (opts_.echo_lines)
             {
                 DBG_EMIT << "serializer::write_category_contents: "
-                         << (cat.id == category_id{0} ? "__root__" : cat.name) << std::endl;
+                         << (cat.id == category_id{0} ? "__root__" : std::string_view(cat.name.str())) << std::endl;
             }
 
             for (const auto& item : cat.ordered_items)
@@ -323,7 +533,7 @@ namespace nuno
             if (can_replay)
             {
                 const auto& event = doc_.source_context_->document.events[*cat.source_event_index_close];
-                *out_ << event.text << '\n';
+                replay(event);
                 return;
             }
 
@@ -344,6 +554,9 @@ namespace nuno
             if (opts_.echo_lines)
                 DBG_EMIT << "serializer::write_table\n";
 
+            if (copy_extent(tbl.extent))
+                return;
+
             bool force_reconstruct = 
                 (opts_.types != serializer_options::type_policy::preserve);
 
@@ -357,7 +570,7 @@ namespace nuno
             if (can_replay)
             {
                 const auto& event = doc_.source_context_->document.events[*tbl.source_event_index];
-                *out_ << event.text << '\n';
+                replay(event);
             }
             else
             {
@@ -386,9 +599,13 @@ namespace nuno
                 *out_ << '\n';
             }
 
-            // Emit table contents
+            // Emit table contents, skipping erased rows not yet purged
             for (const auto& item : tbl.ordered_items)
+            {
+                if (auto rid = std::get_if<row_id>(&item.id); rid && doc_.is_erased(*rid))
+                    continue;
                 write_source_item(item);
+            }
         }
 
 //----------------------------------------------------------------
@@ -409,22 +626,25 @@ namespace nuno
             if (can_replay)
             {
                 const auto& event = doc_.source_context_->document.events[*row.source_event_index];
-                *out_ << event.text;
-                
-                if (!event.text.empty() && event.text.back() != '\n')
-                    *out_ << '\n';
+                if (!event.text.empty() && event.text.back() == '\n')
+                    write_slice(event.text);
+                else
+                    replay(event);
                 
                 return;
             }
 
             // Reconstruct
             // Note: Rows inherit table indentation + fixed offset
-            current_spaces_ = infer_indent_for_table( *doc_.table(row.table)->node );            
+            auto [spaces, fresh] = indent_cache_.rows.try_emplace(row.table.val);
+            if (fresh)
+                spaces->second = infer_indent_for_table( *doc_.table(row.table)->node );
+            current_spaces_ = spaces->second;
             write_indent();
             *out_ << "  ";  // Table row base indentation
 
             bool first = true;
-            for (const auto& cell : row.cells)
+            for (const auto& cell : doc_.row_cells(row, row_scratch_))
             {
                 if (!first)
                     *out_ << "  ";
@@ -460,7 +680,7 @@ namespace nuno
                 DBG_EMIT << "serializer::write_paragraph\n";
 
             if (opts_.blank_lines == serializer_options::blank_line_policy::compact
-                && trim_sv(p.text).empty())
+                && detail::trim_sv(p.text).empty())
             {
                 return;  // Skip empty paragraphs in compact mode
             }
@@ -481,10 +701,11 @@ namespace nuno
                 
                 if constexpr (std::is_same_v<T, std::string>)
                     return val;
-                else if constexpr (std::is_same_v<T, int64_t>)
-                    return std::to_string(val);
-                else if constexpr (std::is_same_v<T, double>)
-                    return std::to_string(val);
+                else if constexpr (std::is_same_v<T, int64_t> || std::is_same_v<T, double>)
+                {
+                    char buf[32];
+                    return std::string(detail::format_number(buf, val));
+                }
                 else if constexpr (std::is_same_v<T, bool>)
                     return val ? "true" : "false";
                 else
@@ -698,8 +919,7 @@ namespace nuno
 
         void write_indent()
         {
-            for (size_t i = 0; i < current_spaces_; ++i)
-                *out_ << ' ';
+            out_->put(' ', current_spaces_);
         }
 
         void set_indent_for_key(const document::key_node& k)
@@ -718,6 +938,23 @@ namespace nuno
         }        
     };
 
+    inline size_t serializer::estimate_size(const document& doc)
+    {
+        size_t nodes = doc.keys_.size() * 24 + doc.categories_.size() * 16;
+        for (auto const& t : doc.tables_)
+            nodes += 32 + t.rows.size() * (t.columns.size() * 10 + 4);
+        for (auto const& c : doc.comments_)
+            nodes += c.text.size() + 1;
+        for (auto const& p : doc.paragraphs_)
+            nodes += p.text.size() + 1;
+
+        size_t source = 0;
+        if (doc.source_context_ && doc.source_context_->document.source)
+            source = doc.source_context_->document.source->text.size();
+
+        return std::max(nodes, source);
+    }
+
     inline size_t serializer::infer_indent_for_key(const document::key_node& k)
     {
         // If this key is authored and unedited, use its source
@@ -729,31 +966,35 @@ namespace nuno
                 return *indent;
         }
         
-        // Look for authored siblings in same category
-        auto cat_it = doc_.find_node_by_id(doc_.categories_, k.owner);
-        if (cat_it != doc_.categories_.end())
+        // Look for authored siblings in same category, once per category
+        auto [sibling_indent, fresh] = indent_cache_.keys.try_emplace(k.owner.val);
+        if (fresh)
         {
-            for (auto sibling_id : cat_it->keys)
+            auto cat_it = doc_.find_node_by_id(doc_.categories_, k.owner);
+            if (cat_it != doc_.categories_.end())
             {
-                if (sibling_id == k.id)
-                    continue;  // Skip self
-                
-                auto sibling_it = doc_.find_node_by_id(doc_.keys_, sibling_id);
-                if (sibling_it == doc_.keys_.end())
-                    continue;
-                
-                const auto& sibling = *sibling_it;
-                
-                // Found authored, unedited sibling with source
-                if (sibling.creation == creation_state::authored 
-                    && !sibling.is_edited 
-                    && sibling.source_event_index.has_value())
+                for (auto sibling_id : cat_it->keys)
                 {
-                    if (auto indent = extract_indent_from_source(*sibling.source_event_index))
-                        return *indent;
+                    auto sibling_it = doc_.find_node_by_id(doc_.keys_, sibling_id);
+                    if (sibling_it == doc_.keys_.end())
+                        continue;
+                    
+                    const auto& sibling = *sibling_it;
+                    
+                    // Found authored, unedited sibling with source
+                    if (sibling.creation == creation_state::authored 
+                        && !sibling.is_edited 
+                        && sibling.source_event_index.has_value())
+                    {
+                        if ((sibling_indent->second = extract_indent_from_source(*sibling.source_event_index)))
+                            break;
+                    }
                 }
             }
         }
+
+        if (sibling_indent->second)
+            return *sibling_indent->second;
         
         // Fallback: use current category nesting depth
         return indent_ * STANDARD_INDENT;
@@ -770,30 +1011,34 @@ namespace nuno
                 return *indent;
         }
         
-        // Look for authored sibling tables in same category
-        auto cat_it = doc_.find_node_by_id(doc_.categories_, t.owner);
-        if (cat_it != doc_.categories_.end())
+        // Look for authored sibling tables in same category, once per category
+        auto [sibling_indent, fresh] = indent_cache_.tables.try_emplace(t.owner.val);
+        if (fresh)
         {
-            for (auto sibling_id : cat_it->tables)
+            auto cat_it = doc_.find_node_by_id(doc_.categories_, t.owner);
+            if (cat_it != doc_.categories_.end())
             {
-                if (sibling_id == t.id)
-                    continue;  // Skip self
-                
-                auto sibling_it = doc_.find_node_by_id(doc_.tables_, sibling_id);
-                if (sibling_it == doc_.tables_.end())
-                    continue;
-                
-                const auto& sibling = *sibling_it;
-                
-                if (sibling.creation == creation_state::authored 
-                    && !sibling.is_edited 
-                    && sibling.source_event_index.has_value())
+                for (auto sibling_id : cat_it->tables)
                 {
-                    if (auto indent = extract_indent_from_source(*sibling.source_event_index))
-                        return *indent;
+                    auto sibling_it = doc_.find_node_by_id(doc_.tables_, sibling_id);
+                    if (sibling_it == doc_.tables_.end())
+                        continue;
+                    
+                    const auto& sibling = *sibling_it;
+                    
+                    if (sibling.creation == creation_state::authored 
+                        && !sibling.is_edited 
+                        && sibling.source_event_index.has_value())
+                    {
+                        if ((sibling_indent->second = extract_indent_from_source(*sibling.source_event_index)))
+                            break;
+                    }
                 }
             }
         }
+
+        if (sibling_indent->second)
+            return *sibling_indent->second;
         
         // Fallback: use current category nesting depth
         return indent_ * STANDARD_INDENT;
@@ -814,30 +1059,35 @@ namespace nuno
         if (c.parent == category_id{0})
             return 0;
         
-        // Look for authored sibling subcategories in same parent
-        auto parent_it = doc_.find_node_by_id(doc_.categories_, c.parent);
-        if (parent_it != doc_.categories_.end())
+        // Look for authored sibling subcategories in same parent, once
+        // per parent
+        auto [sibling_indent, fresh] = indent_cache_.categories.try_emplace(c.parent.val);
+        if (fresh)
         {
-            for (auto sibling_id : parent_it->children)
+            auto parent_it = doc_.find_node_by_id(doc_.categories_, c.parent);
+            if (parent_it != doc_.categories_.end())
             {
-                if (sibling_id == c.id)
-                    continue;  // Skip self
-                
-                auto sibling_it = doc_.find_node_by_id(doc_.categories_, sibling_id);
-                if (sibling_it == doc_.categories_.end())
-                    continue;
-                
-                const auto& sibling = *sibling_it;
-                
-                if (sibling.creation == creation_state::authored 
-                    && !sibling.is_edited 
-                    && sibling.source_event_index_open.has_value())
+                for (auto sibling_id : parent_it->children)
                 {
-                    if (auto indent = extract_indent_from_source(*sibling.source_event_index_open))
-                        return *indent;
+                    auto sibling_it = doc_.find_node_by_id(doc_.categories_, sibling_id);
+                    if (sibling_it == doc_.categories_.end())
+                        continue;
+                    
+                    const auto& sibling = *sibling_it;
+                    
+                    if (sibling.creation == creation_state::authored 
+                        && !sibling.is_edited 
+                        && sibling.source_event_index_open.has_value())
+                    {
+                        if ((sibling_indent->second = extract_indent_from_source(*sibling.source_event_index_open)))
+                            break;
+                    }
                 }
             }
         }
+
+        if (sibling_indent->second)
+            return *sibling_indent->second;
         
         // Fallback: use parent indent + standard offset
         return (indent_ - 1) * STANDARD_INDENT;
@@ -867,6 +1117,21 @@ namespace nuno
         return spaces;
     }
 
+//========================================================================
+// Convenience
+//========================================================================
+
+    // Serializes into a string reserved to the estimated size
+    inline std::string serialize_to_string(const document& doc, serializer_options opts = {})
+    {
+        std::string out;
+        out.reserve(serializer::estimate_size(doc));
+
+        output_sink sink(out);
+        serializer(doc, opts).write(sink);
+        return out;
+    }
+
     #undef DBG_EMIT
 
 } // namespace nuno
@@ -62,7 +62,7 @@ int main()
         run_tests("Serialization", run_seriealizer_tests);
     #endif
 
-    #ifdef NUNO_TESTS_COMPREHENSSIVE__ 
+    #ifdef NUNO_TESTS_COMPREHENSIVE__ 
         run_tests("Integration", run_integration_tests);
     #endif
 }
\ No newline at end of file
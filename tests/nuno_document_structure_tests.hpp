@@ -315,6 +315,99 @@ static bool subcategory_at_root_is_rejected()
     return true;
 }
 
+static bool names_are_interned_once()
+{
+    constexpr std::string_view src =
+        "a:\n"
+        "    id = 1\n"
+        "    # id  name\n"
+        "      1  x\n"
+        "/a\n"
+        "b:\n"
+        "    id = 2\n"
+        "    # id  name\n"
+        "      2  y\n"
+        "/b\n";
+
+    auto doc = load(src);
+    EXPECT(!doc.has_errors(), "");
+
+    auto id = doc->find_symbol("id");
+    EXPECT(id.has_value(), "key and column name should be interned");
+    EXPECT(!doc->find_symbol("missing").has_value(), "unknown names have no symbol");
+
+    auto a = doc->category(*doc->find_symbol("a"));
+    auto b = doc->category("b");
+    EXPECT(a.has_value() && b.has_value(), "categories should resolve by symbol and by string");
+
+    EXPECT(a->key(*id)->id() == a->key("id")->id(), "symbol and string key lookups should agree");
+    EXPECT(b->key(*id)->id() != a->key(*id)->id(), "key lookup should be scoped to its category");
+    EXPECT(&a->key(*id)->name() == &b->key(*id)->name(), "equal names should share storage");
+
+    auto ta = doc->table(a->tables().front());
+    auto tb = doc->table(b->tables().front());
+    EXPECT(ta->column_index(*id) == 0 && tb->column_index("name") == 1, "column lookups should resolve");
+    EXPECT(ta->column(*id)->name().data() == tb->column("id")->name().data(), "columns should share interned names");
+    EXPECT(!ta->column("missing").has_value(), "unknown column names should not resolve");
+
+    return true;
+}
+
+//----------------------------------------------------------------------------
+
+inline bool view_ranges_match_view_vectors()
+{
+    constexpr std::string_view src =
+        "a:\n"
+        "    x = 1\n"
+        "    y = 2\n"
+        "    # id  name\n"
+        "      1  p\n"
+        "      2  q\n"
+        "      3  r\n"
+        "    :sub\n"
+        "/a\n";
+
+    auto doc = load(src);
+    EXPECT(!doc.has_errors(), "");
+
+    static_assert(std::ranges::random_access_range<decltype(doc->keys_range())>);
+    static_assert(std::ranges::bidirectional_range<decltype(doc->rows_range())>);
+    static_assert(std::ranges::sized_range<decltype(doc->rows_range())>);
+    static_assert(std::ranges::view<decltype(doc->rows_range())>);
+
+    auto same_ids = [](auto const & range, auto const & vec)
+    {
+        if (range.size() != vec.size()) return false;
+        size_t i = 0;
+        for (auto v : range)
+            if (v.id() != vec[i++].id()) return false;
+        return true;
+    };
+
+    EXPECT(same_ids(doc->categories_range(), doc->categories()), "category range should match categories()");
+    EXPECT(same_ids(doc->tables_range(), doc->tables()), "table range should match tables()");
+    EXPECT(same_ids(doc->columns_range(), doc->columns()), "column range should match columns()");
+    EXPECT(same_ids(doc->rows_range(), doc->rows()), "row range should match rows()");
+    EXPECT(same_ids(doc->keys_range(), doc->keys()), "key range should match keys()");
+
+    auto a = doc->category("a");
+    auto t = doc->table(a->tables().front());
+    auto rows = t->row_views();
+    EXPECT(rows.size() == 3 && rows[1].name() == "2", "row views should be indexable by ordinal");
+    EXPECT(std::ranges::distance(rows.begin(), rows.end()) == 3, "row views should reach every row");
+    EXPECT(t->column_views().end() - t->column_views().begin() == 2, "column view iterators should be random access");
+    EXPECT(t->column_views()[1].name() == "name", "column views should follow column order");
+    EXPECT(a->key_views().size() == 2 && a->key_views().back().name() == "y", "key views should follow key order");
+    EXPECT(a->child_views().front().name() == "sub", "child views should resolve subcategories");
+    EXPECT(a->table_views().front().id() == t->id(), "table views should resolve tables");
+
+    size_t named = std::ranges::count_if(doc->rows_range(), [](auto const & r) { return r.name() != "2"; });
+    EXPECT(named == 2, "ranges should compose with std::ranges algorithms");
+
+    return true;
+}
+
 //----------------------------------------------------------------------------
 
 inline void run_document_structure_tests()
@@ -365,6 +458,12 @@ Key placement rules
     RUN_TEST(keys_attach_to_current_category);
     RUN_TEST(root_key_before_category_is_allowed);
 
+    SUBCAT("Names");
+    RUN_TEST(names_are_interned_once);
+
+    SUBCAT("Views");
+    RUN_TEST(view_ranges_match_view_vectors);
+
 }
 
 }
@@ -4,6 +4,10 @@
 #include "nuno_test_harness.hpp"
 #include "../include/nuno_editor.hpp"
 #include "../include/nuno.hpp"
+#include "../include/nuno_serializer.hpp"
+
+#include <random>
+#include <sstream>
 
 namespace nuno::tests
 {
@@ -236,6 +240,67 @@ inline bool append_row_test()
     return true;
 }
 
+inline bool append_rows_matches_append_row()
+{
+    constexpr std::string_view src =
+        "t:\n"
+        "    # id:int  name  tags:str[]\n"
+        "      1  a  x|y\n"
+        "/t\n";
+
+    auto one = load(src);
+    auto bulk = load(src);
+    editor ed_one(one.document);
+    editor ed_bulk(bulk.document);
+
+    auto tid = one.document.tables()[0].id();
+
+    std::vector<std::vector<value>> rows
+    {
+        { int64_t(2), std::string("b") },
+        { std::string("bad"), std::string("c"), std::string("d") },  // id does not hold an int
+        { int64_t(4) },                                               // short row
+    };
+
+    std::vector<row_id> one_ids;
+    for (auto row : rows)
+        one_ids.push_back(ed_one.append_row(tid, row));
+
+    auto first = ed_bulk.append_rows(tid, rows);
+    EXPECT(first == one_ids[0], "Bulk rows should get the IDs of single appends");
+    EXPECT(std::get<int64_t>(rows[0][0]) == 2, "Integers are left in place by the move");
+
+    auto a = one.document.tables()[0];
+    auto b = bulk.document.tables()[0];
+    EXPECT(b.row_count() == 4, "All rows should be appended");
+
+    for (size_t r = 0; r < a.row_count(); ++r)
+    {
+        auto ra = *one.document.row(a.rows()[r]);
+        auto rb = *bulk.document.row(b.rows()[r]);
+        EXPECT(rb.id() == ra.id(), "Row IDs should match");
+        EXPECT(rb.is_contaminated() == ra.is_contaminated(), "Row contamination should match");
+        auto cells_a = ra.cells(), cells_b = rb.cells();
+        EXPECT(cells_b.size() == cells_a.size(), "Cell counts should match");
+
+        for (size_t c = 0; c < cells_a.size(); ++c)
+        {
+            auto const & ca = cells_a[c];
+            auto const & cb = cells_b[c];
+            EXPECT(cb.value_to_string() == ca.value_to_string() && cb.type == ca.type && cb.type_source == ca.type_source
+                && cb.semantic == ca.semantic, "Cells should match");
+        }
+    }
+
+    EXPECT(bulk.document.row(row_id{first.val + 1})->is_contaminated(), "The invalid row should be a source");
+    EXPECT(b.is_contaminated() && b.owner().is_contaminated(), "The source should reach the table and category");
+    EXPECT(b.row_index("bad") == 2, "Row lookups should see the new rows");
+
+    EXPECT(!ed_bulk.append_rows(tid, {}).valid(), "Appending no rows yields no ID");
+
+    return true;
+}
+
 inline bool append_column_test()
 {
     constexpr std::string_view src =
@@ -332,6 +397,258 @@ inline bool column_type_change_invalidates_rows_typed_col()
     return true;
 }
 
+// Checks the invariants of docs/invariants.md through the public views:
+// flags propagate upwards, derived flags are justified by a contaminated
+// member, and the document has sources iff a key or row is contaminated.
+inline bool contamination_is_consistent(document const & doc)
+{
+    bool any_source = false;
+
+    for (auto k : doc.keys())
+        if (k.is_contaminated())
+        {
+            any_source = true;
+            if (!k.owner().is_contaminated()) return false;
+        }
+
+    for (auto r : doc.rows())
+        if (r.is_contaminated())
+        {
+            any_source = true;
+            if (!r.table().is_contaminated()) return false;
+        }
+
+    for (auto t : doc.tables())
+    {
+        if (!t.is_contaminated())
+            continue;
+        if (!t.owner().is_contaminated())
+            return false;
+
+        bool justified = false;
+        for (auto r : t.row_views())
+            justified |= r.is_contaminated();
+        for (auto c : t.column_views())
+            justified |= c.node->col.semantic != semantic_state::valid;
+        if (!justified) return false;
+    }
+
+    for (auto c : doc.categories())
+    {
+        if (!c.is_contaminated())
+            continue;
+        if (!c.is_root() && !c.parent()->is_contaminated())
+            return false;
+
+        bool justified = false;
+        for (auto k : c.key_views())   justified |= k.is_contaminated();
+        for (auto t : c.table_views()) justified |= t.is_contaminated();
+        for (auto s : c.child_views()) justified |= s.is_contaminated();
+        if (!justified) return false;
+    }
+
+    return any_source == doc.has_contamination_sources();
+}
+
+// Three categories, each with a key, a subcategory holding an array
+// key and a table, and a random share of invalid values
+inline std::string random_contamination_source(std::mt19937 & rng)
+{
+    std::string src;
+    for (int c = 0; c < 3; ++c)
+    {
+        src += "c" + std::to_string(c) + ":\n";
+        src += "    k:int = " + std::string(rng() % 3 ? "1" : "x") + "\n";
+        src += "    :s\n";
+        src += "        n:int[] = 1|" + std::string(rng() % 3 ? "2" : "y") + "\n";
+        src += "        # a:int  b  l:int[]\n";
+        for (int r = 0; r < 4; ++r)
+            src += "          " + std::string(rng() % 4 ? "1" : "z") + "  v  1|2\n";
+        src += "/c" + std::to_string(c) + "\n";
+    }
+    return src;
+}
+
+// Picks a random edit of a document from random_contamination_source.
+// The edit refers to entities by ID, so it applies equally to any
+// document that was loaded from the same source and edited alike.
+inline std::function<void(editor &)> random_edit(document const & doc, std::mt19937 & rng)
+{
+    auto some_value = [&]() -> value
+    {
+        if (rng() % 2) return int64_t(rng() % 9);
+        return std::string("w");
+    };
+
+    auto keys = doc.keys();
+    auto tables = doc.tables();
+    auto const & tbl = tables[rng() % tables.size()];
+    auto rows = tbl.rows();
+    auto cols = tbl.columns();
+    auto tid = tbl.id();
+
+    switch (rng() % 8)
+    {
+        case 0: if (!keys.empty()) return [k = keys[rng() % keys.size()].id(), v = some_value()](editor & ed) { ed.set_key_value(k, v); }; break;
+        case 1: if (!keys.empty()) return [k = keys[rng() % keys.size()].id(), v = some_value()](editor & ed) { ed.set_key_value(k, std::vector<value>{ int64_t(1), v }); }; break;
+        case 2: if (!rows.empty()) return [r = rows[rng() % rows.size()], c = cols[0], v = some_value()](editor & ed) { ed.set_cell_value(r, c, v); }; break;
+        case 3: if (!rows.empty()) return [r = rows[rng() % rows.size()], c = cols[2], v = some_value()](editor & ed) { ed.set_cell_value(r, c, std::vector<value>{ v }); }; break;
+        case 4: return [tid, v = some_value()](editor & ed) { ed.append_row(tid, { v, std::string("v") }); };
+        case 5: if (!rows.empty()) return [r = rows[rng() % rows.size()]](editor & ed) { ed.erase_row(r); }; break;
+        case 6: return [c = cols[0], t = rng() % 2 ? value_type::integer : value_type::string](editor & ed) { ed.set_column_type(c, t); };
+        case 7: if (!keys.empty()) return [k = keys[rng() % keys.size()].id()](editor & ed) { ed.erase_key(k); }; break;
+    }
+    return [](editor &) {};
+}
+
+inline bool contamination_invariants_hold_under_random_edits()
+{
+    std::mt19937 rng(2025);
+
+    for (int round = 0; round < 40; ++round)
+    {
+        auto ctx = load(random_contamination_source(rng));
+        auto & doc = ctx.document;
+        editor ed(doc);
+        EXPECT(contamination_is_consistent(doc), "Materialised document should be consistent");
+
+        for (int op = 0; op < 200; ++op)
+        {
+            random_edit(doc, rng)(ed);
+            EXPECT(contamination_is_consistent(doc), "Contamination invariants should hold after every edit");
+        }
+
+        // Clearing the last root source guarantees a clean document
+        std::vector<key_id> key_ids;
+        std::vector<row_id> row_ids;
+        for (auto k : doc.keys_range()) key_ids.push_back(k.id());
+        for (auto r : doc.rows_range()) row_ids.push_back(r.id());
+
+        for (auto id : key_ids) ed.erase_key(id);
+        for (auto id : row_ids) ed.erase_row(id);
+
+        EXPECT(!doc.has_contamination_sources(), "No sources should remain");
+        EXPECT(!doc.root()->is_contaminated(), "Document should be clean once its sources are gone");
+    }
+
+    return true;
+}
+
+// The contamination flags of every entity, in storage order
+inline std::vector<bool> contamination_flags(document const & doc)
+{
+    std::vector<bool> flags;
+    for (auto k : doc.keys_range())       flags.push_back(k.is_contaminated());
+    for (auto r : doc.rows_range())       flags.push_back(r.is_contaminated());
+    for (auto t : doc.tables_range())     flags.push_back(t.is_contaminated());
+    for (auto c : doc.categories_range()) flags.push_back(c.is_contaminated());
+    return flags;
+}
+
+inline bool batched_edits_match_unbatched_edits()
+{
+    std::mt19937 rng(7);
+
+    for (int round = 0; round < 40; ++round)
+    {
+        auto src = random_contamination_source(rng);
+        auto plain_ctx = load(src);
+        auto batch_ctx = load(src);
+        editor plain(plain_ctx.document);
+        editor batched(batch_ctx.document);
+
+        for (int b = 0; b < 8; ++b)
+        {
+            {
+                auto guard = batched.begin_batch();
+                for (int op = 0; op < 25; ++op)
+                {
+                    auto edit = random_edit(plain_ctx.document, rng);
+                    edit(plain);
+                    edit(batched);
+                }
+            }
+
+            EXPECT(contamination_flags(batch_ctx.document) == contamination_flags(plain_ctx.document),
+                   "A committed batch should leave the flags of the unbatched edits");
+            EXPECT(contamination_is_consistent(batch_ctx.document), "Contamination invariants should hold after a commit");
+        }
+    }
+
+    return true;
+}
+
+inline bool batch_rolls_back_on_failure()
+{
+    auto ctx = load("a:int = 1\n# x:int  y\n  1  p\n  2  q\n");
+    auto & doc = ctx.document;
+    editor ed(doc);
+
+    // IDs, as a rollback invalidates views
+    auto a = doc.key("a")->id();
+    auto table = doc.tables()[0].id();
+    auto x = doc.tables()[0].columns()[0];
+    auto row_span = doc.tables()[0].rows();
+    std::vector<row_id> rows(row_span.begin(), row_span.end());
+
+    // A clean batch commits
+    {
+        auto b = ed.begin_batch(editor::batch_failure::rollback);
+        ed.set_key_value(a, int64_t(5));
+        ed.append_row(table, { int64_t(3), std::string("r") });
+        EXPECT(b.commit(), "A batch leaving no contamination should commit");
+    }
+    EXPECT(std::get<int64_t>(doc.key("a")->value().val) == 5, "Committed edit should stay");
+    EXPECT(doc.row_count() == 3, "Committed row should stay");
+
+    // A contaminating batch rolls back, undoing its clean edits too
+    {
+        auto b = ed.begin_batch(editor::batch_failure::rollback);
+        ed.set_key_value(a, int64_t(7));
+        ed.set_cell_value(rows[0], x, std::string("bad"));
+        EXPECT(!b.commit(), "A contaminating batch should fail");
+    }
+    EXPECT(std::get<int64_t>(doc.key("a")->value().val) == 5, "Rolled back edit should be undone");
+    EXPECT(!doc.row(rows[0])->is_contaminated(), "Rolled back row should be clean");
+    EXPECT(!doc.has_contamination_sources(), "Rollback should restore the sources");
+
+    // batch_failure::keep keeps a failed batch
+    {
+        auto b = ed.begin_batch();
+        ed.set_cell_value(rows[1], x, std::string("bad"));
+        EXPECT(!b.commit(), "A contaminating batch should fail");
+    }
+    EXPECT(doc.row(rows[1])->is_contaminated(), "Kept batch should contaminate its row");
+
+    // Touching a row that was already contaminated is not a failure
+    {
+        auto b = ed.begin_batch(editor::batch_failure::rollback);
+        ed.set_key_value(a, int64_t(9));
+        ed.set_cell_value(rows[1], x, std::string("worse"));
+        EXPECT(b.commit(), "A batch creating no new contamination should commit");
+    }
+    EXPECT(std::get<int64_t>(doc.key("a")->value().val) == 9, "Committed edit should stay");
+    EXPECT(doc.row(rows[1])->is_contaminated(), "The row should stay contaminated");
+
+    // An exception rolls back; a joined batch defers to its enclosing one
+    try
+    {
+        auto b = ed.begin_batch(editor::batch_failure::rollback);
+        auto inner = ed.begin_batch();
+        EXPECT(!inner.is_open(), "A nested batch should join the open one");
+        ed.erase_row(rows[1]);
+        throw std::runtime_error("abort");
+    }
+    catch (std::runtime_error const &) {}
+    EXPECT(doc.row(rows[1]).has_value(), "Unwinding should roll the batch back");
+    EXPECT(doc.row(rows[1])->is_contaminated(), "Rollback should keep earlier contamination");
+
+    auto next = ed.append_key(doc.root()->id(), "b", int64_t(1));
+    EXPECT(next.valid() && doc.key("b").has_value(), "Editing should resume after a rollback");
+
+    return true;
+}
+
 // Test insertion ordering
 inline bool insert_key_maintains_order()
 {
@@ -513,6 +830,574 @@ inline bool category_creation_and_nesting()
     return true;
 }
 
+inline bool id_lookup_survives_erasure()
+{
+    auto ctx = load(
+        "a = 1\n"
+        "b = 2\n"
+        "c = 3\n"
+        "# x  y\n"
+        "  1  2\n"
+        "  3  4\n"
+        "  5  6\n");
+    auto & doc = ctx.document;
+    editor ed(doc);
+
+    auto ka = doc.key("a")->id();
+    auto kb = doc.key("b")->id();
+    auto kc = doc.key("c")->id();
+
+    auto tbl  = doc.table(table_id{0});
+    auto rows = std::vector<row_id>(tbl->rows().begin(), tbl->rows().end());
+
+    EXPECT(ed.erase_key(kb), "Key erase failed");
+    EXPECT(ed.erase_row(rows[1]), "Row erase failed");
+
+    EXPECT(!doc.key(kb).has_value(), "Erased key should not resolve");
+    EXPECT(!doc.row(rows[1]).has_value(), "Erased row should not resolve");
+
+    EXPECT(doc.key(ka)->name() == "a", "Key before erased slot resolves wrongly");
+    EXPECT(doc.key(kc)->name() == "c", "Key after erased slot resolves wrongly");
+
+    auto last = doc.row(rows[2]);
+    EXPECT(last.has_value(), "Row after erased slot should resolve");
+    EXPECT(last->table().id() == tbl->id(), "Row resolves to wrong table");
+    EXPECT(last->owner().is_root(), "Row resolves to wrong owner");
+
+    auto kd = ed.append_key(doc.root()->id(), "d", 4);
+    EXPECT(doc.key(kd)->name() == "d", "Appended key should resolve");
+
+    return true;
+}
+
+inline bool name_lookups_follow_edits()
+{
+    auto ctx = load("a:\n    x = 1\n/a\n");
+    auto & doc = ctx.document;
+    editor ed(doc);
+
+    auto cat = doc.category("a")->id();
+    auto x1  = doc.key("x")->id();
+
+    // A duplicate name resolves to the first in order, as a scan would
+    auto x2 = ed.append_key(cat, "x", 2);
+    EXPECT(doc.category(cat)->key("x")->id() == x1, "First key of a duplicated name should resolve");
+    EXPECT(ed.erase_key(x1), "Key erase failed");
+    EXPECT(doc.category(cat)->key("x")->id() == x2, "Remaining duplicate should resolve after erase");
+    EXPECT(doc.key("x")->id() == x2, "Document lookup should follow the erase");
+    EXPECT(ed.erase_key(x2), "Key erase failed");
+    EXPECT(!doc.category(cat)->key("x").has_value() && !doc.key("x").has_value(), "Erased key should not resolve");
+
+    auto sub = ed.append_category(cat, "sub");
+    EXPECT(doc.category(cat)->child("sub")->id() == sub, "Appended category should resolve");
+    EXPECT(ed.erase_category(sub), "Category erase failed");
+    EXPECT(!doc.category(cat)->child("sub").has_value() && !doc.category("sub").has_value(), "Erased category should not resolve");
+
+    auto tbl = ed.append_table(cat, std::vector<std::string>{ "p", "q" });
+    auto r   = ed.append_column(tbl, "r", std::nullopt);
+    EXPECT(doc.table(tbl)->column("r")->id() == r && doc.table(tbl)->column_index("q") == 1, "Columns should resolve");
+    EXPECT(ed.erase_column(doc.table(tbl)->column("p")->id()), "Column erase failed");
+    EXPECT(!doc.table(tbl)->column("p").has_value() && doc.table(tbl)->column_index("r") == 1, "Column index should follow the erase");
+
+    return true;
+}
+
+inline bool row_lookups_follow_edits()
+{
+    auto ctx = load("t:\n    # id  v\n      a  1\n      b  2\n      a  3\n/t\n");
+    auto & doc = ctx.document;
+    editor ed(doc);
+
+    auto tbl  = doc.tables().front().id();
+    auto rows = [&] { return doc.table(tbl)->rows(); };
+    auto r0 = rows()[0], r1 = rows()[1], r2 = rows()[2];
+
+    EXPECT(doc.table(tbl)->row_index("a") == 0 && doc.table(tbl)->row_index("b") == 1, "Rows should resolve by name");
+    EXPECT(doc.table(tbl)->row_indices("a") == std::vector<size_t>({ 0, 2 }), "All rows of a name should resolve in order");
+    EXPECT(doc.row(r2)->index() == 2, "Row ordinal should resolve");
+
+    auto r3 = ed.insert_row_before(r0, { std::string("c"), 4 });
+    EXPECT(doc.table(tbl)->row_index("c") == 0 && doc.row(r2)->index() == 3, "Lookups should follow an insert");
+
+    ed.move_row_after(r3, r2);
+    EXPECT(doc.table(tbl)->row_index("c") == 3 && doc.row(r0)->index() == 0, "Lookups should follow a move");
+
+    EXPECT(ed.erase_row(r0), "Row erase failed");
+    EXPECT(doc.table(tbl)->row_index("a") == 1 && doc.row(r1)->index() == 0, "Lookups should follow an erase");
+
+    ed.set_cell_value(r1, doc.table(tbl)->columns()[0], std::string("d"));
+    EXPECT(!doc.table(tbl)->row_index("b").has_value() && doc.table(tbl)->row_index("d") == 0, "Lookups should follow a renaming cell edit");
+
+    EXPECT(ed.set_table_layout(tbl, table_layout::columnar), "Columnar conversion failed");
+    EXPECT(doc.table(tbl)->row_index("c") == 2 && doc.row(r3)->index() == 2, "Columnar rows should resolve");
+
+    return true;
+}
+
+inline bool erased_rows_are_tombstoned_until_compacted()
+{
+    auto ctx = load("t:\n    # id  v\n      a  1\n      b  2\n      c  3\n      d  4\n      e  5\n/t\n");
+    auto & doc = ctx.document;
+    editor ed(doc);
+
+    auto tbl  = doc.tables().front().id();
+    auto span = doc.table(tbl)->rows();
+    auto rows = std::vector<row_id>(span.begin(), span.end());
+    auto c    = doc.row(rows[2]);
+
+    EXPECT(ed.erase_row(rows[1]) && ed.erase_row(rows[3]), "Row erase failed");
+    EXPECT(!ed.erase_row(rows[1]), "Erasing an erased row should fail");
+
+    // Counts are exact before anything is purged
+    EXPECT(doc.row_count() == 3 && doc.table(tbl)->row_count() == 3, "Counts should exclude erased rows");
+    EXPECT(!doc.row(rows[1]).has_value() && !doc.row(rows[3]).has_value(), "Erased rows should not resolve");
+    EXPECT(doc.row(rows[4])->name() == "e" && doc.row(rows[4])->index() == 2, "Rows after a tombstone should resolve");
+
+    auto listed = doc.table(tbl)->rows();
+    EXPECT(std::vector<row_id>(listed.begin(), listed.end()) == std::vector<row_id>({ rows[0], rows[2], rows[4] }),
+        "Row lists should omit erased rows");
+
+    // Reads skip the tombstones and leave them in place, so a view taken
+    // before the erase still sees its row
+    auto const & cdoc = doc;
+    EXPECT(cdoc.rows().size() == 3 && std::ranges::distance(cdoc.rows_range()) == 3, "Reads should skip erased rows");
+    EXPECT(cdoc.table(tbl)->row_views()[1].name() == "c", "Row views should skip erased rows");
+    EXPECT(c->id() == rows[2] && c->name() == "c", "Reads should not move rows under their views");
+
+    doc.compact();
+    EXPECT(std::ranges::size(doc.rows_range()) == 3, "Compaction should drop the tombstones");
+    for (size_t i : { 0, 2, 4 })
+        EXPECT(doc.row(rows[i])->id() == rows[i], "IDs should survive compaction");
+
+    auto f = ed.append_row(tbl, { std::string("f"), 6 });
+    EXPECT(f.val > rows[4].val && doc.row(f)->index() == 3, "Erased IDs should not be reused");
+
+    // Erasing most rows purges the tombstones on the way
+    EXPECT(ed.erase_row(rows[0]) && ed.erase_row(rows[2]) && ed.erase_row(rows[4]), "Row erase failed");
+    EXPECT(doc.row_count() == 1 && doc.row(f)->index() == 0 && doc.rows().front().name() == "f", "Rows should resolve after a purge");
+
+    EXPECT(ed.erase_table(tbl), "Table erase failed");
+    EXPECT(doc.row_count() == 0 && doc.rows().empty(), "Erasing a table should erase its rows");
+
+    return true;
+}
+
+//============================================================================
+// Columnar tables
+//============================================================================
+
+constexpr std::string_view columnar_src =
+    "items:\n"
+    "    # id:int  name  price:float  tags:str[]\n"
+    "      1  apple  0.5  red|green\n"
+    "      2  pear  x  green\n"
+    "      3  plum  2.25  \n"
+    "/items\n";
+
+inline bool same_cell(typed_value const & a, typed_value const & b)
+{
+    if (a.val.index() != b.val.index() || a.value_to_string() != b.value_to_string())
+        return false;
+
+    if (is_array(a) && !std::ranges::equal(std::get<std::vector<typed_value>>(a.val), std::get<std::vector<typed_value>>(b.val), same_cell))
+        return false;
+
+    return a.type == b.type && a.type_source == b.type_source
+        && a.origin == b.origin && a.semantic == b.semantic
+        && a.contamination == b.contamination && a.creation == b.creation
+        && a.is_edited == b.is_edited;
+}
+
+inline bool same_rows(document const & a, document const & b)
+{
+    auto ta = a.tables(), tb = b.tables();
+    if (ta.size() != tb.size()) return false;
+
+    for (size_t t = 0; t < ta.size(); ++t)
+    {
+        if (ta[t].row_count() != tb[t].row_count()) return false;
+        if (ta[t].is_contaminated() != tb[t].is_contaminated()) return false;
+
+        for (size_t r = 0; r < ta[t].row_count(); ++r)
+        {
+            auto ra = *a.row(ta[t].rows()[r]), rb = *b.row(tb[t].rows()[r]);
+            if (ra.name() != rb.name() || ra.is_contaminated() != rb.is_contaminated())
+                return false;
+
+            auto ca = ra.cells(), cb = rb.cells();
+            if (!std::ranges::equal(ca, cb, same_cell))
+                return false;
+        }
+    }
+    return true;
+}
+
+inline bool columnar_table_reads_like_row_table()
+{
+    auto rows_ctx     = load(columnar_src);
+    auto columnar_ctx = load(columnar_src, materialiser_options{ .columnar_min_rows = 1 });
+
+    auto tbl = columnar_ctx.document.table(table_id{0});
+    EXPECT(tbl->layout() == table_layout::columnar, "Table should be stored column-wise");
+    EXPECT(rows_ctx.document.table(table_id{0})->layout() == table_layout::rows, "Tables are row-oriented by default");
+
+    auto const & price = tbl->column_storage()->columns[2];
+    EXPECT(price.packed_type() == value_type::floating_point, "Price column should pack reals");
+    EXPECT(price.is_packed(0) && !price.is_invalid(0), "Real cells should be packed");
+    EXPECT(!price.is_packed(1), "A string in a real column should be stored as an exception");
+    EXPECT(!tbl->column_storage()->columns[3].is_packed(0), "Array cells should be stored as exceptions");
+
+    bool matched = false;
+    tbl->doc->row(tbl->rows()[1])->visit_cell(1, [&](typed_value const & cell)
+    {
+        matched = cell.value_to_string() == "pear";
+    });
+    EXPECT(matched, "visit_cell should decode the requested cell");
+
+    EXPECT(same_rows(rows_ctx.document, columnar_ctx.document), "Columnar cells should read as the row cells");
+    EXPECT(tbl->row_index("3") == 2, "Row names should resolve through the column store");
+
+    return true;
+}
+
+inline bool editing_columnar_table_returns_rows()
+{
+    auto ctx = load(columnar_src);
+    auto & doc = ctx.document;
+    editor ed(doc);
+
+    auto tid = table_id{0};
+    EXPECT(ed.set_table_layout(tid, table_layout::columnar), "Table should convert to columnar");
+
+    auto tbl = doc.table(tid);
+    auto r0  = tbl->rows()[0];
+    ed.set_cell_value(r0, tbl->columns()[1], value{ std::string("quince") });
+
+    EXPECT(doc.table(tid)->layout() == table_layout::rows, "Editing a cell should return the table to row layout");
+    EXPECT(doc.row(r0)->name() == "1", "Untouched cells should survive the conversion");
+    EXPECT(std::get<std::string>(doc.row(r0)->cells()[1].val) == "quince", "Cell edit was lost");
+
+    EXPECT(ed.set_table_layout(tid, table_layout::columnar), "Table should convert back to columnar");
+    auto rid = ed.append_row(tid, { int64_t{4}, std::string("fig"), 1.5, value{} });
+    EXPECT(doc.table(tid)->layout() == table_layout::rows, "Appending a row should return the table to row layout");
+    EXPECT(doc.table(tid)->row_count() == 4 && doc.row(rid)->cells().size() == 4, "Appended row missing");
+    EXPECT(std::get<std::string>(doc.row(r0)->cells()[1].val) == "quince", "Earlier edit was lost");
+
+    return true;
+}
+
+inline bool columnar_column_retype_matches_rows()
+{
+    value_type types[] = { value_type::string, value_type::integer, value_type::floating_point, value_type::unresolved };
+
+    for (size_t col = 0; col < 4; ++col)
+    {
+        for (auto type : types)
+        {
+            auto rows_ctx     = load(columnar_src);
+            auto columnar_ctx = load(columnar_src, materialiser_options{ .columnar_min_rows = 1 });
+
+            editor er(rows_ctx.document), ec(columnar_ctx.document);
+            auto cid = rows_ctx.document.table(table_id{0})->columns()[col];
+
+            bool ok_rows     = er.set_column_type(cid, type);
+            bool ok_columnar = ec.set_column_type(cid, type);
+
+            EXPECT(ok_rows == ok_columnar, "Retype result differs between layouts");
+            EXPECT(columnar_ctx.document.table(table_id{0})->layout() == table_layout::columnar, "Retyping should not leave columnar layout");
+            EXPECT(same_rows(rows_ctx.document, columnar_ctx.document), "Retyped cells differ between layouts");
+        }
+    }
+
+    return true;
+}
+
+inline bool columnar_retype_is_undone_in_place()
+{
+    value_type types[] = { value_type::string, value_type::integer, value_type::floating_point, value_type::unresolved };
+
+    for (size_t col = 0; col < 4; ++col)
+    {
+        for (auto type : types)
+        {
+            auto before       = load(columnar_src);
+            auto after        = load(columnar_src);
+            auto columnar_ctx = load(columnar_src, materialiser_options{ .columnar_min_rows = 1 });
+            auto & doc        = columnar_ctx.document;
+
+            auto cid = doc.table(table_id{0})->columns()[col];
+            editor(after.document).set_column_type(cid, type);
+
+            editor ed(doc);
+            ed.enable_history();
+            ed.set_column_type(cid, type);
+
+            EXPECT(doc.table(table_id{0})->layout() == table_layout::columnar, "Retyping with history should not leave columnar layout");
+            EXPECT(same_rows(after.document, doc), "Retyped cells differ between layouts");
+
+            EXPECT(ed.undo(), "Retype should be undoable");
+            EXPECT(doc.table(table_id{0})->layout() == table_layout::columnar, "Undo should keep columnar layout");
+            EXPECT(same_rows(before.document, doc), "Undo should restore the cells");
+
+            EXPECT(ed.redo(), "Retype should be redoable");
+            EXPECT(same_rows(after.document, doc), "Redo should retype the cells again");
+        }
+    }
+
+    return true;
+}
+
+inline bool layout_undo_restores_store_indices()
+{
+    auto before       = load(columnar_src);
+    auto columnar_ctx = load(columnar_src, materialiser_options{ .columnar_min_rows = 1 });
+    auto & doc        = columnar_ctx.document;
+    auto tid          = table_id{0};
+
+    editor ed(doc);
+    ed.enable_history();
+
+    // The store built after the erase numbers the remaining rows anew
+    EXPECT(ed.erase_row(doc.table(tid)->rows()[0]), "Row should erase");
+    EXPECT(ed.set_table_layout(tid, table_layout::rows), "Table should convert to rows");
+    EXPECT(ed.set_table_layout(tid, table_layout::columnar), "Table should convert back to columnar");
+
+    EXPECT(ed.undo() && ed.undo(), "Layout changes should be undoable");
+    EXPECT(doc.table(tid)->layout() == table_layout::columnar, "Undo should put back the first store");
+    EXPECT(ed.undo(), "Erase should be undoable");
+    EXPECT(same_rows(before.document, doc), "Rows should read their cells from the first store again");
+
+    EXPECT(ed.redo() && ed.redo() && ed.redo(), "Edits should be redoable");
+    EXPECT(doc.table(tid)->row_count() == 2, "Redo should erase the row again");
+    EXPECT(doc.row(doc.table(tid)->rows()[0])->name() == before.document.table(tid)->row_views()[1].name(),
+           "Rows should read their cells from the second store again");
+
+    return true;
+}
+
+inline bool first_column_undo_renames_rows()
+{
+    auto ctx    = load(columnar_src);
+    auto & doc  = ctx.document;
+    auto tid    = table_id{0};
+    auto first  = doc.table(tid)->columns()[0];
+    auto text   = [&doc] { std::ostringstream out; serializer(doc).write(out); return out.str(); };
+    auto before = text();
+
+    editor ed(doc);
+    ed.enable_history();
+
+    // Rows are named by the cells of the first column
+    EXPECT(ed.insert_column_before(first, "key", value_type::string).valid(), "Column should insert");
+    EXPECT(!doc.table(tid)->row_index("2"), "The new column should name the rows");
+    EXPECT(ed.undo(), "Insert should be undoable");
+    EXPECT(doc.table(tid)->row_index("2") == 1, "Undo should name the rows by their IDs again");
+    EXPECT(text() == before, "Undo should take the inserted cells out");
+
+    EXPECT(ed.erase_column(first), "Column should erase");
+    EXPECT(doc.table(tid)->row_index("pear") == 1, "The next column should name the rows");
+    EXPECT(ed.undo(), "Erase should be undoable");
+    EXPECT(doc.table(tid)->row_index("2") == 1 && !doc.table(tid)->row_index("pear"),
+           "Undo should name the rows by their IDs again");
+    EXPECT(text() == before, "Undo should put the erased cells back");
+
+    EXPECT(ed.redo(), "Erase should be redoable");
+    EXPECT(doc.table(tid)->row_index("pear") == 1, "Redo should name the rows by the next column again");
+
+    return true;
+}
+
+// Everything an undo restores: the text, the IDs in storage order,
+// the row lists, the contamination flags, sources and counts and the
+// edit marks
+inline std::string document_state(document const & doc, editor & ed)
+{
+    std::ostringstream out;
+    serializer(doc).write(out);
+
+    out << "\nkeys";
+    for (auto k : doc.keys_range())
+        out << ' ' << k.id().val << (ed._unsafe_access_internal_document_container(k.id())->is_edited ? "e" : "");
+    out << "\nrows";
+    for (auto r : doc.rows_range())
+        out << ' ' << r.id().val << (ed._unsafe_access_internal_document_container(r.id())->is_edited ? "e" : "");
+    for (auto t : doc.tables_range())
+    {
+        out << "\ntable " << t.id().val << " sources " << ed._unsafe_access_internal_document_container(t.id())->contaminated_rows << ':';
+        for (auto rid : t.rows()) out << ' ' << rid.val;
+    }
+    out << "\ncategories";
+    for (auto c : doc.categories_range())
+    {
+        auto* cn = ed._unsafe_access_internal_document_container(c.id());
+        out << ' ' << c.id().val << '/' << cn->contaminated_keys << '/' << cn->contaminated_children;
+    }
+
+    out << "\nflags ";
+    for (bool f : contamination_flags(doc)) out << f;
+    out << ' ' << doc.has_contamination_sources();
+    return out.str();
+}
+
+// Picks an edit of the structure of a document from
+// random_contamination_source, one undo step each
+inline std::function<void(editor &)> random_structural_edit(document const & doc, std::mt19937 & rng)
+{
+    auto tables = doc.tables();
+    auto const & tbl = tables[rng() % tables.size()];
+    auto rows = tbl.rows();
+    auto cols = tbl.columns();
+    auto tid = tbl.id();
+    auto cats = doc.categories();
+    auto cat = cats[rng() % cats.size()].id();
+    auto keys = doc.keys();
+
+    switch (rng() % 13)
+    {
+        case 0: return [tid](editor & ed) { ed.set_table_layout(tid, table_layout::columnar); };
+        case 1: return [tid](editor & ed) { ed.set_table_layout(tid, table_layout::rows); };
+        case 2: if (!rows.empty()) return [r = rows[rng() % rows.size()]](editor & ed) { ed.insert_row_after(r, { int64_t(4), std::string("i") }); }; break;
+        case 3: if (!rows.empty()) return [r = rows[rng() % rows.size()], a = rows[rng() % rows.size()]](editor & ed) { ed.move_row_before(r, a); }; break;
+        case 4: return [cat](editor & ed) { ed.append_key(cat, "n", int64_t(3)); };
+        case 5: if (!keys.empty()) return [k = keys[rng() % keys.size()].id()](editor & ed) { ed.insert_comment_before(k, "// c"); }; break;
+        case 6:
+            if (cols.size() > 3) return [c = cols.back()](editor & ed) { ed.erase_column(c); };
+            return [tid](editor & ed) { ed.append_column(tid, "e", value_type::integer); };
+        case 7:
+            if (tables.size() > 1) return [tid](editor & ed) { ed.erase_table(tid); };
+            return [cat](editor & ed) { ed.append_table(cat, std::vector<std::string>{ "a", "b", "l" }); };
+        case 8: return [cat](editor & ed) { ed.append_category(cat, "s"); };
+        case 9: return [c = cats.back().id()](editor & ed) { ed.erase_category(c); };
+        case 10:
+            return [&doc, &rng](editor & ed)
+            {
+                auto b = ed.begin_batch();
+                for (int i = 0; i < 3; ++i)
+                    random_edit(doc, rng)(ed);
+            };
+        case 11:
+            return [&doc, &rng](editor & ed)
+            {
+                auto b = ed.begin_batch(editor::batch_failure::rollback);
+                for (int i = 0; i < 2; ++i)
+                    random_edit(doc, rng)(ed);
+            };
+        case 12:
+            return [tid](editor & ed)
+            {
+                std::vector<std::vector<value>> rows{ { int64_t(5), std::string("a") }, { std::string("x") } };
+                ed.append_rows(tid, rows);
+            };
+    }
+    return [](editor &) {};
+}
+
+inline bool undo_and_redo_restore_every_step()
+{
+    std::mt19937 rng(11);
+
+    for (int round = 0; round < 30; ++round)
+    {
+        auto ctx = load(random_contamination_source(rng));
+        auto & doc = ctx.document;
+        editor ed(doc);
+        ed.enable_history();
+
+        auto original = document_state(doc, ed);
+
+        for (int op = 0; op < 60; ++op)
+        {
+            auto edit = rng() % 3 ? random_edit(doc, rng) : random_structural_edit(doc, rng);
+            auto before = document_state(doc, ed);
+            edit(ed);
+            auto after = document_state(doc, ed);
+            if (before == after)
+                continue;
+
+            EXPECT(ed.undo(), "An edit should be undoable");
+            EXPECT(document_state(doc, ed) == before, "Undo should restore the document before the edit");
+            EXPECT(contamination_is_consistent(doc), "Contamination invariants should hold after an undo");
+            EXPECT(ed.redo(), "An undone edit should be redoable");
+            EXPECT(document_state(doc, ed) == after, "Redo should restore the document after the edit");
+        }
+
+        auto final_state = document_state(doc, ed);
+
+        while (ed.undo()) {}
+        EXPECT(document_state(doc, ed) == original, "Undoing every step should restore the loaded document");
+        EXPECT(contamination_is_consistent(doc), "Contamination invariants should hold once all is undone");
+
+        while (ed.redo()) {}
+        EXPECT(document_state(doc, ed) == final_state, "Redoing every step should restore the edited document");
+
+        // A new edit discards what was undone
+        ed.undo();
+        ed.append_comment(doc.root()->id(), "// new");
+        EXPECT(!ed.can_redo(), "A new edit should discard the undone steps");
+    }
+
+    return true;
+}
+
+inline std::string serialize(document const & doc, bool verbatim_regions)
+{
+    serializer_options opts;
+    opts.verbatim_regions = verbatim_regions;
+    std::ostringstream out;
+    serializer(doc, opts).write(out);
+    return out.str();
+}
+
+inline bool verbatim_regions_match_line_replay()
+{
+    std::mt19937 rng(23);
+
+    for (int round = 0; round < 30; ++round)
+    {
+        // Comments and blank lines among the keys and rows
+        auto src = random_contamination_source(rng);
+        for (auto [line, extra] : { std::pair{ "    :s\n", "    // s\n\n" }, std::pair{ "  v  1|2\n", "          // r\n" } })
+            if (auto at = src.find(line, rng() % src.size()); at != std::string::npos)
+                src.insert(at + std::string_view(line).size(), extra);
+
+        auto ctx = load(src);
+        auto & doc = ctx.document;
+        editor ed(doc);
+        if (rng() % 2)
+            ed.enable_history();
+
+        EXPECT(serialize(doc, true) == serialize(doc, false), "An unedited document should serialize alike either way");
+
+        for (int op = 0; op < 40; ++op)
+        {
+            auto edit = rng() % 3 ? random_edit(doc, rng) : random_structural_edit(doc, rng);
+            edit(ed);
+            if (ed.history_enabled() && rng() % 4 == 0)
+            {
+                ed.undo();
+                if (rng() % 2) ed.redo();
+            }
+
+            EXPECT(serialize(doc, true) == serialize(doc, false), "Copied regions should hold what replaying their lines writes");
+        }
+    }
+
+    // An edit leaves the extents of the other categories
+    auto ctx = load(random_contamination_source(rng));
+    auto & doc = ctx.document;
+    editor ed(doc);
+    EXPECT(doc.is_verbatim_source(), "An unedited document should serialize as its source");
+
+    ed.set_key_value(doc.category("c1")->key("k")->id(), int64_t(5));
+    EXPECT(!doc.is_verbatim_source(), "An edited document should no longer serialize as its source");
+
+    auto extent = [&](std::string_view name) { return ed._unsafe_access_internal_document_container(doc.category(name)->id())->extent.has_value(); };
+    EXPECT(extent("c0") && extent("c2"), "Untouched categories should keep their source extents");
+    EXPECT(!extent("c1"), "An edited category should lose its source extent");
+
+    return true;
+}
+
 //============================================================================
 // Test Runner
 //============================================================================
@@ -535,12 +1420,24 @@ inline void run_editor_tests()
 
     SUBCAT("Structural edits");
     RUN_TEST(append_row_test);
+    RUN_TEST(append_rows_matches_append_row);
     RUN_TEST(append_column_test);
 
     SUBCAT("Contamination / invalidation");
     RUN_TEST(invalid_array_contamination_key);
     RUN_TEST(column_type_change_invalidates_rows_untyped_col);
     RUN_TEST(column_type_change_invalidates_rows_typed_col);
+    RUN_TEST(contamination_invariants_hold_under_random_edits);
+
+    SUBCAT("Batches");
+    RUN_TEST(batched_edits_match_unbatched_edits);
+    RUN_TEST(batch_rolls_back_on_failure);
+
+    SUBCAT("History");
+    RUN_TEST(undo_and_redo_restore_every_step);
+
+    SUBCAT("Serialization");
+    RUN_TEST(verbatim_regions_match_line_replay);
 
     SUBCAT("Insertion / deletion");
     RUN_TEST(insert_key_maintains_order);
@@ -550,6 +1447,18 @@ inline void run_editor_tests()
     RUN_TEST(column_insertion_and_deletion);
     RUN_TEST(minimal_create_categories);
     RUN_TEST(category_creation_and_nesting);
+    RUN_TEST(id_lookup_survives_erasure);
+    RUN_TEST(name_lookups_follow_edits);
+    RUN_TEST(row_lookups_follow_edits);
+    RUN_TEST(erased_rows_are_tombstoned_until_compacted);
+
+    SUBCAT("Columnar tables");
+    RUN_TEST(columnar_table_reads_like_row_table);
+    RUN_TEST(editing_columnar_table_returns_rows);
+    RUN_TEST(columnar_column_retype_matches_rows);
+    RUN_TEST(columnar_retype_is_undone_in_place);
+    RUN_TEST(layout_undo_restores_store_indices);
+    RUN_TEST(first_column_undo_renames_rows);
 }
 
 }
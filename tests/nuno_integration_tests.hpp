@@ -120,6 +120,48 @@ bool workflow_complex_document_construction()
     return true;
 }
 
+// Test: Load from file → Serialize (replay from the mapped source)
+bool workflow_load_file_serialize()
+{
+    constexpr std::string_view src = 
+        "// Game data\n"
+        "units:\n"
+        "    speed:float = 1.5\n"
+        "    # name  hp:int\n"
+        "      orc   30\n"
+        "      elf   20\n";
+
+    auto path = std::filesystem::temp_directory_path() / "nuno_load_file_test.nuno";
+    {
+        std::ofstream f(path, std::ios::binary);
+        f << src;
+    }
+
+    std::string serialized;
+    {
+        auto ctx = load_file(path);
+        EXPECT(!ctx.has_errors(), "Loading file failed");
+
+        auto speed = query(ctx.document, "units.speed").as_real();
+        EXPECT(speed.has_value() && *speed == 1.5, "Query on loaded file failed");
+
+        std::ostringstream out;
+        serializer s(ctx.document);
+        s.write(out);
+        serialized = out.str();
+    }
+    std::filesystem::remove(path);
+
+    EXPECT(serialized == src, "Unedited file should round-trip verbatim");
+
+    auto missing = load_file(path);
+    EXPECT(missing.has_errors(), "Missing file should report an error");
+    EXPECT(is_parse_error(missing.errors.front().kind), "Missing file should be a parse error");
+    EXPECT(get_parse_error(missing.errors.front().kind) == parse_error_kind::file_unreadable, "Wrong error kind");
+
+    return true;
+}
+
 //============================================================================
 // Test Runner
 //============================================================================
@@ -130,6 +172,7 @@ inline void run_integration_tests()
     RUN_TEST(workflow_query_edit_serialize);
     RUN_TEST(workflow_generate_serialize_parse);
     RUN_TEST(workflow_complex_document_construction);
+    RUN_TEST(workflow_load_file_serialize);
 }
 
 }
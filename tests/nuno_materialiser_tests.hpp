@@ -641,6 +641,30 @@ static bool no_key_owned_by_nonexistent_category()
     return true;
 }
 
+static bool literal_classification_follows_strtol_rules()
+{
+    auto kind = [](std::string_view s) { return classify_literal(s).kind; };
+
+    EXPECT(kind("42") == literal_kind::integer, "integer not classified");
+    EXPECT(classify_literal("+7").i == 7, "leading + not accepted");
+    EXPECT(classify_literal(" -3").i == -3, "leading whitespace not accepted");
+    EXPECT(kind("1.5e3") == literal_kind::floating_point, "exponent not classified as float");
+    EXPECT(classify_literal(".5").d == 0.5, "leading point not accepted");
+    EXPECT(kind("99999999999999999999") == literal_kind::floating_point, "out of range integer should be float");
+    EXPECT(kind("true") == literal_kind::boolean && classify_literal("false").b == false, "bool not classified");
+    EXPECT(kind("truex") == literal_kind::string, "bool prefix accepted");
+    EXPECT(kind("+-1") == literal_kind::string, "double sign accepted");
+    EXPECT(kind("1 ") == literal_kind::string, "trailing text accepted");
+    EXPECT(kind("") == literal_kind::integer, "empty literal should read as zero");
+
+    // Literals are views and need not be terminated
+    std::string_view unterminated("123456", 3);
+    EXPECT(classify_literal(unterminated).i == 123, "view bounds not respected");
+    EXPECT(parse_real(std::string_view("2.50000", 3)) == 2.5, "view bounds not respected");
+
+    return true;
+}
+
 //----------------------------------------------------------------------------
 
 inline void run_materialiser_tests()
@@ -740,6 +764,7 @@ SUBCAT("Extras");
     RUN_TEST(category_ids_are_not_dense_indices);
     RUN_TEST(scope_stack_is_never_empty);
     RUN_TEST(no_key_owned_by_nonexistent_category);
+    RUN_TEST(literal_classification_follows_strtol_rules);
 }
 
 }
@@ -365,6 +365,398 @@ static bool parser_key_terminates_table()
     return true;
 }
 
+//----------------------------------------------------------------------
+// Source buffer views
+//----------------------------------------------------------------------
+
+static bool parser_views_point_into_owned_source()
+{
+    std::string src = 
+        "Key:Int = 42\n"
+        "// line 1\n"
+        "// line 2\n"
+        "# a  b\n"
+        "  1  two words\n";
+    
+    auto ctx = parse(src);
+    auto const & cst = ctx.document;
+    
+    EXPECT(cst.source != nullptr, "CST should hold its source buffer");
+    EXPECT(cst.source->text.data() != src.data(), "Source should be copied by default");
+
+    for (auto const & ev : cst.events)
+        EXPECT(cst.source->contains(ev.text), "Event text should view the source buffer");
+
+    auto const & key = first_key(ctx);
+    EXPECT(key.name == "key", "Key name should be lower-cased");
+    EXPECT(*key.declared_type == "Int", "Declared type should be verbatim");
+    EXPECT(key.literal == "42", "Literal should be verbatim");
+    EXPECT(cst.source->contains(key.literal), "Literal should view the source buffer");
+
+    EXPECT(cst.events[1].text == "// line 1\n// line 2", "Contiguous blob incorrect");
+    EXPECT(cst.source->synthesized.size() == 1, "Only the lower-cased key name should be synthesised");
+
+    auto cells = cst.row_cells(cst.rows.at(0));
+    EXPECT(cells.size() == 2, "Row should have two cells");
+    EXPECT(cells[0] == "1" && cells[1] == "two words", "Row cells incorrect");
+
+    return true;
+}
+
+static bool parser_borrows_source_on_request()
+{
+    std::string src = "a = 1\n";
+    
+    auto ctx = parse(std::string_view(src), { .borrow_source = true });
+    
+    EXPECT(ctx.document.source->text.data() == src.data(), "Borrowed source should not be copied");
+    EXPECT(ctx.document.events[0].text.data() == src.data(), "Event should view the caller's input");
+    
+    return true;
+}
+
+static bool parser_synthesises_crlf_blobs()
+{
+    constexpr std::string_view src = 
+        "// line 1\r\n"
+        "// line 2\r\n";
+    
+    auto ctx = parse(src);
+    
+    EXPECT(ctx.document.events.size() == 1, "Expected single blobbed comment");
+    EXPECT(ctx.document.events[0].text == "// line 1\n// line 2", "CRLF blob should be joined with LF");
+    
+    return true;
+}
+
+//----------------------------------------------------------------------
+// Structural scanner
+//----------------------------------------------------------------------
+
+static std::vector<detail::line_info> scan_all(std::string_view src)
+{
+    std::vector<detail::line_info> all, batch;
+    detail::structural_scanner scanner(src);
+    while (scanner.next_batch(batch, 2))
+        all.insert(all.end(), batch.begin(), batch.end());
+    return all;
+}
+
+static bool scanner_indexes_line_structure()
+{
+    constexpr std::string_view src = 
+        "  key:int = 1|2  \r\n"
+        "\n"
+        "\t# a  b\n"
+        "last // line";  // No trailing newline
+    
+    auto lines = scan_all(src);
+    
+    EXPECT(lines.size() == 4, "Expected four lines");
+
+    auto const & k = lines[0];
+    EXPECT(k.begin == 0 && k.length == 17, "CR should be excluded from the line");
+    EXPECT(k.first == 2 && k.last == 15, "Trimmed extent incorrect");
+    EXPECT(k.colon == 5 && k.equals == 10, "Token positions incorrect");
+    EXPECT(k.hash == npos() && k.slashes == npos(), "Absent tokens should be npos");
+
+    EXPECT(lines[1].blank(), "Empty line should be blank");
+    EXPECT(lines[2].first == 1 && lines[2].hash == 1, "Tab should count as blank");
+    EXPECT(lines[3].slashes == 5 && lines[3].length == 12, "Final line incorrect");
+
+    return true;
+}
+
+static bool scanner_finds_comment_across_blocks()
+{
+    // Place "//" across the 64 byte block boundary
+    std::string src(63, ' ');
+    src += "// comment\nx = 1\n";
+    
+    auto lines = scan_all(src);
+    
+    EXPECT(lines.size() == 2, "Expected two lines");
+    EXPECT(lines[0].slashes == 63 && lines[0].first == 63, "Straddling // not found");
+    EXPECT(lines[1].begin == 74 && lines[1].equals == 2, "Second line incorrect");
+
+    auto ctx = parse(src);
+    EXPECT(ctx.document.events[0].kind == parse_event_kind::comment, "Expected comment event");
+
+    return true;
+}
+
+static bool parser_splits_cells_on_double_spaces()
+{
+    constexpr std::string_view src = 
+        "# name  description  code\n"
+        "  first item     a rather long description text   \tX1\n"
+        "  second              single spaced words here  Y2  \n";
+    
+    auto ctx = parse(src);
+    auto const & cst = ctx.document;
+    
+    EXPECT(cst.rows.size() == 2, "Expected two rows");
+
+    auto r0 = cst.row_cells(cst.rows[0]);
+    EXPECT(r0[0] == "first item", "Single spaces should stay within a cell");
+    EXPECT(r0[1] == "a rather long description text", "Long cell incorrect");
+    EXPECT(r0[2] == "X1", "Cells should be trimmed of tabs");
+
+    auto r1 = cst.row_cells(cst.rows[1]);
+    EXPECT(r1[0] == "second" && r1[1] == "single spaced words here" && r1[2] == "Y2", "Wide separators incorrect");
+
+    return true;
+}
+
+//----------------------------------------------------------------------
+// Streaming parser
+//----------------------------------------------------------------------
+
+static parse_context parse_in_chunks(std::string_view src, size_t chunk_size)
+{
+    stream_parser sp;
+    for (size_t pos = 0; pos < src.size(); pos += chunk_size)
+        sp.feed(src.substr(pos, chunk_size));
+    return sp.finish();
+}
+
+static bool stream_parser_matches_whole_parse()
+{
+    constexpr std::string_view src = 
+        "// header\n"
+        "// comment\n"
+        "top = 1\n"
+        "cat:\n"
+        "    name:str = some text\n"
+        "    # id:int  label\n"
+        "      1  first\n"
+        "      2  second\r\n"
+        "    free text\n"
+        "    more text\n"
+        "    :sub\n"
+        "        deep = yes\n"
+        "    /\n"
+        "/cat\n"
+        "// trailing, without newline";
+    
+    auto whole = parse(src);
+    auto const & expected = whole.document;
+
+    for (size_t chunk_size : { 1, 2, 7, 16, 64, 4096 })
+    {
+        auto streamed = parse_in_chunks(src, chunk_size);
+        auto const & cst = streamed.document;
+
+        EXPECT(cst.events.size() == expected.events.size(), "Event count differs from parse()");
+        for (size_t i = 0; i < cst.events.size(); ++i)
+        {
+            EXPECT(cst.events[i].kind == expected.events[i].kind, "Event kind differs");
+            EXPECT(cst.events[i].text == expected.events[i].text, "Event text differs");
+            EXPECT(cst.events[i].loc.line == expected.events[i].loc.line, "Event line differs");
+        }
+
+        EXPECT(cst.categories.size() == expected.categories.size(), "Category count differs");
+        EXPECT(cst.keys.size() == expected.keys.size(), "Key count differs");
+        for (size_t i = 0; i < cst.keys.size(); ++i)
+        {
+            EXPECT(cst.keys[i].name == expected.keys[i].name, "Key name differs");
+            EXPECT(cst.keys[i].literal == expected.keys[i].literal, "Key literal differs");
+            EXPECT(cst.keys[i].owner == expected.keys[i].owner, "Key owner differs");
+        }
+
+        EXPECT(cst.cells == expected.cells, "Row cells differ");
+        EXPECT(cst.rows.size() == expected.rows.size(), "Row count differs");
+    }
+
+    return true;
+}
+
+static bool stream_parser_accepts_empty_input()
+{
+    stream_parser sp;
+    sp.feed(std::string_view{});
+    auto ctx = sp.finish();
+    
+    EXPECT(ctx.document.events.empty(), "Empty stream should produce no events");
+    EXPECT(ctx.document.categories.size() == 1, "Root category should exist");
+    
+    return true;
+}
+
+//----------------------------------------------------------------------
+// Event handler
+//----------------------------------------------------------------------
+
+struct recording_handler : parse_handler
+{
+    std::vector<std::string> log;
+
+    void on_comment(std::string_view text) override { log.push_back("comment " + std::string(text)); }
+    void on_paragraph(std::string_view text) override { log.push_back("paragraph " + std::string(text)); }
+    void on_category_open(std::string_view name) override { log.push_back("open " + std::string(name)); }
+    void on_category_close(std::string_view name) override { log.push_back("close " + std::string(name)); }
+
+    void on_key(std::string_view name, std::optional<std::string_view> type, std::string_view literal) override
+    {
+        log.push_back("key " + std::string(name) + ":" + std::string(type.value_or("-")) + "=" + std::string(literal));
+    }
+
+    void on_table_header(std::span<const column_header> columns) override
+    {
+        std::string entry = "header";
+        for (auto const & c : columns)
+            entry += " " + std::string(c.name) + ":" + std::string(c.declared_type.value_or("-"));
+        log.push_back(entry);
+    }
+
+    void on_row(std::span<const std::string_view> cells) override
+    {
+        std::string entry = "row";
+        for (auto c : cells)
+            entry += " [" + std::string(c) + "]";
+        log.push_back(entry);
+    }
+};
+
+static bool handler_receives_grammar_in_order()
+{
+    constexpr std::string_view src = 
+        "// one\n"
+        "// two\n"
+        "Top:Int = 1\n"
+        "Cat:\n"
+        "    # ID:int  Label\n"
+        "      1  first\n"
+        "      2\n"
+        "      3  third  surplus\n"
+        "    :Sub\n"
+        "        k = v\n"
+        "\n"
+        "/cat\n";
+    
+    recording_handler h;
+    auto errors = parse(src, h);
+    
+    std::vector<std::string> expected = {
+        "comment // one\n// two",
+        "key top:Int=1",
+        "open cat",
+        "header id:int label:-",
+        "row [1] [first]",
+        "row [2] []",
+        "row [3] [third]",
+        "open sub",
+        "key k:-=v",
+        "paragraph ",
+        "close cat",
+    };
+
+    EXPECT(errors.empty(), "No errors expected");
+    EXPECT(h.log == expected, "Handler events incorrect");
+
+    return true;
+}
+
+static bool handler_matches_cst_structure()
+{
+    // The same input through both paths must report the same structure
+    std::string src;
+    for (int i = 0; i < 100; ++i)
+        src += "key" + std::to_string(i) + " = " + std::to_string(i) + "\n";
+
+    src += "// stray close\n/\n/named\n";
+
+    struct counter : parse_handler
+    {
+        size_t keys = 0, comments = 0, closes = 0;
+        void on_key(std::string_view, std::optional<std::string_view>, std::string_view) override { ++keys; }
+        void on_comment(std::string_view) override { ++comments; }
+        void on_category_close(std::string_view) override { ++closes; }
+    } h;
+
+    parse(src, h);
+    auto ctx = parse(src);
+
+    auto count = [&](parse_event_kind k) { return (size_t)std::ranges::count(ctx.document.events, k, &parse_event::kind); };
+
+    EXPECT(h.keys == ctx.document.keys.size(), "Key count differs from CST");
+    EXPECT(h.comments == count(parse_event_kind::comment), "Comment count differs from CST");
+    EXPECT(h.closes == count(parse_event_kind::category_close), "Close count differs from CST");
+
+    return true;
+}
+
+//----------------------------------------------------------------------
+// Parallel parser
+//----------------------------------------------------------------------
+
+static bool parallel_parse_matches_serial_parse()
+{
+    std::string src = "// preamble\nloose = 1\n";
+    for (int i = 0; i < 20; ++i)
+    {
+        auto n = std::to_string(i);
+        src += "Cat" + n + ":\r\n";
+        src += "    Name = item " + n + "\n";
+        src += "    # ID:int  Label\n";
+        src += "      " + n + "  row " + n + "\n";
+        src += "      " + n + "\n";
+        src += "    // crlf\r\n    // blob\r\n";
+        src += "    :sub" + n + "\n        deep = " + n + "\n    /\n";
+        src += "/stray\n";
+        src += "\n";
+    }
+
+    auto serial   = parse(src);
+    auto parallel = parallel_parse(src, {}, { .threads = 4, .min_chunk_bytes = 64 });
+
+    auto const & a = serial.document;
+    auto const & b = parallel.document;
+
+    EXPECT(a.events.size() == b.events.size(), "Event count differs");
+    for (size_t i = 0; i < a.events.size(); ++i)
+    {
+        EXPECT(a.events[i].kind == b.events[i].kind, "Event kind differs");
+        EXPECT(a.events[i].text == b.events[i].text, "Event text differs");
+        EXPECT(a.events[i].loc.line == b.events[i].loc.line, "Event line differs");
+        EXPECT(a.events[i].target == b.events[i].target, "Event target differs");
+    }
+
+    EXPECT(a.categories.size() == b.categories.size(), "Category count differs");
+    for (size_t i = 0; i < a.categories.size(); ++i)
+    {
+        EXPECT(a.categories[i].id == b.categories[i].id, "Category ID differs");
+        EXPECT(a.categories[i].name == b.categories[i].name, "Category name differs");
+        EXPECT(a.categories[i].parent == b.categories[i].parent, "Category parent differs");
+    }
+
+    EXPECT(a.tables.size() == b.tables.size(), "Table count differs");
+    for (size_t i = 0; i < a.tables.size(); ++i)
+    {
+        EXPECT(a.tables[i].owning_category == b.tables[i].owning_category, "Table owner differs");
+        EXPECT(a.tables[i].rows == b.tables[i].rows, "Table rows differ");
+        EXPECT(a.tables[i].columns.back().id == b.tables[i].columns.back().id, "Column ID differs");
+    }
+
+    EXPECT(a.rows.size() == b.rows.size(), "Row count differs");
+    for (size_t i = 0; i < a.rows.size(); ++i)
+    {
+        EXPECT(a.rows[i].owning_category == b.rows[i].owning_category, "Row owner differs");
+        EXPECT(a.rows[i].first_cell == b.rows[i].first_cell, "Row cells differ");
+    }
+
+    EXPECT(a.keys.size() == b.keys.size(), "Key count differs");
+    for (size_t i = 0; i < a.keys.size(); ++i)
+    {
+        EXPECT(a.keys[i].owner == b.keys[i].owner, "Key owner differs");
+        EXPECT(a.keys[i].loc.line == b.keys[i].loc.line, "Key line differs");
+    }
+
+    EXPECT(a.cells == b.cells, "Cells differ");
+
+    return true;
+}
+
 // Todo:
 // * comments inside tables
 // * malformed rows still producing events
@@ -401,6 +793,27 @@ inline void run_parser_tests()
     
     SUBCAT("Integration");
     RUN_TEST(parser_handles_mixed_content);
+
+    SUBCAT("Source buffer views");
+    RUN_TEST(parser_views_point_into_owned_source);
+    RUN_TEST(parser_borrows_source_on_request);
+    RUN_TEST(parser_synthesises_crlf_blobs);
+
+    SUBCAT("Structural scanner");
+    RUN_TEST(scanner_indexes_line_structure);
+    RUN_TEST(scanner_finds_comment_across_blocks);
+    RUN_TEST(parser_splits_cells_on_double_spaces);
+
+    SUBCAT("Streaming parser");
+    RUN_TEST(stream_parser_matches_whole_parse);
+    RUN_TEST(stream_parser_accepts_empty_input);
+
+    SUBCAT("Event handler");
+    RUN_TEST(handler_receives_grammar_in_order);
+    RUN_TEST(handler_matches_cst_structure);
+
+    SUBCAT("Parallel parser");
+    RUN_TEST(parallel_parse_matches_serial_parse);
 }
 
 } // ns nuno::tests
@@ -454,6 +454,38 @@ namespace nuno::tests
         return true;
     }    
 
+    bool where_on_columnar_table_matches_rows()
+    {
+        constexpr std::string_view src = R"(
+            npc:
+                # name   hp:int   race
+                  npc1   12       dwarf
+                  npc2   x        elf
+                  npc3   10       gnome
+                  npc4   9.5      orc
+                  npc5   8        elf
+        )";
+
+        auto rows_ctx     = load(src);
+        auto columnar_ctx = load(src, materialiser_options{ .columnar_min_rows = 1 });
+        EXPECT(columnar_ctx.document.table(table_id{0})->layout() == table_layout::columnar, "Table should be stored column-wise");
+
+        predicate preds[] = { ge("hp", 10), lt("hp", 10.5), ne("hp", 10), eq("race", "elf"), gt("race", "elf") };
+        for (auto const & pred : preds)
+        {
+            auto qr = query(rows_ctx.document, "npc").table(0).where(pred).project("name");
+            auto qc = query(columnar_ctx.document, "npc").table(0).where(pred).project("name");
+
+            EXPECT(!qr.locations().empty(), "Predicate should match some rows");
+            EXPECT(qr.locations().size() == qc.locations().size(), "Columnar match count differs");
+            for (size_t i = 0; i < qr.locations().size(); ++i)
+                EXPECT(qr.locations()[i].value_ptr->value_to_string() == qc.locations()[i].value_ptr->value_to_string(),
+                       "Columnar match differs");
+        }
+
+        return true;
+    }
+
     bool projected_subset()
     {
         auto ctx = load(R"(
@@ -1045,6 +1077,7 @@ namespace nuno::tests
         RUN_TEST(row_filter_is_composable);
         SUBCAT("Row access by predicate");
         RUN_TEST(numeric_promotion);
+        RUN_TEST(where_on_columnar_table_matches_rows);
         SUBCAT("Row access by identifier");
         RUN_TEST(query_table_row_by_string_id);
         RUN_TEST(projected_subset);
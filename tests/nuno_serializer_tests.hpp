@@ -253,9 +253,7 @@ static bool edited_key_reconstructed()
     // Edit the key
     auto keys = ctx.document.keys();
     EXPECT(keys.size() == 1, "There should be exactly one key");
-    auto * node = const_cast<document::key_node *>(keys.front().node);
-    node->value.val = int64_t(42);
-    node->is_edited = true;
+    editor(ctx.document).set_key_value(keys.front().id(), int64_t(42));
     
     std::ostringstream out;
     serializer s(ctx.document);
@@ -274,12 +272,10 @@ static bool edited_key_type_shown()
     // Edit and change type
     auto keys = ctx.document.keys();
     EXPECT(keys.size() == 1, "There should be exactly one key");
-    auto * key = const_cast<document::key_node *>(keys.front().node);
+    auto ed = editor(ctx.document);
 
-    key->value.type = value_type::integer;
-    key->value.type_source = type_ascription::declared;
-    key->value.val = int64_t(42);
-    key->is_edited = true;
+    ed.set_key_value(keys.front().id(), int64_t(42));
+    ed.set_key_type(keys.front().id(), value_type::integer, type_ascription::declared);
     
     std::ostringstream out;
     serializer s(ctx.document);
@@ -300,11 +296,8 @@ static bool edited_row_reconstructed()
     // Columns are UNTYPED, so editing should emit actual variant
     auto rows = ctx.document.rows();
     EXPECT(rows.size() == 1, "There should be exactly one key");
-    auto * row = const_cast<document::row_node *>(rows.front().node);
- 
-    // auto& row = ctx.document.access_row_nodes()[0];
-    row->cells[0].val = int64_t(99);  // Direct assignment OK
-    row->is_edited = true;
+    auto col = ctx.document.tables().front().columns()[0];
+    editor(ctx.document).set_cell_value(rows.front().id(), col, int64_t(99));
     
     std::ostringstream out;
     serializer s(ctx.document);
@@ -329,10 +322,8 @@ static bool edited_typed_row_respects_declaration()
     // Edit with WRONG type - but column is declared
     auto rows = ctx.document.rows();
     EXPECT(rows.size() == 1, "There should be exactly one key");
-    auto * row = const_cast<document::row_node *>(rows.front().node);
-
-    row->cells[1].val = std::string("99");  // String in int column!
-    row->is_edited = true;
+    auto col = ctx.document.tables().front().columns()[1];
+    editor(ctx.document).set_cell_value(rows.front().id(), col, std::string("99"));  // String in int column!
     
     std::ostringstream out;
     serializer s(ctx.document);
@@ -359,10 +350,7 @@ static bool mixed_edited_and_authored()
     // Edit only the middle key
     auto keys = ctx.document.keys();
     EXPECT(keys.size() == 3, "There should be exactly three keys");
-    auto * key_b = const_cast<document::key_node *>(keys[1].node);
-
-    key_b->value.val = int64_t(99);
-    key_b->is_edited = true;
+    editor(ctx.document).set_key_value(keys[1].id(), int64_t(99));
     
     std::ostringstream out;
     serializer s(ctx.document);
@@ -498,8 +486,99 @@ static bool option_compact_blank_lines()
     return true;
 }
 
+static bool option_verbatim_regions()
+{
+    constexpr std::string_view src =
+        "a = 1\n"
+        "cat:\n"
+        "    // Comment\n"
+        "    # x  y:int\n"
+        "      p  1\n"
+        "\n"
+        "    :sub\n"
+        "        b:str = q\n"
+        "    /sub\n"
+        "/cat\n";
+
+    auto ctx = load(src);
+    EXPECT(ctx.document.is_verbatim_source(), "unedited document should serialize as its source");
+
+    // On by default
+    std::ostringstream out;
+    serializer s(ctx.document);
+    s.write(out);
+
+    EXPECT(out.str() == src, "unedited document not copied whole");
+
+    // Opting out replays the same lines
+    serializer_options replay;
+    replay.verbatim_regions = false;
+
+    std::ostringstream replayed;
+    serializer(ctx.document, replay).write(replayed);
+    EXPECT(replayed.str() == src, "replayed document differs from its source");
+
+    // Line endings that serialization rewrites are not copied
+    auto crlf = load("a = 1\r\nb = 2\r\n");
+    EXPECT(!crlf.document.is_verbatim_source(), "CRLF source should not serialize verbatim");
+
+    std::ostringstream crlf_out, crlf_replayed;
+    serializer(crlf.document).write(crlf_out);
+    serializer(crlf.document, replay).write(crlf_replayed);
+    EXPECT(crlf_out.str() == crlf_replayed.str(), "CRLF source should be written line by line");
+    return true;
+}
+
 //============================================================================
-// CATEGORY 5: Edge Cases
+// CATEGORY 5: Output
+//============================================================================
+
+static bool serialize_to_string_matches_stream()
+{
+    auto ctx = load(
+        "server:\n"
+        "    port:int = 8080\n"
+        "    # name  weight:float\n"
+        "      a     0.5\n"
+        "/server\n");
+
+    auto ed = editor(ctx.document);
+    auto tbl = ctx.document.tables().front();
+    for (int64_t i = 0; i < 5000; ++i)
+        ed.append_row(tbl.id(), { std::string("r") + std::to_string(i), double(i) / 8 });
+
+    std::ostringstream out;
+    serializer(ctx.document).write(out);
+
+    EXPECT(serialize_to_string(ctx.document) == out.str(), "string and stream output differ");
+    return true;
+}
+
+static bool doubles_round_trip()
+{
+    const double values[] = { 0.1 + 0.2, 1e300, -2.5e-8, 123456789.125, 3.5 };
+
+    auto doc = create_document();
+    auto ed = editor(doc);
+    auto cat = ed.append_category(category_id{0}, "d");
+    for (size_t i = 0; i < std::size(values); ++i)
+        ed.append_key(cat, "k" + std::to_string(i), values[i]);
+
+    auto text = serialize_to_string(doc);
+    EXPECT(text.find("    k4:float = 3.5\n") != std::string::npos, "double not written in shortest form");
+
+    auto ctx = load(text);
+    EXPECT(!ctx.has_errors(), "serialized doubles should load");
+    for (size_t i = 0; i < std::size(values); ++i)
+    {
+        auto key = ctx.document.category("d")->key("k" + std::to_string(i));
+        EXPECT(key && std::get<double>(key->value().val) == values[i], "double did not round trip");
+    }
+    return true;
+}
+
+//============================================================================
+// CATEGORY 6: Edge Cases
 //============================================================================
 
 static bool empty_document()
@@ -598,6 +677,43 @@ static bool indent_fallback_when_no_siblings()
     return true;
 }
 
+static bool indent_inferred_for_many_generated_siblings()
+{
+    constexpr std::string_view src = 
+        "test:\n"
+        "      authored_key = 1\n"
+        "   # a\n"
+        "     1\n";
+    
+    auto ctx = load(src);
+    auto cat = ctx.document.category("test");
+    EXPECT(cat.has_value(), "test category must exist");
+
+    // Siblings are inferred once for the category and its tables; every
+    // generated key, table and row agrees with its authored sibling
+    auto ed = editor(ctx.document);
+    for (int64_t i = 0; i < 3; ++i)
+        ed.append_key(cat->id(), "k" + std::to_string(i), i, true);
+
+    auto tid = ed.append_table(cat->id(), std::vector<std::string>{ "b" });
+    for (int64_t i = 0; i < 2; ++i)
+        ed.append_row(tid, { i });
+
+    std::string expected = 
+        "test:\n"
+        "      authored_key = 1\n"
+        "   # a\n"
+        "     1\n"
+        "      k0 = 0\n"
+        "      k1 = 1\n"
+        "      k2 = 2\n";
+
+    std::string text = serialize_to_string(ctx.document);
+    EXPECT(text.starts_with(expected), "generated keys should share the indent of their authored sibling");
+    EXPECT(text.ends_with("   # b\n     0\n     1\n"), "generated table and rows should share the indent of the authored table");
+    return true;
+}
+
 //============================================================================
 // Test Runner
 //============================================================================
@@ -635,11 +751,17 @@ inline void run_seriealizer_tests()
     RUN_TEST(option_force_tacit_types);
     RUN_TEST(option_skip_comments);
     RUN_TEST(option_compact_blank_lines);
+    RUN_TEST(option_verbatim_regions);
 
     SUBCAT("Indentation inference");
     RUN_TEST(indent_inferred_from_sibling_key);
     RUN_TEST(indent_fallback_when_no_siblings);  
+    RUN_TEST(indent_inferred_for_many_generated_siblings);
     
+    SUBCAT("Output");
+    RUN_TEST(serialize_to_string_matches_stream);
+    RUN_TEST(doubles_round_trip);
+
     SUBCAT("Edge Cases");
     RUN_TEST(empty_document);
     RUN_TEST(document_without_source);